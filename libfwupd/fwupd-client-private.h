@@ -19,6 +19,18 @@ fwupd_client_download_bytes2_async(FwupdClient *self,
 				   GCancellable *cancellable,
 				   GAsyncReadyCallback callback,
 				   gpointer callback_data);
+void
+fwupd_client_download_firmware_async(FwupdClient *self,
+				     GPtrArray *urls,
+				     const gchar *checksum,
+				     FwupdClientDownloadFlags flags,
+				     GCancellable *cancellable,
+				     GAsyncReadyCallback callback,
+				     gpointer callback_data);
+GBytes *
+fwupd_client_download_firmware_finish(FwupdClient *self, GAsyncResult *res, GError **error);
+void
+fwupd_client_set_firmware_cache_size_max(FwupdClient *self, guint64 firmware_cache_size_max);
 
 #ifdef HAVE_GIO_UNIX
 void
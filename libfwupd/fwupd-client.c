@@ -7,6 +7,7 @@
 #include "config.h"
 
 #include <gio/gio.h>
+#include <glib/gstdio.h>
 #include <gmodule.h>
 #ifdef HAVE_LIBCURL
 #include <curl/curl.h>
@@ -15,6 +16,7 @@
 #include <gio/gunixfdlist.h>
 #endif
 
+#include <errno.h>
 #include <fcntl.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -35,10 +37,27 @@
 
 static void
 fwupd_client_fixup_dbus_error(GError *error);
+static void
+fwupd_client_download_conditional_async(FwupdClient *self,
+					const gchar *url,
+					const gchar *etag,
+					const gchar *last_modified,
+					GCancellable *cancellable,
+					GAsyncReadyCallback callback,
+					gpointer callback_data);
+static GBytes *
+fwupd_client_download_conditional_finish(FwupdClient *self,
+					 GAsyncResult *res,
+					 gchar **etag,
+					 gchar **last_modified,
+					 gboolean *not_modified,
+					 GError **error);
 
 typedef GObject *(*FwupdClientObjectNewFunc)(void);
 
 #define FWUPD_CLIENT_DBUS_PROXY_TIMEOUT 180000 /* ms */
+#define FWUPD_CLIENT_DOWNLOAD_RETRIES	5
+#define FWUPD_CLIENT_FIRMWARE_CACHE_SIZE_MAX (512 * 1024 * 1024) /* bytes */
 
 /**
  * FwupdClient:
@@ -76,6 +95,9 @@ typedef struct {
 	gchar *package_version;
 	gchar *user_agent;
 	GHashTable *hints; /* str:str */
+	guint firmware_cache_hits;
+	guint64 firmware_cache_bytes_saved;
+	guint64 firmware_cache_size_max;
 #ifdef SOUP_SESSION_COMPAT
 	GObject *soup_session;
 	GModule *soup_module; /* we leak this */
@@ -85,6 +107,15 @@ typedef struct {
 #ifdef HAVE_LIBCURL
 typedef struct {
 	GPtrArray *urls;
+	FwupdClientDownloadFlags download_flags;
+	gchar *etag;	      /* sent as If-None-Match, then replaced by the response */
+	gchar *last_modified; /* sent as If-Modified-Since, then replaced by the response */
+	gboolean not_modified;
+	gchar *checksum;	/* expected checksum of the firmware */
+	gchar *checksum_actual; /* computed while the firmware was streamed */
+	gchar *filename_part;	/* completed partial file, not yet removed */
+	guint64 firmware_cache_size_max;
+	gboolean firmware_cache_hit;
 	CURL *curl;
 	curl_mime *mime;
 	struct curl_slist *headers;
@@ -141,6 +172,11 @@ fwupd_client_curl_helper_free(FwupdCurlHelper *helper)
 		curl_slist_free_all(helper->headers);
 	if (helper->urls != NULL)
 		g_ptr_array_unref(helper->urls);
+	g_free(helper->etag);
+	g_free(helper->last_modified);
+	g_free(helper->checksum);
+	g_free(helper->checksum_actual);
+	g_free(helper->filename_part);
 	g_free(helper);
 }
 
@@ -737,6 +773,12 @@ fwupd_client_curl_new(FwupdClient *self, GError **error)
 }
 #endif
 
+static gchar *
+fwupd_client_build_cache_dir(const gchar *subdir)
+{
+	return g_build_filename(g_get_user_cache_dir(), "fwupd", subdir, NULL);
+}
+
 static void
 fwupd_client_set_hints_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
@@ -3127,48 +3169,58 @@ fwupd_client_install_release_bytes_cb(GObject *source, GAsyncResult *res, gpoint
 	g_task_return_boolean(task, TRUE);
 }
 
+/* takes ownership of @task */
 static void
-fwupd_client_install_release_download_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+fwupd_client_install_release_blob(GTask *task, GBytes *blob)
 {
-	g_autoptr(GBytes) blob = NULL;
-	g_autoptr(GError) error = NULL;
-	g_autoptr(GTask) task = G_TASK(user_data);
+	FwupdClient *self = g_task_get_source_object(task);
 	FwupdClientInstallReleaseData *data = g_task_get_task_data(task);
-	GChecksumType checksum_type;
 	GCancellable *cancellable = g_task_get_cancellable(task);
-	const gchar *checksum_expected;
-	g_autofree gchar *checksum_actual = NULL;
-
-	blob = fwupd_client_download_bytes_finish(FWUPD_CLIENT(source), res, &error);
-	if (blob == NULL) {
-		g_task_return_error(task, g_steal_pointer(&error));
-		return;
-	}
-
-	/* verify checksum */
-	checksum_expected = fwupd_checksum_get_best(fwupd_release_get_checksums(data->release));
-	checksum_type = fwupd_checksum_guess_kind(checksum_expected);
-	checksum_actual = g_compute_checksum_for_bytes(checksum_type, blob);
-	if (g_strcmp0(checksum_expected, checksum_actual) != 0) {
-		g_task_return_new_error(task,
-					FWUPD_ERROR,
-					FWUPD_ERROR_INVALID_FILE,
-					"checksum invalid, expected %s got %s",
-					checksum_expected,
-					checksum_actual);
-		return;
-	}
 
 	/* if the device specifies ONLY_OFFLINE automatically set this flag */
 	if (fwupd_device_has_flag(data->device, FWUPD_DEVICE_FLAG_ONLY_OFFLINE))
 		data->install_flags |= FWUPD_INSTALL_FLAG_OFFLINE;
-	fwupd_client_install_bytes_async(FWUPD_CLIENT(source),
+	fwupd_client_install_bytes_async(self,
 					 fwupd_device_get_id(data->device),
 					 blob,
 					 data->install_flags,
 					 cancellable,
 					 fwupd_client_install_release_bytes_cb,
-					 g_steal_pointer(&task));
+					 task);
+}
+
+static void
+fwupd_client_install_release_download_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTask) task = G_TASK(user_data);
+
+	/* the checksum has already been verified */
+	blob = fwupd_client_download_firmware_finish(FWUPD_CLIENT(source), res, &error);
+	if (blob == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	fwupd_client_install_release_blob(g_steal_pointer(&task), blob);
+}
+
+/* takes ownership of @task */
+static void
+fwupd_client_install_release_download(GTask *task, GPtrArray *urls)
+{
+	FwupdClient *self = g_task_get_source_object(task);
+	FwupdClientInstallReleaseData *data = g_task_get_task_data(task);
+	GCancellable *cancellable = g_task_get_cancellable(task);
+
+	fwupd_client_download_firmware_async(
+	    self,
+	    urls,
+	    fwupd_checksum_get_best(fwupd_release_get_checksums(data->release)),
+	    data->download_flags,
+	    cancellable,
+	    fwupd_client_install_release_download_cb,
+	    task);
 }
 
 static gboolean
@@ -3261,12 +3313,7 @@ fwupd_client_install_release_remote_cb(GObject *source, GAsyncResult *res, gpoin
 	}
 
 	/* download file */
-	fwupd_client_download_bytes2_async(FWUPD_CLIENT(source),
-					   uris_built,
-					   data->download_flags,
-					   cancellable,
-					   fwupd_client_install_release_download_cb,
-					   g_steal_pointer(&task));
+	fwupd_client_install_release_download(g_steal_pointer(&task), uris_built);
 }
 
 #ifdef HAVE_LIBCURL
@@ -3343,19 +3390,15 @@ fwupd_client_install_release2_async(FwupdClient *self,
 	data = g_new0(FwupdClientInstallReleaseData, 1);
 	data->device = g_object_ref(device);
 	data->release = g_object_ref(release);
-	data->download_flags = download_flags;
+	data->download_flags = download_flags | FWUPD_CLIENT_DOWNLOAD_FLAG_STREAM;
 	data->install_flags = install_flags;
 	g_task_set_task_data(task, data, (GDestroyNotify)fwupd_client_install_release_data_free);
 
 	/* work out what remote-specific URI fields this should use */
 	remote_id = fwupd_release_get_remote_id(release);
 	if (remote_id == NULL) {
-		fwupd_client_download_bytes2_async(self,
-						   fwupd_release_get_locations(release),
-						   download_flags,
-						   cancellable,
-						   fwupd_client_install_release_download_cb,
-						   g_steal_pointer(&task));
+		fwupd_client_install_release_download(g_steal_pointer(&task),
+						      fwupd_release_get_locations(release));
 		return;
 	}
 
@@ -3962,6 +4005,8 @@ typedef struct {
 	FwupdRemote *remote;
 	GBytes *signature;
 	GBytes *metadata;
+	gchar *etag;
+	gchar *last_modified;
 } FwupdClientRefreshRemoteData;
 
 static void
@@ -3971,15 +4016,104 @@ fwupd_client_refresh_remote_data_free(FwupdClientRefreshRemoteData *data)
 		g_bytes_unref(data->signature);
 	if (data->metadata != NULL)
 		g_bytes_unref(data->metadata);
+	g_free(data->etag);
+	g_free(data->last_modified);
 	g_object_unref(data->remote);
 	g_free(data);
 }
 
+static gchar *
+fwupd_client_refresh_remote_build_validators_filename(FwupdRemote *remote)
+{
+	const gchar *root = g_getenv("CACHE_DIRECTORY");
+	g_autofree gchar *basename = g_strdup_printf("%s.conf", fwupd_remote_get_id(remote));
+
+	/* if run from a systemd unit, use the cache directory set there */
+	if (root == NULL)
+		root = g_get_user_cache_dir();
+	return g_build_filename(root, "fwupd", "validators", basename, NULL);
+}
+
+/* the metadata the daemon has now matches the signature on the server */
+static void
+fwupd_client_refresh_remote_done(FwupdClientRefreshRemoteData *data)
+{
+	g_autofree gchar *fn = fwupd_client_refresh_remote_build_validators_filename(data->remote);
+	g_autoptr(GError) error_local = NULL;
+
+	if (data->signature != NULL) {
+		g_autofree gchar *checksum =
+		    g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, data->signature);
+		fwupd_remote_set_checksum(data->remote, checksum);
+		fwupd_remote_set_etag(data->remote, data->etag);
+		fwupd_remote_set_last_modified(data->remote, data->last_modified);
+	}
+	fwupd_remote_set_mtime(data->remote, (guint64)g_get_real_time() / G_USEC_PER_SEC);
+	if (!fwupd_remote_save_validators(data->remote, fn, &error_local))
+		g_info("failed to save HTTP validators: %s", error_local->message);
+}
+
+static void
+fwupd_client_refresh_remote_touch_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTask) task = G_TASK(user_data);
+	g_autoptr(GVariant) val = NULL;
+	FwupdClientRefreshRemoteData *data = g_task_get_task_data(task);
+
+	val = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), res, &error);
+	if (val == NULL) {
+		/* older daemons only update the age when sent new metadata, and the user
+		 * may not be allowed to modify the remote -- the metadata is still current */
+		if (!g_error_matches(error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD)) {
+			fwupd_client_fixup_dbus_error(error);
+			if (!g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_AUTH_FAILED)) {
+				g_task_return_error(task, g_steal_pointer(&error));
+				return;
+			}
+		}
+		g_info("daemon cannot touch metadata: %s", error->message);
+	}
+
+	/* success */
+	fwupd_client_refresh_remote_done(data);
+	g_task_return_boolean(task, TRUE);
+}
+
+/* takes ownership of @task, the metadata the daemon has is still current */
+static void
+fwupd_client_refresh_remote_unchanged(GTask *task)
+{
+	FwupdClient *self = g_task_get_source_object(task);
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	FwupdClientRefreshRemoteData *data = g_task_get_task_data(task);
+	const gchar *checksum = fwupd_remote_get_checksum(data->remote);
+
+	/* not using the daemon */
+	if (priv->proxy == NULL || checksum == NULL) {
+		fwupd_client_refresh_remote_done(data);
+		g_task_return_boolean(task, TRUE);
+		g_object_unref(task);
+		return;
+	}
+
+	/* so that the daemon also reports the metadata as refreshed */
+	g_dbus_proxy_call(priv->proxy,
+			  "TouchMetadata",
+			  g_variant_new("(ss)", fwupd_remote_get_id(data->remote), checksum),
+			  G_DBUS_CALL_FLAGS_NONE,
+			  FWUPD_CLIENT_DBUS_PROXY_TIMEOUT,
+			  g_task_get_cancellable(task),
+			  fwupd_client_refresh_remote_touch_cb,
+			  task);
+}
+
 static void
 fwupd_client_refresh_remote_update_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GTask) task = G_TASK(user_data);
+	FwupdClientRefreshRemoteData *data = g_task_get_task_data(task);
 
 	/* save metadata */
 	if (!fwupd_client_update_metadata_bytes_finish(FWUPD_CLIENT(source), res, &error)) {
@@ -3988,6 +4122,7 @@ fwupd_client_refresh_remote_update_cb(GObject *source, GAsyncResult *res, gpoint
 	}
 
 	/* success */
+	fwupd_client_refresh_remote_done(data);
 	g_task_return_boolean(task, TRUE);
 }
 
@@ -4029,14 +4164,28 @@ fwupd_client_refresh_remote_signature_cb(GObject *source, GAsyncResult *res, gpo
 	FwupdClient *self = g_task_get_source_object(task);
 	GCancellable *cancellable = g_task_get_cancellable(task);
 	GChecksumType checksum_kind;
+	gboolean not_modified = FALSE;
 	g_autofree gchar *checksum = NULL;
 
 	/* save signature */
-	bytes = fwupd_client_download_bytes_finish(FWUPD_CLIENT(source), res, &error);
+	bytes = fwupd_client_download_conditional_finish(FWUPD_CLIENT(source),
+							 res,
+							 &data->etag,
+							 &data->last_modified,
+							 &not_modified,
+							 &error);
 	if (bytes == NULL) {
 		g_task_return_error(task, g_steal_pointer(&error));
 		return;
 	}
+
+	/* nothing to download, verify or reload */
+	if (not_modified) {
+		g_info("metadata signature of %s is not modified, skipping",
+		       fwupd_remote_get_id(data->remote));
+		fwupd_client_refresh_remote_unchanged(g_steal_pointer(&task));
+		return;
+	}
 	data->signature = g_steal_pointer(&bytes);
 	if (fwupd_remote_get_keyring_kind(data->remote) == FWUPD_KEYRING_KIND_JCAT) {
 		if (!fwupd_remote_load_signature_bytes(data->remote, data->signature, &error)) {
@@ -4055,7 +4204,7 @@ fwupd_client_refresh_remote_signature_cb(GObject *source, GAsyncResult *res, gpo
 	if (g_strcmp0(checksum, fwupd_remote_get_checksum(data->remote)) == 0) {
 		g_info("metadata signature of %s is unchanged, skipping",
 		       fwupd_remote_get_id(data->remote));
-		g_task_return_boolean(task, TRUE);
+		fwupd_client_refresh_remote_unchanged(g_steal_pointer(&task));
 		return;
 	}
 
@@ -4092,6 +4241,8 @@ fwupd_client_refresh_remote_async(FwupdClient *self,
 				  gpointer callback_data)
 {
 	FwupdClientRefreshRemoteData *data;
+	g_autofree gchar *fn = NULL;
+	g_autoptr(GError) error_local = NULL;
 	g_autoptr(GTask) task = NULL;
 
 	g_return_if_fail(FWUPD_IS_CLIENT(self));
@@ -4116,13 +4267,19 @@ fwupd_client_refresh_remote_async(FwupdClient *self,
 		return;
 	}
 
-	/* download signature */
-	fwupd_client_download_bytes_async(self,
-					  fwupd_remote_get_metadata_uri_sig(remote),
-					  FWUPD_CLIENT_DOWNLOAD_FLAG_NONE,
-					  cancellable,
-					  fwupd_client_refresh_remote_signature_cb,
-					  g_steal_pointer(&task));
+	/* only valid if the daemon still has the metadata these were saved for */
+	fn = fwupd_client_refresh_remote_build_validators_filename(remote);
+	if (!fwupd_remote_load_validators(remote, fn, &error_local))
+		g_info("failed to load HTTP validators: %s", error_local->message);
+
+	/* download signature, unless it has not changed */
+	fwupd_client_download_conditional_async(self,
+						fwupd_remote_get_metadata_uri_sig(remote),
+						fwupd_remote_get_etag(remote),
+						fwupd_remote_get_last_modified(remote),
+						cancellable,
+						fwupd_client_refresh_remote_signature_cb,
+						g_steal_pointer(&task));
 }
 
 /**
@@ -5085,6 +5242,53 @@ fwupd_client_set_user_agent_for_package(FwupdClient *self,
 	fwupd_client_rebuild_user_agent(self);
 }
 
+/**
+ * fwupd_client_get_firmware_cache_hits:
+ * @self: a #FwupdClient
+ *
+ * Gets how many times firmware was installed from the client cache rather than being
+ * downloaded again.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.14
+ **/
+guint
+fwupd_client_get_firmware_cache_hits(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), 0);
+	return priv->firmware_cache_hits;
+}
+
+/**
+ * fwupd_client_get_firmware_cache_bytes_saved:
+ * @self: a #FwupdClient
+ *
+ * Gets how many bytes did not have to be downloaded because the firmware was already in the
+ * client cache.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.14
+ **/
+guint64
+fwupd_client_get_firmware_cache_bytes_saved(FwupdClient *self)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), 0);
+	return priv->firmware_cache_bytes_saved;
+}
+
+/* private */
+void
+fwupd_client_set_firmware_cache_size_max(FwupdClient *self, guint64 firmware_cache_size_max)
+{
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	priv->firmware_cache_size_max = firmware_cache_size_max;
+}
+
 #ifdef HAVE_LIBCURL
 static size_t
 fwupd_client_download_write_callback_cb(char *ptr, size_t size, size_t nmemb, void *userdata)
@@ -5139,9 +5343,71 @@ fwupd_client_download_ipfs(FwupdClient *self,
 	return g_steal_pointer(&bstdout);
 }
 
+static gboolean
+fwupd_client_download_check_status_code(glong status_code, GByteArray *buf, GError **error)
+{
+	if (status_code == 429) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "Failed to download due to server limit");
+		return FALSE;
+	}
+	if (status_code >= 400) {
+		g_autofree gchar *str = g_strndup((const gchar *)buf->data, MIN(buf->len, 4000));
+		if (g_str_is_ascii(str)) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "Failed to download, server response was %u: %s",
+				    (guint)status_code,
+				    str);
+			return FALSE;
+		}
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "Failed to download, server response was %u",
+			    (guint)status_code);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static size_t
+fwupd_client_download_header_callback_cb(char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+	FwupdCurlHelper *helper = (FwupdCurlHelper *)userdata;
+	gsize realsize = size * nmemb;
+	g_autofree gchar *line = g_strndup(ptr, realsize);
+	g_auto(GStrv) split = NULL;
+
+	/* a new response, e.g. after a redirect */
+	if (g_str_has_prefix(line, "HTTP/")) {
+		g_clear_pointer(&helper->etag, g_free);
+		g_clear_pointer(&helper->last_modified, g_free);
+		return realsize;
+	}
+	split = g_strsplit(line, ":", 2);
+	if (g_strv_length(split) != 2)
+		return realsize;
+	if (g_ascii_strcasecmp(split[0], "ETag") == 0) {
+		g_free(helper->etag);
+		helper->etag = g_strdup(g_strstrip(split[1]));
+	} else if (g_ascii_strcasecmp(split[0], "Last-Modified") == 0) {
+		g_free(helper->last_modified);
+		helper->last_modified = g_strdup(g_strstrip(split[1]));
+	}
+	return realsize;
+}
+
 static GBytes *
-fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GError **error)
+fwupd_client_download_http(FwupdClient *self,
+			   FwupdCurlHelper *helper,
+			   const gchar *url,
+			   GError **error)
 {
+	CURL *curl = helper->curl;
 	CURLcode res;
 	gchar errbuf[CURL_ERROR_SIZE] = {'\0'};
 	glong status_code = 0;
@@ -5177,72 +5443,597 @@ fwupd_client_download_http(FwupdClient *self, CURL *curl, const gchar *url, GErr
 	/* check for server limit */
 	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
 	g_info("status-code was %ld", status_code);
-	if (status_code == 429) {
-		g_set_error_literal(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_INVALID_FILE,
-				    "Failed to download due to server limit");
+	if (!fwupd_client_download_check_status_code(status_code, buf, error))
 		return NULL;
-	}
+	if (status_code == 304)
+		helper->not_modified = TRUE;
+
+	return g_byte_array_free_to_bytes(g_steal_pointer(&buf));
+}
+
+typedef struct {
+	CURL *curl;
+	GOutputStream *ostream;
+	GChecksum *checksum; /* (nullable) */
+	GByteArray *errbuf;  /* response body for HTTP errors */
+	goffset offset;	    /* bytes written to the partial file */
+	GError *error;
+} FwupdClientStreamHelper;
+
+static size_t
+fwupd_client_download_stream_write_callback_cb(char *ptr,
+					       size_t size,
+					       size_t nmemb,
+					       void *userdata)
+{
+	FwupdClientStreamHelper *helper = (FwupdClientStreamHelper *)userdata;
+	gsize realsize = size * nmemb;
+	glong status_code = 0;
+
+	/* never append an error page to the partial file */
+	curl_easy_getinfo(helper->curl, CURLINFO_RESPONSE_CODE, &status_code);
 	if (status_code >= 400) {
-		g_autofree gchar *str = g_strndup((const gchar *)buf->data, MIN(buf->len, 4000));
-		if (g_str_is_ascii(str)) {
+		g_byte_array_append(helper->errbuf, (const guint8 *)ptr, realsize);
+		return realsize;
+	}
+	if (!g_output_stream_write_all(helper->ostream,
+				       ptr,
+				       realsize,
+				       NULL,
+				       NULL,
+				       &helper->error))
+		return 0;
+	if (helper->checksum != NULL)
+		g_checksum_update(helper->checksum, (const guchar *)ptr, realsize);
+	helper->offset += realsize;
+	return realsize;
+}
+
+/* hash anything left over from an interrupted transfer */
+static gboolean
+fwupd_client_download_stream_load_partial(FwupdClientStreamHelper *helper,
+					  GFile *file,
+					  GError **error)
+{
+	guint8 buf[32 * 1024];
+	g_autoptr(GFileInputStream) istream = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* nothing to hash */
+	if (helper->checksum == NULL) {
+		g_autoptr(GFileInfo) info = NULL;
+		info = g_file_query_info(file,
+					 G_FILE_ATTRIBUTE_STANDARD_SIZE,
+					 G_FILE_QUERY_INFO_NONE,
+					 NULL,
+					 &error_local);
+		if (info == NULL) {
+			if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+				return TRUE;
+			g_propagate_error(error, g_steal_pointer(&error_local));
+			return FALSE;
+		}
+		helper->offset = g_file_info_get_size(info);
+		return TRUE;
+	}
+
+	istream = g_file_read(file, NULL, &error_local);
+	if (istream == NULL) {
+		if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+			return TRUE;
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		return FALSE;
+	}
+	while (TRUE) {
+		gssize sz =
+		    g_input_stream_read(G_INPUT_STREAM(istream), buf, sizeof(buf), NULL, error);
+		if (sz < 0)
+			return FALSE;
+		if (sz == 0)
+			break;
+		g_checksum_update(helper->checksum, buf, sz);
+		helper->offset += sz;
+	}
+	return TRUE;
+}
+
+static GBytes *
+fwupd_client_download_stream_map_file(const gchar *fn, GError **error)
+{
+	g_autoptr(GBytes) blob = NULL;
+#ifdef _WIN32
+	gchar *data = NULL;
+	gsize datasz = 0;
+
+	/* a mapped file cannot be renamed or deleted */
+	if (!g_file_get_contents(fn, &data, &datasz, error))
+		return NULL;
+	blob = g_bytes_new_take(data, datasz);
+#else
+	g_autoptr(GMappedFile) mapped_file = NULL;
+
+	/* the mapping stays valid after the file has been renamed or deleted */
+	mapped_file = g_mapped_file_new(fn, FALSE, error);
+	if (mapped_file == NULL)
+		return NULL;
+	blob = g_mapped_file_get_bytes(mapped_file);
+#endif
+	return g_steal_pointer(&blob);
+}
+
+/* returns %NULL if there is nowhere to write the partial file */
+static gchar *
+fwupd_client_download_stream_build_filename(const gchar *url)
+{
+	g_autofree gchar *basename = NULL;
+	g_autofree gchar *cachedir = fwupd_client_build_cache_dir("downloads");
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(GFileInfo) info = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	if (g_mkdir_with_parents(cachedir, 0700) == -1) {
+		g_info("failed to create %s: %s", cachedir, g_strerror(errno));
+		return NULL;
+	}
+	file = g_file_new_for_path(cachedir);
+	info = g_file_query_info(file,
+				 G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE,
+				 G_FILE_QUERY_INFO_NONE,
+				 NULL,
+				 &error_local);
+	if (info == NULL) {
+		g_info("failed to query %s: %s", cachedir, error_local->message);
+		return NULL;
+	}
+	if (!g_file_info_get_attribute_boolean(info, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE)) {
+		g_info("cannot write to %s", cachedir);
+		return NULL;
+	}
+
+	/* the partial file is keyed on the URL, and only resumed if the validator matches */
+	basename = g_compute_checksum_for_string(G_CHECKSUM_SHA256, url, -1);
+	return g_strdup_printf("%s/%s.part", cachedir, basename);
+}
+
+/* the ETag, or failing that the Last-Modified date, of the partial file */
+static gchar *
+fwupd_client_download_stream_load_validator(const gchar *fn_validator)
+{
+	g_autofree gchar *validator = NULL;
+	if (!g_file_get_contents(fn_validator, &validator, NULL, NULL))
+		return NULL;
+	g_strstrip(validator);
+	if (validator[0] == '\0')
+		return NULL;
+	return g_steal_pointer(&validator);
+}
+
+static GBytes *
+fwupd_client_download_http_stream(FwupdClient *self,
+				  FwupdCurlHelper *curl_helper,
+				  const gchar *url,
+				  const gchar *fn,
+				  GError **error)
+{
+	CURL *curl = curl_helper->curl;
+	g_autofree gchar *fn_validator = g_strdup_printf("%s.validator", fn);
+	g_autofree gchar *validator = NULL;
+	g_autoptr(GByteArray) errbuf = g_byte_array_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GChecksum) checksum = NULL;
+	g_autoptr(GFile) file = g_file_new_for_path(fn);
+	FwupdClientStreamHelper helper = {
+	    .curl = curl,
+	    .errbuf = errbuf,
+	};
+
+	/* hash as the data arrives so the firmware does not have to be read again */
+	if (curl_helper->checksum != NULL) {
+		checksum = g_checksum_new(fwupd_checksum_guess_kind(curl_helper->checksum));
+		helper.checksum = checksum;
+	}
+
+	/* a partial file with no validator might be from a different version of the file */
+	validator = fwupd_client_download_stream_load_validator(fn_validator);
+	if (validator != NULL) {
+		if (!fwupd_client_download_stream_load_partial(&helper, file, error))
+			return NULL;
+	}
+
+	(void)curl_easy_setopt(curl, CURLOPT_URL, url);
+	(void)curl_easy_setopt(curl,
+			       CURLOPT_WRITEFUNCTION,
+			       fwupd_client_download_stream_write_callback_cb);
+	(void)curl_easy_setopt(curl, CURLOPT_WRITEDATA, &helper);
+	(void)curl_easy_setopt(curl,
+			       CURLOPT_HEADERFUNCTION,
+			       fwupd_client_download_header_callback_cb);
+	(void)curl_easy_setopt(curl, CURLOPT_HEADERDATA, curl_helper);
+	for (guint i = 0;; i++) {
+		CURLcode res;
+		gchar errstr[CURL_ERROR_SIZE] = {'\0'};
+		glong status_code = 0;
+		goffset offset_start = helper.offset;
+		g_autoptr(GFileOutputStream) ostream = NULL;
+		struct curl_slist *headers = NULL;
+
+		/* the server only sends the range if the file is unchanged */
+		if (offset_start > 0) {
+			g_autofree gchar *hdr = g_strdup_printf("If-Range: %s", validator);
+			g_info("resuming %s from %" G_GOFFSET_FORMAT, url, offset_start);
+			headers = curl_slist_append(headers, hdr);
+		} else {
+			(void)g_unlink(fn);
+			(void)g_unlink(fn_validator);
+		}
+		ostream = g_file_append_to(file, G_FILE_CREATE_PRIVATE, NULL, error);
+		if (ostream == NULL)
+			return NULL;
+		helper.ostream = G_OUTPUT_STREAM(ostream);
+		g_byte_array_set_size(errbuf, 0);
+
+		fwupd_client_set_status(self, FWUPD_STATUS_DOWNLOADING);
+		(void)curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errstr);
+		(void)curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+		(void)curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)offset_start);
+		res = curl_easy_perform(curl);
+		(void)curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, NULL);
+		(void)curl_easy_setopt(curl, CURLOPT_HTTPHEADER, NULL);
+		(void)curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
+		curl_slist_free_all(headers);
+		fwupd_client_set_status(self, FWUPD_STATUS_IDLE);
+
+		/* keep what we have so the next attempt can resume */
+		if (!g_output_stream_close(helper.ostream, NULL, error))
+			return NULL;
+		helper.ostream = NULL;
+		if (helper.error != NULL) {
+			g_propagate_error(error, g_steal_pointer(&helper.error));
+			return NULL;
+		}
+
+		/* the file has changed, the server does not support ranges or the file is stale */
+		curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
+		g_info("status-code was %ld", status_code);
+		if (offset_start > 0 && (res == CURLE_RANGE_ERROR || status_code == 416)) {
+			g_info("cannot resume %s, restarting", url);
+			if (checksum != NULL)
+				g_checksum_reset(checksum);
+			helper.offset = 0;
+			continue;
+		}
+		if (!fwupd_client_download_check_status_code(status_code, errbuf, error))
+			return NULL;
+
+		/* remember which version of the file the partial data is from */
+		if (offset_start == 0) {
+			g_free(validator);
+			validator = g_strdup(curl_helper->etag != NULL ? curl_helper->etag
+								       : curl_helper->last_modified);
+			if (validator != NULL &&
+			    !g_file_set_contents(fn_validator, validator, -1, NULL))
+				g_clear_pointer(&validator, g_free);
+		}
+		if (res == CURLE_OK)
+			break;
+
+		/* only retry if the transfer made some progress */
+		if (helper.offset == offset_start || i >= FWUPD_CLIENT_DOWNLOAD_RETRIES) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
-				    "Failed to download, server response was %u: %s",
-				    (guint)status_code,
-				    str);
+				    "failed to download file: %s",
+				    errstr[0] != '\0' ? errstr : curl_easy_strerror(res));
 			return NULL;
 		}
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INVALID_FILE,
-			    "Failed to download, server response was %u",
-			    (guint)status_code);
+		g_info("download of %s interrupted after %" G_GOFFSET_FORMAT " bytes: %s",
+		       url,
+		       helper.offset,
+		       curl_easy_strerror(res));
+
+		/* the partial data cannot be checked against the next response */
+		if (validator == NULL) {
+			if (checksum != NULL)
+				g_checksum_reset(checksum);
+			helper.offset = 0;
+		}
+	}
+	fwupd_client_set_percentage(self, 100);
+	(void)g_unlink(fn_validator);
+	blob = fwupd_client_download_stream_map_file(fn, error);
+	if (blob == NULL)
 		return NULL;
+	if (checksum != NULL) {
+		g_free(curl_helper->checksum_actual);
+		curl_helper->checksum_actual = g_strdup(g_checksum_get_string(checksum));
 	}
 
-	return g_byte_array_free_to_bytes(g_steal_pointer(&buf));
+	/* firmware is moved into the cache once the checksum is verified */
+	if (curl_helper->checksum != NULL) {
+		g_free(curl_helper->filename_part);
+		curl_helper->filename_part = g_strdup(fn);
+	} else if (g_unlink(fn) != 0) {
+		g_debug("failed to delete %s: %s", fn, g_strerror(errno));
+	}
+	return g_steal_pointer(&blob);
 }
 
-static void
-fwupd_client_download_bytes_thread_cb(GTask *task,
-				      gpointer source_object,
-				      gpointer task_data,
-				      GCancellable *cancellable)
+/* tries each URL in turn */
+static GBytes *
+fwupd_client_download_bytes_urls(FwupdClient *self,
+				 FwupdCurlHelper *helper,
+				 GCancellable *cancellable,
+				 GError **error)
 {
-	FwupdClient *self = FWUPD_CLIENT(source_object);
-	FwupdCurlHelper *helper = g_task_get_task_data(task);
-	g_autoptr(GBytes) blob = NULL;
-
 	for (guint i = 0; i < helper->urls->len; i++) {
 		const gchar *url = g_ptr_array_index(helper->urls, i);
-		g_autoptr(GError) error = NULL;
+		g_autoptr(GBytes) blob = NULL;
+		g_autoptr(GError) error_local = NULL;
 		g_info("downloading %s", url);
 		fwupd_client_curl_helper_set_proxy(self, helper, url);
 		if (fwupd_client_is_url_http(url)) {
-			blob = fwupd_client_download_http(self, helper->curl, url, &error);
+			g_autofree gchar *fn = NULL;
+			if ((helper->download_flags & FWUPD_CLIENT_DOWNLOAD_FLAG_STREAM) > 0)
+				fn = fwupd_client_download_stream_build_filename(url);
+			if (fn != NULL) {
+				blob = fwupd_client_download_http_stream(self,
+									 helper,
+									 url,
+									 fn,
+									 &error_local);
+			} else {
+				blob = fwupd_client_download_http(self, helper, url, &error_local);
+			}
 			if (blob != NULL)
-				break;
+				return g_steal_pointer(&blob);
 		} else if (fwupd_client_is_url_ipfs(url)) {
-			blob = fwupd_client_download_ipfs(self, url, cancellable, &error);
+			blob = fwupd_client_download_ipfs(self, url, cancellable, &error_local);
 			if (blob != NULL)
-				break;
+				return g_steal_pointer(&blob);
 		} else {
-			g_set_error(&error,
+			g_set_error(&error_local,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "not sure how to handle: %s",
 				    url);
 		}
 		if (i == helper->urls->len - 1) {
-			g_task_return_error(task, g_steal_pointer(&error));
-			return;
+			g_propagate_error(error, g_steal_pointer(&error_local));
+			return NULL;
 		}
 		fwupd_client_set_percentage(self, 0);
 		fwupd_client_set_status(self, FWUPD_STATUS_IDLE);
-		g_info("failed to download %s: %s, trying next URI…", url, error->message);
+		g_info("failed to download %s: %s, trying next URI…", url, error_local->message);
+	}
+	g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE, "no valid release URIs");
+	return NULL;
+}
+
+static void
+fwupd_client_download_bytes_thread_cb(GTask *task,
+				      gpointer source_object,
+				      gpointer task_data,
+				      GCancellable *cancellable)
+{
+	FwupdClient *self = FWUPD_CLIENT(source_object);
+	FwupdCurlHelper *helper = g_task_get_task_data(task);
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+
+	blob = fwupd_client_download_bytes_urls(self, helper, cancellable, &error);
+	if (blob == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	g_task_return_pointer(task, g_steal_pointer(&blob), (GDestroyNotify)g_bytes_unref);
+}
+
+/* the checksum is only used as a filename if it looks like one */
+static gchar *
+fwupd_client_firmware_cache_build_filename(const gchar *checksum)
+{
+	g_autofree gchar *cachedir = NULL;
+
+	if (checksum == NULL || checksum[0] == '\0')
+		return NULL;
+	for (guint i = 0; checksum[i] != '\0'; i++) {
+		if (!g_ascii_isxdigit(checksum[i]))
+			return NULL;
+	}
+	cachedir = fwupd_client_build_cache_dir("firmware");
+	return g_build_filename(cachedir, checksum, NULL);
+}
+
+static gint
+fwupd_client_firmware_cache_sort_cb(gconstpointer a, gconstpointer b)
+{
+	GFileInfo *info1 = *((GFileInfo **)a);
+	GFileInfo *info2 = *((GFileInfo **)b);
+	guint64 mtime1 = g_file_info_get_attribute_uint64(info1, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+	guint64 mtime2 = g_file_info_get_attribute_uint64(info2, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+	if (mtime1 < mtime2)
+		return -1;
+	if (mtime1 > mtime2)
+		return 1;
+	return 0;
+}
+
+/* remove the least recently used firmware until the cache fits */
+static gboolean
+fwupd_client_firmware_cache_evict(const gchar *cachedir, guint64 size_max, GError **error)
+{
+	guint64 total = 0;
+	g_autoptr(GFile) file = g_file_new_for_path(cachedir);
+	g_autoptr(GFileEnumerator) enumerator = NULL;
+	g_autoptr(GPtrArray) infos = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+
+	enumerator = g_file_enumerate_children(file,
+					       G_FILE_ATTRIBUTE_STANDARD_NAME
+					       "," G_FILE_ATTRIBUTE_STANDARD_SIZE
+					       "," G_FILE_ATTRIBUTE_TIME_MODIFIED,
+					       G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+					       NULL,
+					       error);
+	if (enumerator == NULL)
+		return FALSE;
+	while (TRUE) {
+		GFileInfo *info = NULL;
+		if (!g_file_enumerator_iterate(enumerator, &info, NULL, NULL, error))
+			return FALSE;
+		if (info == NULL)
+			break;
+		total += g_file_info_get_size(info);
+		g_ptr_array_add(infos, g_object_ref(info));
+	}
+	if (total <= size_max)
+		return TRUE;
+
+	g_ptr_array_sort(infos, fwupd_client_firmware_cache_sort_cb);
+	for (guint i = 0; i < infos->len && total > size_max; i++) {
+		GFileInfo *info = g_ptr_array_index(infos, i);
+		g_autofree gchar *fn = g_build_filename(cachedir, g_file_info_get_name(info), NULL);
+		g_info("evicting cached firmware %s", fn);
+		if (g_unlink(fn) != 0) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "failed to delete %s: %s",
+				    fn,
+				    g_strerror(errno));
+			return FALSE;
+		}
+		total -= g_file_info_get_size(info);
+	}
+	return TRUE;
+}
+
+/* the partial file is renamed rather than written again */
+static void
+fwupd_client_firmware_cache_store(FwupdCurlHelper *helper, const gchar *fn, GBytes *blob)
+{
+	g_autofree gchar *dirname = g_path_get_dirname(fn);
+	g_autoptr(GError) error_local = NULL;
+
+	if (g_bytes_get_size(blob) > helper->firmware_cache_size_max) {
+		if (helper->filename_part != NULL)
+			(void)g_unlink(helper->filename_part);
+		return;
+	}
+	if (g_mkdir_with_parents(dirname, 0700) == -1) {
+		g_info("failed to create %s: %s", dirname, g_strerror(errno));
+		if (helper->filename_part != NULL)
+			(void)g_unlink(helper->filename_part);
+		return;
+	}
+	if (helper->filename_part != NULL) {
+		if (g_rename(helper->filename_part, fn) != 0) {
+			g_info("failed to cache firmware: %s", g_strerror(errno));
+			(void)g_unlink(helper->filename_part);
+			return;
+		}
+	} else if (!g_file_set_contents(fn,
+					g_bytes_get_data(blob, NULL),
+					(gssize)g_bytes_get_size(blob),
+					&error_local)) {
+		g_info("failed to cache firmware: %s", error_local->message);
+		return;
+	}
+	if (!fwupd_client_firmware_cache_evict(dirname,
+					       helper->firmware_cache_size_max,
+					       &error_local))
+		g_info("failed to evict cached firmware: %s", error_local->message);
+}
+
+/* returns %NULL if not cached or if the cached file does not match @checksum */
+static GBytes *
+fwupd_client_firmware_cache_lookup(const gchar *fn, const gchar *checksum)
+{
+	g_autofree gchar *checksum_actual = NULL;
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GMappedFile) mapped_file = NULL;
+
+	if (!g_file_test(fn, G_FILE_TEST_EXISTS))
+		return NULL;
+	mapped_file = g_mapped_file_new(fn, FALSE, &error_local);
+	if (mapped_file == NULL) {
+		g_info("failed to load cached firmware: %s", error_local->message);
+		return NULL;
+	}
+	blob = g_mapped_file_get_bytes(mapped_file);
+
+	/* the file may have been truncated or modified since it was written */
+	checksum_actual =
+	    g_compute_checksum_for_bytes(fwupd_checksum_guess_kind(checksum), blob);
+	if (g_strcmp0(checksum, checksum_actual) != 0) {
+		g_info("cached firmware %s is invalid, removing", fn);
+		g_clear_pointer(&blob, g_bytes_unref);
+		g_clear_pointer(&mapped_file, g_mapped_file_unref);
+		(void)g_unlink(fn);
+		return NULL;
+	}
+
+	/* most recently used is evicted last */
+	if (g_utime(fn, NULL) != 0)
+		g_debug("failed to update %s: %s", fn, g_strerror(errno));
+	return g_steal_pointer(&blob);
+}
+
+static void
+fwupd_client_download_firmware_thread_cb(GTask *task,
+					 gpointer source_object,
+					 gpointer task_data,
+					 GCancellable *cancellable)
+{
+	FwupdClient *self = FWUPD_CLIENT(source_object);
+	FwupdCurlHelper *helper = g_task_get_task_data(task);
+	g_autofree gchar *checksum_actual = NULL;
+	g_autofree gchar *fn = fwupd_client_firmware_cache_build_filename(helper->checksum);
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* only download on a cache miss */
+	if (fn != NULL) {
+		blob = fwupd_client_firmware_cache_lookup(fn, helper->checksum);
+		if (blob != NULL) {
+			helper->firmware_cache_hit = TRUE;
+			g_task_return_pointer(task,
+					      g_steal_pointer(&blob),
+					      (GDestroyNotify)g_bytes_unref);
+			return;
+		}
+	}
+	blob = fwupd_client_download_bytes_urls(self, helper, cancellable, &error);
+	if (blob == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+
+	/* verify checksum, which was computed as the data was written if streamed */
+	if (helper->checksum_actual != NULL) {
+		checksum_actual = g_strdup(helper->checksum_actual);
+	} else {
+		checksum_actual =
+		    g_compute_checksum_for_bytes(fwupd_checksum_guess_kind(helper->checksum),
+						 blob);
+	}
+	if (g_strcmp0(helper->checksum, checksum_actual) != 0) {
+		if (helper->filename_part != NULL)
+			(void)g_unlink(helper->filename_part);
+		g_task_return_new_error(task,
+					FWUPD_ERROR,
+					FWUPD_ERROR_INVALID_FILE,
+					"checksum invalid, expected %s got %s",
+					helper->checksum,
+					checksum_actual);
+		return;
+	}
+
+	/* for the next device of the same model, or a retried install */
+	if (fn != NULL) {
+		fwupd_client_firmware_cache_store(helper, fn, blob);
+	} else if (helper->filename_part != NULL) {
+		(void)g_unlink(helper->filename_part);
 	}
 	g_task_return_pointer(task, g_steal_pointer(&blob), (GDestroyNotify)g_bytes_unref);
 }
@@ -5280,6 +6071,7 @@ fwupd_client_download_bytes2_async(FwupdClient *self,
 		g_task_return_error(task, g_steal_pointer(&error));
 		return;
 	}
+	helper->download_flags = flags;
 	g_task_set_task_data(task,
 			     g_steal_pointer(&helper),
 			     (GDestroyNotify)fwupd_client_curl_helper_free);
@@ -5291,6 +6083,161 @@ fwupd_client_download_bytes2_async(FwupdClient *self,
 #endif
 }
 
+/* private, the firmware is verified against @checksum and cached */
+void
+fwupd_client_download_firmware_async(FwupdClient *self,
+				     GPtrArray *urls,
+				     const gchar *checksum,
+				     FwupdClientDownloadFlags flags,
+				     GCancellable *cancellable,
+				     GAsyncReadyCallback callback,
+				     gpointer callback_data)
+{
+	g_autoptr(GTask) task = NULL;
+#ifdef HAVE_LIBCURL
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(FwupdCurlHelper) helper = NULL;
+#endif
+
+	g_return_if_fail(FWUPD_IS_CLIENT(self));
+	g_return_if_fail(urls != NULL);
+	g_return_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable));
+
+	task = g_task_new(self, cancellable, callback, callback_data);
+#ifdef HAVE_LIBCURL
+	helper = fwupd_client_curl_new(self, &error);
+	if (helper == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	helper->urls = fwupd_client_filter_locations(urls, flags, &error);
+	if (helper->urls == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	helper->download_flags = flags;
+	helper->checksum = g_strdup(checksum);
+	helper->firmware_cache_size_max = priv->firmware_cache_size_max;
+	g_task_set_task_data(task,
+			     g_steal_pointer(&helper),
+			     (GDestroyNotify)fwupd_client_curl_helper_free);
+
+	/* the cache lookup, download and checksum are all done in the thread */
+	g_task_run_in_thread(task, fwupd_client_download_firmware_thread_cb);
+#else
+	g_task_return_new_error(task, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no libcurl support");
+#endif
+}
+
+/* private */
+GBytes *
+fwupd_client_download_firmware_finish(FwupdClient *self, GAsyncResult *res, GError **error)
+{
+	GBytes *blob;
+#ifdef HAVE_LIBCURL
+	FwupdClientPrivate *priv = GET_PRIVATE(self);
+	FwupdCurlHelper *helper;
+#endif
+
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(g_task_is_valid(res, self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	blob = g_task_propagate_pointer(G_TASK(res), error);
+	if (blob == NULL)
+		return NULL;
+#ifdef HAVE_LIBCURL
+	helper = g_task_get_task_data(G_TASK(res));
+	if (helper->firmware_cache_hit) {
+		priv->firmware_cache_hits++;
+		priv->firmware_cache_bytes_saved += g_bytes_get_size(blob);
+		g_info("using cached firmware, %u hits have saved %" G_GUINT64_FORMAT " bytes",
+		       priv->firmware_cache_hits,
+		       priv->firmware_cache_bytes_saved);
+	}
+#endif
+	return blob;
+}
+
+/* use fwupd_client_download_conditional_finish() to get the result */
+static void
+fwupd_client_download_conditional_async(FwupdClient *self,
+					const gchar *url,
+					const gchar *etag,
+					const gchar *last_modified,
+					GCancellable *cancellable,
+					GAsyncReadyCallback callback,
+					gpointer callback_data)
+{
+	g_autoptr(GTask) task = NULL;
+#ifdef HAVE_LIBCURL
+	g_autoptr(GError) error = NULL;
+	g_autoptr(FwupdCurlHelper) helper = NULL;
+#endif
+
+	task = g_task_new(self, cancellable, callback, callback_data);
+#ifdef HAVE_LIBCURL
+	helper = fwupd_client_curl_new(self, &error);
+	if (helper == NULL) {
+		g_task_return_error(task, g_steal_pointer(&error));
+		return;
+	}
+	helper->urls = g_ptr_array_new_with_free_func(g_free);
+	g_ptr_array_add(helper->urls, g_strdup(url));
+
+	/* only send the body if it has changed since we last saw it */
+	if (etag != NULL) {
+		g_autofree gchar *hdr = g_strdup_printf("If-None-Match: %s", etag);
+		helper->headers = curl_slist_append(helper->headers, hdr);
+	}
+	if (last_modified != NULL) {
+		g_autofree gchar *hdr = g_strdup_printf("If-Modified-Since: %s", last_modified);
+		helper->headers = curl_slist_append(helper->headers, hdr);
+	}
+	if (helper->headers != NULL)
+		(void)curl_easy_setopt(helper->curl, CURLOPT_HTTPHEADER, helper->headers);
+	(void)curl_easy_setopt(helper->curl,
+			       CURLOPT_HEADERFUNCTION,
+			       fwupd_client_download_header_callback_cb);
+	(void)curl_easy_setopt(helper->curl, CURLOPT_HEADERDATA, helper);
+	g_task_set_task_data(task,
+			     g_steal_pointer(&helper),
+			     (GDestroyNotify)fwupd_client_curl_helper_free);
+
+	/* download data */
+	g_task_run_in_thread(task, fwupd_client_download_bytes_thread_cb);
+#else
+	g_task_return_new_error(task, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no libcurl support");
+#endif
+}
+
+/* returns an empty blob and sets @not_modified if the server returned 304 */
+static GBytes *
+fwupd_client_download_conditional_finish(FwupdClient *self,
+					 GAsyncResult *res,
+					 gchar **etag,
+					 gchar **last_modified,
+					 gboolean *not_modified,
+					 GError **error)
+{
+	GBytes *blob;
+#ifdef HAVE_LIBCURL
+	FwupdCurlHelper *helper = g_task_get_task_data(G_TASK(res));
+#endif
+
+	g_return_val_if_fail(g_task_is_valid(res, self), NULL);
+	blob = g_task_propagate_pointer(G_TASK(res), error);
+#ifdef HAVE_LIBCURL
+	if (blob != NULL) {
+		*etag = g_steal_pointer(&helper->etag);
+		*last_modified = g_steal_pointer(&helper->last_modified);
+		*not_modified = helper->not_modified;
+	}
+#endif
+	return blob;
+}
+
 /**
  * fwupd_client_download_bytes_async:
  * @self: a #FwupdClient
@@ -5303,6 +6250,11 @@ fwupd_client_download_bytes2_async(FwupdClient *self,
  * Downloads data from a remote server. The [method@Client.set_user_agent] function
  * should be called before this method is used.
  *
+ * If %FWUPD_CLIENT_DOWNLOAD_FLAG_STREAM is set then the data is written to a file in the
+ * user cache directory rather than being held in memory, an interrupted transfer is resumed
+ * and the returned data is mapped from the completed file. If the cache directory cannot be
+ * written then the data is held in memory instead.
+ *
  * You must have called [method@Client.connect_async] on @self before using
  * this method.
  *
@@ -6355,6 +7307,7 @@ fwupd_client_init(FwupdClient *self)
 	priv->hints = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	priv->battery_level = FWUPD_BATTERY_LEVEL_INVALID;
 	priv->battery_threshold = FWUPD_BATTERY_LEVEL_INVALID;
+	priv->firmware_cache_size_max = FWUPD_CLIENT_FIRMWARE_CACHE_SIZE_MAX;
 
 	/* we get this one for free */
 	fwupd_client_add_hint(self, "locale", g_getenv("LANG"));
@@ -40,12 +40,14 @@ struct _FwupdClientClass {
  * FwupdClientDownloadFlags:
  * @FWUPD_CLIENT_DOWNLOAD_FLAG_NONE:		No flags set
  * @FWUPD_CLIENT_DOWNLOAD_FLAG_ONLY_IPFS:	Only use IPFS when downloading URIs
+ * @FWUPD_CLIENT_DOWNLOAD_FLAG_STREAM:		Stream to a resumable file in the cache directory
  *
  * The options to use for downloading.
  **/
 typedef enum {
 	FWUPD_CLIENT_DOWNLOAD_FLAG_NONE = 0,	       /* Since: 1.4.5 */
 	FWUPD_CLIENT_DOWNLOAD_FLAG_ONLY_IPFS = 1 << 0, /* Since: 1.5.6 */
+	FWUPD_CLIENT_DOWNLOAD_FLAG_STREAM = 1 << 1,    /* Since: 1.8.14 */
 	/*< private >*/
 	FWUPD_CLIENT_DOWNLOAD_FLAG_LAST
 } FwupdClientDownloadFlags;
@@ -538,6 +540,10 @@ void
 fwupd_client_set_user_agent_for_package(FwupdClient *self,
 					const gchar *package_name,
 					const gchar *package_version);
+guint
+fwupd_client_get_firmware_cache_hits(FwupdClient *self);
+guint64
+fwupd_client_get_firmware_cache_bytes_saved(FwupdClient *self);
 void
 fwupd_client_download_bytes_async(FwupdClient *self,
 				  const gchar *url,
@@ -29,10 +29,6 @@
 #endif
 #include <json-glib/json-glib.h>
 
-#if !GLIB_CHECK_VERSION(2, 54, 0)
-#include <errno.h>
-#endif
-
 /**
  * fwupd_checksum_guess_kind:
  * @checksum: (nullable): a checksum
@@ -697,76 +693,6 @@ fwupd_guid_to_string(const fwupd_guid_t *guid, FwupdGuidFlags flags)
 			       gnat.e[5]);
 }
 
-#if !GLIB_CHECK_VERSION(2, 54, 0)
-static gboolean
-str_has_sign(const gchar *str)
-{
-	return str[0] == '-' || str[0] == '+';
-}
-
-static gboolean
-str_has_hex_prefix(const gchar *str)
-{
-	return str[0] == '0' && g_ascii_tolower(str[1]) == 'x';
-}
-
-static gboolean
-g_ascii_string_to_unsigned(const gchar *str,
-			   guint base,
-			   guint64 min,
-			   guint64 max,
-			   guint64 *out_num,
-			   GError **error)
-{
-	const gchar *end_ptr = NULL;
-	gint saved_errno = 0;
-	guint64 number;
-
-	g_return_val_if_fail(str != NULL, FALSE);
-	g_return_val_if_fail(base >= 2 && base <= 36, FALSE);
-	g_return_val_if_fail(min <= max, FALSE);
-	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
-
-	if (str[0] == '\0') {
-		g_set_error_literal(error,
-				    G_IO_ERROR,
-				    G_IO_ERROR_INVALID_DATA,
-				    "Empty string is not a number");
-		return FALSE;
-	}
-
-	errno = 0;
-	number = g_ascii_strtoull(str, (gchar **)&end_ptr, base);
-	saved_errno = errno;
-
-	if (g_ascii_isspace(str[0]) || str_has_sign(str) ||
-	    (base == 16 && str_has_hex_prefix(str)) ||
-	    (saved_errno != 0 && saved_errno != ERANGE) || end_ptr == NULL || *end_ptr != '\0') {
-		g_set_error(error,
-			    G_IO_ERROR,
-			    G_IO_ERROR_INVALID_DATA,
-			    "“%s” is not an unsigned number",
-			    str);
-		return FALSE;
-	}
-	if (saved_errno == ERANGE || number < min || number > max) {
-		g_autofree gchar *min_str = g_strdup_printf("%" G_GUINT64_FORMAT, min);
-		g_autofree gchar *max_str = g_strdup_printf("%" G_GUINT64_FORMAT, max);
-		g_set_error(error,
-			    G_IO_ERROR,
-			    G_IO_ERROR_INVALID_DATA,
-			    "Number “%s” is out of bounds [%s, %s]",
-			    str,
-			    min_str,
-			    max_str);
-		return FALSE;
-	}
-	if (out_num != NULL)
-		*out_num = number;
-	return TRUE;
-}
-#endif /* GLIB_CHECK_VERSION(2,54,0) */
-
 /**
  * fwupd_guid_from_string:
  * @guidstr: (not nullable): a GUID, e.g. `00112233-4455-6677-8899-aabbccddeeff`
@@ -787,88 +713,93 @@ fwupd_guid_from_string(const gchar *guidstr,
 		       FwupdGuidFlags flags,
 		       GError **error)
 {
-	fwupd_guid_native_t gu = {0x0};
-	gboolean mixed_endian = flags & FWUPD_GUID_FLAG_MIXED_ENDIAN;
-	guint64 tmp;
-	g_auto(GStrv) split = NULL;
+	const gchar zeroguid[] = {"00000000-0000-0000-0000-000000000000"};
+	guint8 buf[16] = {0x0};
+	guint j = 0;
 
 	g_return_val_if_fail(guidstr != NULL, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
-	/* split into sections */
-	if (strlen(guidstr) != 36) {
+	/* check the sections are the right size */
+	if (strlen(guidstr) != sizeof(zeroguid) - 1) {
 		g_set_error_literal(error,
 				    G_IO_ERROR,
 				    G_IO_ERROR_INVALID_DATA,
 				    "GUID is not valid format");
 		return FALSE;
 	}
-	split = g_strsplit(guidstr, "-", 5);
-	if (g_strv_length(split) != 5) {
-		g_set_error_literal(error,
-				    G_IO_ERROR,
-				    G_IO_ERROR_INVALID_DATA,
-				    "GUID is not valid format, no dashes");
-		return FALSE;
-	}
-	if (strlen(split[0]) != 8 && strlen(split[1]) != 4 && strlen(split[2]) != 4 &&
-	    strlen(split[3]) != 4 && strlen(split[4]) != 12) {
-		g_set_error_literal(error,
-				    G_IO_ERROR,
-				    G_IO_ERROR_INVALID_DATA,
-				    "GUID is not valid format, not GUID");
-		return FALSE;
+	for (guint i = 0; i < sizeof(zeroguid) - 1; i++) {
+		if ((zeroguid[i] == '-') != (guidstr[i] == '-')) {
+			g_set_error_literal(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_INVALID_DATA,
+					    "GUID is not valid format, no dashes");
+			return FALSE;
+		}
 	}
 
-	/* parse */
-	if (!g_ascii_string_to_unsigned(split[0], 16, 0, 0xffffffff, &tmp, error))
-		return FALSE;
-	gu.a = mixed_endian ? GUINT32_TO_LE(tmp) : GUINT32_TO_BE(tmp);
-	if (!g_ascii_string_to_unsigned(split[1], 16, 0, 0xffff, &tmp, error))
-		return FALSE;
-	gu.b = mixed_endian ? GUINT16_TO_LE(tmp) : GUINT16_TO_BE(tmp);
-	if (!g_ascii_string_to_unsigned(split[2], 16, 0, 0xffff, &tmp, error))
-		return FALSE;
-	gu.c = mixed_endian ? GUINT16_TO_LE(tmp) : GUINT16_TO_BE(tmp);
-	if (!g_ascii_string_to_unsigned(split[3], 16, 0, 0xffff, &tmp, error))
-		return FALSE;
-	gu.d = GUINT16_TO_BE(tmp);
-	for (guint i = 0; i < 6; i++) {
-		gchar buffer[3] = {0x0};
-		memcpy(buffer, split[4] + (i * 2), 2);
-		if (!g_ascii_string_to_unsigned(buffer, 16, 0, 0xff, &tmp, error))
+	/* parse each hex byte in place, which is big endian */
+	for (guint i = 0; i < sizeof(zeroguid) - 1; i += 2) {
+		gint hi, lo;
+		if (guidstr[i] == '-')
+			i++;
+		hi = g_ascii_xdigit_value(guidstr[i]);
+		lo = g_ascii_xdigit_value(guidstr[i + 1]);
+		if (hi < 0 || lo < 0) {
+			g_set_error_literal(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_INVALID_DATA,
+					    "GUID is not valid format, not GUID");
 			return FALSE;
-		gu.e[i] = tmp;
+		}
+		buf[j++] = (guint8)((hi << 4) | lo);
+	}
+
+	/* the first three sections are little endian in the DCE encoding */
+	if (flags & FWUPD_GUID_FLAG_MIXED_ENDIAN) {
+		guint8 tmp;
+		tmp = buf[0];
+		buf[0] = buf[3];
+		buf[3] = tmp;
+		tmp = buf[1];
+		buf[1] = buf[2];
+		buf[2] = tmp;
+		tmp = buf[4];
+		buf[4] = buf[5];
+		buf[5] = tmp;
+		tmp = buf[6];
+		buf[6] = buf[7];
+		buf[7] = tmp;
 	}
 	if (guid != NULL)
-		memcpy(guid, &gu, sizeof(gu));
+		memcpy(guid, buf, sizeof(buf));
 
 	/* success */
 	return TRUE;
 }
 
 /**
- * fwupd_guid_hash_data:
+ * fwupd_guid_hash_data_raw: (skip):
  * @data: data to hash
  * @datasz: length of @data
  * @flags: GUID flags, e.g. %FWUPD_GUID_FLAG_NAMESPACE_MICROSOFT
+ * @guid: a #fwupd_guid_t to write
  *
- * Returns a GUID for some data. This uses a hash and so even small
- * differences in the @data will produce radically different return values.
+ * Gets the binary GUID for some data, which is the same value as fwupd_guid_hash_data() without
+ * formatting it as a string.
  *
- * The implementation is taken from RFC4122, Section 4.1.3; specifically
- * using a type-5 SHA-1 hash.
- *
- * Returns: a new GUID, or %NULL for internal error
+ * Returns: %TRUE for success
  *
- * Since: 1.2.5
+ * Since: 1.8.14
  **/
-gchar *
-fwupd_guid_hash_data(const guint8 *data, gsize datasz, FwupdGuidFlags flags)
+gboolean
+fwupd_guid_hash_data_raw(const guint8 *data,
+			 gsize datasz,
+			 FwupdGuidFlags flags,
+			 fwupd_guid_t *guid)
 {
 	gsize digestlen = 20;
 	guint8 hash[20];
-	fwupd_guid_t uu_new;
 	g_autoptr(GChecksum) csum = NULL;
 	const fwupd_guid_t uu_default = {0x6b,
 					 0xa7,
@@ -889,8 +820,9 @@ fwupd_guid_hash_data(const guint8 *data, gsize datasz, FwupdGuidFlags flags)
 	const fwupd_guid_t uu_microso = {0x70, 0xff, 0xd8, 0x12, 0x4c, 0x7f, 0x4c, 0x7d};
 	const fwupd_guid_t *uu_namespace = &uu_default;
 
-	g_return_val_if_fail(data != NULL, NULL);
-	g_return_val_if_fail(datasz != 0, NULL);
+	g_return_val_if_fail(data != NULL, FALSE);
+	g_return_val_if_fail(datasz != 0, FALSE);
+	g_return_val_if_fail(guid != NULL, FALSE);
 
 	/* old MS GUID */
 	if (flags & FWUPD_GUID_FLAG_NAMESPACE_MICROSOFT)
@@ -903,11 +835,36 @@ fwupd_guid_hash_data(const guint8 *data, gsize datasz, FwupdGuidFlags flags)
 	g_checksum_get_digest(csum, hash, &digestlen);
 
 	/* copy most parts of the hash 1:1 */
-	memcpy(uu_new, hash, sizeof(uu_new));
+	memcpy(guid, hash, sizeof(*guid));
 
 	/* set specific bits according to Section 4.1.3 */
-	uu_new[6] = (guint8)((uu_new[6] & 0x0f) | (5 << 4));
-	uu_new[8] = (guint8)((uu_new[8] & 0x3f) | 0x80);
+	(*guid)[6] = (guint8)(((*guid)[6] & 0x0f) | (5 << 4));
+	(*guid)[8] = (guint8)(((*guid)[8] & 0x3f) | 0x80);
+	return TRUE;
+}
+
+/**
+ * fwupd_guid_hash_data:
+ * @data: data to hash
+ * @datasz: length of @data
+ * @flags: GUID flags, e.g. %FWUPD_GUID_FLAG_NAMESPACE_MICROSOFT
+ *
+ * Returns a GUID for some data. This uses a hash and so even small
+ * differences in the @data will produce radically different return values.
+ *
+ * The implementation is taken from RFC4122, Section 4.1.3; specifically
+ * using a type-5 SHA-1 hash.
+ *
+ * Returns: a new GUID, or %NULL for internal error
+ *
+ * Since: 1.2.5
+ **/
+gchar *
+fwupd_guid_hash_data(const guint8 *data, gsize datasz, FwupdGuidFlags flags)
+{
+	fwupd_guid_t uu_new;
+	if (!fwupd_guid_hash_data_raw(data, datasz, flags, &uu_new))
+		return NULL;
 	return fwupd_guid_to_string((const fwupd_guid_t *)&uu_new, flags);
 }
 
@@ -1135,7 +1092,7 @@ fwupd_unix_input_stream_from_bytes(GBytes *bytes, GError **error)
 #endif
 
 #ifdef HAVE_MEMFD_CREATE
-	fd = memfd_create("fwupd", MFD_CLOEXEC);
+	fd = memfd_create("fwupd", MFD_CLOEXEC | MFD_ALLOW_SEALING);
 #else
 	/* emulate in-memory file by an unlinked temporary file */
 	fd = g_mkstemp(tmp_file);
@@ -1179,6 +1136,11 @@ fwupd_unix_input_stream_from_bytes(GBytes *bytes, GError **error)
 			    g_strerror(errno));
 		return NULL;
 	}
+#ifdef F_ADD_SEALS
+	/* the daemon can map a sealed memfd rather than copying it */
+	if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0)
+		g_debug("failed to seal memfd: %s", g_strerror(errno));
+#endif
 	return G_UNIX_INPUT_STREAM(g_unix_input_stream_new(fd, TRUE));
 }
 
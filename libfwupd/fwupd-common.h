@@ -104,5 +104,12 @@ gchar *
 fwupd_guid_hash_string(const gchar *str);
 gchar *
 fwupd_guid_hash_data(const guint8 *data, gsize datasz, FwupdGuidFlags flags);
+#ifndef __GI_SCANNER__
+gboolean
+fwupd_guid_hash_data_raw(const guint8 *data,
+			 gsize datasz,
+			 FwupdGuidFlags flags,
+			 fwupd_guid_t *guid);
+#endif
 
 G_END_DECLS
@@ -24,5 +24,7 @@ void
 fwupd_device_to_json_full(FwupdDevice *self, JsonBuilder *builder, FwupdDeviceFlags flags);
 gboolean
 fwupd_device_from_json(FwupdDevice *self, JsonNode *json_node, GError **error);
+void
+fwupd_device_remove_guids(FwupdDevice *self);
 
 G_END_DECLS
@@ -35,6 +35,8 @@ typedef struct {
 	guint64 flags;
 	guint64 problems;
 	GPtrArray *guids;
+	GHashTable *guids_raw; /* (element-type fwupd_guid_t) */
+	guint guids_raw_len;   /* number of @guids added to @guids_raw */
 	GPtrArray *vendor_ids;
 	GPtrArray *protocols;
 	GPtrArray *instance_ids;
@@ -628,6 +630,81 @@ fwupd_device_get_guids(FwupdDevice *self)
 	return priv->guids;
 }
 
+static guint
+fwupd_device_guid_hash(gconstpointer key)
+{
+	guint32 tmp[4];
+	memcpy(tmp, key, sizeof(tmp));
+	return tmp[0] ^ tmp[1] ^ tmp[2] ^ tmp[3];
+}
+
+static gboolean
+fwupd_device_guid_equal(gconstpointer a, gconstpointer b)
+{
+	return memcmp(a, b, sizeof(fwupd_guid_t)) == 0;
+}
+
+static void
+fwupd_device_ensure_guids_raw(FwupdDevice *self)
+{
+	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+
+	/* the GUIDs were removed, e.g. by a rescan */
+	if (priv->guids->len < priv->guids_raw_len) {
+		g_hash_table_remove_all(priv->guids_raw);
+		priv->guids_raw_len = 0;
+	}
+
+	/* only parse the GUIDs added since last time */
+	for (guint i = priv->guids_raw_len; i < priv->guids->len; i++) {
+		const gchar *guid = g_ptr_array_index(priv->guids, i);
+		fwupd_guid_t *guid_raw = g_new0(fwupd_guid_t, 1);
+		if (!fwupd_guid_from_string(guid, guid_raw, FWUPD_GUID_FLAG_NONE, NULL)) {
+			g_free(guid_raw);
+			continue;
+		}
+		g_hash_table_add(priv->guids_raw, guid_raw);
+	}
+	priv->guids_raw_len = priv->guids->len;
+}
+
+/**
+ * fwupd_device_has_guid_raw: (skip):
+ * @self: a #FwupdDevice
+ * @guid: (not nullable): a #fwupd_guid_t, in big endian encoding
+ *
+ * Finds out if the device has this specific GUID without parsing or formatting any strings.
+ *
+ * Unlike fwupd_device_has_guid() this compares the GUID value, and so a device GUID added in
+ * uppercase will also match.
+ *
+ * Returns: %TRUE if the GUID is found
+ *
+ * Since: 1.8.14
+ **/
+gboolean
+fwupd_device_has_guid_raw(FwupdDevice *self, const fwupd_guid_t *guid)
+{
+	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+
+	g_return_val_if_fail(FWUPD_IS_DEVICE(self), FALSE);
+	g_return_val_if_fail(guid != NULL, FALSE);
+
+	/* the GUIDs were changed without fwupd_device_add_guid(), so do not modify the set here */
+	if (priv->guids_raw_len != priv->guids->len) {
+		for (guint i = 0; i < priv->guids->len; i++) {
+			const gchar *guid_tmp = g_ptr_array_index(priv->guids, i);
+			fwupd_guid_t guid_raw = {0x0};
+			if (!fwupd_guid_from_string(guid_tmp, &guid_raw, FWUPD_GUID_FLAG_NONE, NULL))
+				continue;
+			if (memcmp(&guid_raw, guid, sizeof(guid_raw)) == 0)
+				return TRUE;
+		}
+		return FALSE;
+	}
+	return g_hash_table_contains(priv->guids_raw, guid);
+}
+
 /**
  * fwupd_device_has_guid:
  * @self: a #FwupdDevice
@@ -672,7 +749,29 @@ fwupd_device_add_guid(FwupdDevice *self, const gchar *guid)
 	g_return_if_fail(guid != NULL);
 	if (fwupd_device_has_guid(self, guid))
 		return;
+
+	/* the array may have been truncated since the last add */
+	fwupd_device_ensure_guids_raw(self);
 	g_ptr_array_add(priv->guids, g_strdup(guid));
+	fwupd_device_ensure_guids_raw(self);
+}
+
+/**
+ * fwupd_device_remove_guids:
+ * @self: a #FwupdDevice
+ *
+ * Removes all the GUIDs from the device.
+ *
+ * Since: 1.8.14
+ **/
+void
+fwupd_device_remove_guids(FwupdDevice *self)
+{
+	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	g_ptr_array_set_size(priv->guids, 0);
+	g_hash_table_remove_all(priv->guids_raw);
+	priv->guids_raw_len = 0;
 }
 
 /**
@@ -3923,6 +4022,8 @@ fwupd_device_init(FwupdDevice *self)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	priv->guids = g_ptr_array_new_with_free_func(g_free);
+	priv->guids_raw =
+	    g_hash_table_new_full(fwupd_device_guid_hash, fwupd_device_guid_equal, g_free, NULL);
 	priv->instance_ids = g_ptr_array_new_with_free_func(g_free);
 	priv->icons = g_ptr_array_new_with_free_func(g_free);
 	priv->checksums = g_ptr_array_new_with_free_func(g_free);
@@ -3967,6 +4068,7 @@ fwupd_device_finalize(GObject *object)
 	g_free(priv->version_lowest);
 	g_free(priv->version_bootloader);
 	g_ptr_array_unref(priv->guids);
+	g_hash_table_unref(priv->guids_raw);
 	g_ptr_array_unref(priv->vendor_ids);
 	g_ptr_array_unref(priv->protocols);
 	g_ptr_array_unref(priv->instance_ids);
@@ -8,6 +8,7 @@
 
 #include <glib-object.h>
 
+#include "fwupd-common.h"
 #include "fwupd-enums.h"
 #include "fwupd-release.h"
 
@@ -195,6 +196,10 @@ void
 fwupd_device_add_guid(FwupdDevice *self, const gchar *guid);
 gboolean
 fwupd_device_has_guid(FwupdDevice *self, const gchar *guid);
+#ifndef __GI_SCANNER__
+gboolean
+fwupd_device_has_guid_raw(FwupdDevice *self, const fwupd_guid_t *guid);
+#endif
 GPtrArray *
 fwupd_device_get_guids(FwupdDevice *self);
 const gchar *
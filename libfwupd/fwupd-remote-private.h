@@ -40,6 +40,18 @@ void
 fwupd_remote_set_metadata_uri(FwupdRemote *self, const gchar *metadata_uri);
 void
 fwupd_remote_set_mtime(FwupdRemote *self, guint64 mtime);
+const gchar *
+fwupd_remote_get_etag(FwupdRemote *self);
+void
+fwupd_remote_set_etag(FwupdRemote *self, const gchar *etag);
+const gchar *
+fwupd_remote_get_last_modified(FwupdRemote *self);
+void
+fwupd_remote_set_last_modified(FwupdRemote *self, const gchar *last_modified);
+gboolean
+fwupd_remote_load_validators(FwupdRemote *self, const gchar *filename, GError **error);
+gboolean
+fwupd_remote_save_validators(FwupdRemote *self, const gchar *filename, GError **error);
 gchar **
 fwupd_remote_get_order_after(FwupdRemote *self);
 gchar **
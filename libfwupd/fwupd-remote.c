@@ -6,6 +6,7 @@
 
 #include "config.h"
 
+#include <glib/gstdio.h>
 #ifdef HAVE_LIBCURL
 #include <curl/curl.h>
 #endif
@@ -44,6 +45,8 @@ typedef struct {
 	gchar *title;
 	gchar *agreement;
 	gchar *checksum;
+	gchar *etag;	      /* of the metadata signature */
+	gchar *last_modified; /* of the metadata signature */
 	gchar *filename_cache;
 	gchar *filename_cache_sig;
 	gchar *filename_source;
@@ -838,6 +841,186 @@ fwupd_remote_save_to_filename(FwupdRemote *self,
 	return g_key_file_save_to_file(kf, filename, error);
 }
 
+/**
+ * fwupd_remote_get_etag:
+ * @self: a #FwupdRemote
+ *
+ * Gets the HTTP entity tag of the metadata signature the remote was last refreshed with.
+ *
+ * Returns: a string, or %NULL if unset
+ *
+ * Since: 1.8.14
+ **/
+const gchar *
+fwupd_remote_get_etag(FwupdRemote *self)
+{
+	FwupdRemotePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_REMOTE(self), NULL);
+	return priv->etag;
+}
+
+/**
+ * fwupd_remote_set_etag:
+ * @self: a #FwupdRemote
+ * @etag: (nullable): an HTTP entity tag, e.g. `"5f1a2b"`
+ *
+ * Sets the HTTP entity tag of the metadata signature.
+ *
+ * Since: 1.8.14
+ **/
+void
+fwupd_remote_set_etag(FwupdRemote *self, const gchar *etag)
+{
+	FwupdRemotePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_REMOTE(self));
+
+	/* not changed */
+	if (g_strcmp0(priv->etag, etag) == 0)
+		return;
+
+	g_free(priv->etag);
+	priv->etag = g_strdup(etag);
+}
+
+/**
+ * fwupd_remote_get_last_modified:
+ * @self: a #FwupdRemote
+ *
+ * Gets the HTTP modification date of the metadata signature the remote was last refreshed with.
+ *
+ * Returns: a string, or %NULL if unset
+ *
+ * Since: 1.8.14
+ **/
+const gchar *
+fwupd_remote_get_last_modified(FwupdRemote *self)
+{
+	FwupdRemotePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FWUPD_IS_REMOTE(self), NULL);
+	return priv->last_modified;
+}
+
+/**
+ * fwupd_remote_set_last_modified:
+ * @self: a #FwupdRemote
+ * @last_modified: (nullable): an HTTP date, e.g. `Wed, 21 Oct 2015 07:28:00 GMT`
+ *
+ * Sets the HTTP modification date of the metadata signature.
+ *
+ * Since: 1.8.14
+ **/
+void
+fwupd_remote_set_last_modified(FwupdRemote *self, const gchar *last_modified)
+{
+	FwupdRemotePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_REMOTE(self));
+
+	/* not changed */
+	if (g_strcmp0(priv->last_modified, last_modified) == 0)
+		return;
+
+	g_free(priv->last_modified);
+	priv->last_modified = g_strdup(last_modified);
+}
+
+/**
+ * fwupd_remote_load_validators:
+ * @self: a #FwupdRemote
+ * @filename: (not nullable): a filename
+ * @error: (nullable): optional return location for an error
+ *
+ * Loads the HTTP validators saved by fwupd_remote_save_validators(). They are only used
+ * if they were saved for the metadata signature the remote currently has, so that a conditional
+ * request can never hide metadata the remote does not actually have.
+ *
+ * Returns: %TRUE for success, including when there is nothing to load
+ *
+ * Since: 1.8.14
+ **/
+gboolean
+fwupd_remote_load_validators(FwupdRemote *self, const gchar *filename, GError **error)
+{
+	FwupdRemotePrivate *priv = GET_PRIVATE(self);
+	const gchar *group = "fwupd Remote";
+	g_autofree gchar *checksum = NULL;
+	g_autofree gchar *etag = NULL;
+	g_autofree gchar *last_modified = NULL;
+	g_autoptr(GKeyFile) kf = g_key_file_new();
+
+	g_return_val_if_fail(FWUPD_IS_REMOTE(self), FALSE);
+	g_return_val_if_fail(filename != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	fwupd_remote_set_etag(self, NULL);
+	fwupd_remote_set_last_modified(self, NULL);
+	if (!g_file_test(filename, G_FILE_TEST_EXISTS))
+		return TRUE;
+	if (!g_key_file_load_from_file(kf, filename, G_KEY_FILE_NONE, error))
+		return FALSE;
+	checksum = g_key_file_get_string(kf, group, "Checksum", NULL);
+	if (priv->checksum == NULL || g_strcmp0(checksum, priv->checksum) != 0)
+		return TRUE;
+	etag = g_key_file_get_string(kf, group, "ETag", NULL);
+	last_modified = g_key_file_get_string(kf, group, "LastModified", NULL);
+	fwupd_remote_set_etag(self, etag);
+	fwupd_remote_set_last_modified(self, last_modified);
+	return TRUE;
+}
+
+/**
+ * fwupd_remote_save_validators:
+ * @self: a #FwupdRemote
+ * @filename: (not nullable): a filename
+ * @error: (nullable): optional return location for an error
+ *
+ * Saves the HTTP validators of the metadata signature along with its checksum.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.14
+ **/
+gboolean
+fwupd_remote_save_validators(FwupdRemote *self, const gchar *filename, GError **error)
+{
+	FwupdRemotePrivate *priv = GET_PRIVATE(self);
+	const gchar *group = "fwupd Remote";
+	g_autofree gchar *dirname = NULL;
+	g_autoptr(GKeyFile) kf = g_key_file_new();
+
+	g_return_val_if_fail(FWUPD_IS_REMOTE(self), FALSE);
+	g_return_val_if_fail(filename != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* nothing to validate against */
+	if (priv->checksum == NULL || (priv->etag == NULL && priv->last_modified == NULL)) {
+		if (g_file_test(filename, G_FILE_TEST_EXISTS) && g_unlink(filename) != 0) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "failed to delete %s",
+				    filename);
+			return FALSE;
+		}
+		return TRUE;
+	}
+
+	g_key_file_set_string(kf, group, "Checksum", priv->checksum);
+	if (priv->etag != NULL)
+		g_key_file_set_string(kf, group, "ETag", priv->etag);
+	if (priv->last_modified != NULL)
+		g_key_file_set_string(kf, group, "LastModified", priv->last_modified);
+	dirname = g_path_get_dirname(filename);
+	if (g_mkdir_with_parents(dirname, 0700) == -1) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "failed to create %s",
+			    dirname);
+		return FALSE;
+	}
+	return g_key_file_save_to_file(kf, filename, error);
+}
+
 /**
  * fwupd_remote_get_order_after:
  * @self: a #FwupdRemote
@@ -1852,6 +2035,8 @@ fwupd_remote_finalize(GObject *obj)
 	g_free(priv->agreement);
 	g_free(priv->remotes_dir);
 	g_free(priv->checksum);
+	g_free(priv->etag);
+	g_free(priv->last_modified);
 	g_free(priv->filename_cache);
 	g_free(priv->filename_cache_sig);
 	g_free(priv->filename_source);
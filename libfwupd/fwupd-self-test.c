@@ -6,6 +6,7 @@
 
 #include "config.h"
 
+#include <glib/gstdio.h>
 #include <locale.h>
 #include <string.h>
 #ifdef HAVE_FNMATCH_H
@@ -13,6 +14,7 @@
 #endif
 
 #include "fwupd-bios-setting-private.h"
+#include "fwupd-client-private.h"
 #include "fwupd-client-sync.h"
 #include "fwupd-client.h"
 #include "fwupd-common.h"
@@ -902,7 +904,25 @@ fwupd_device_func(void)
 	g_autofree gchar *data = NULL;
 	g_autofree gchar *str = NULL;
 	g_autoptr(FwupdDevice) dev = NULL;
+	const fwupd_guid_t guid_raw1 = {0x20,
+					0x82,
+					0xb5,
+					0xe0,
+					0x7a,
+					0x64,
+					0x47,
+					0x8a,
+					0xb1,
+					0xb2,
+					0xe3,
+					0x40,
+					0x4f,
+					0xab,
+					0x6d,
+					0xad};
+	const fwupd_guid_t guid_raw2 = {0x00, 0x11, 0x22, 0x33};
 	g_autoptr(FwupdDevice) dev2 = fwupd_device_new();
+	g_autoptr(FwupdDevice) dev_guid = fwupd_device_new();
 	g_autoptr(FwupdDevice) dev_new = fwupd_device_new();
 	g_autoptr(FwupdRelease) rel = NULL;
 	g_autoptr(GError) error = NULL;
@@ -951,6 +971,24 @@ fwupd_device_func(void)
 	g_assert_true(fwupd_device_has_guid(dev, "2082b5e0-7a64-478a-b1b2-e3404fab6dad"));
 	g_assert_true(fwupd_device_has_guid(dev, "00000000-0000-0000-0000-000000000000"));
 	g_assert_false(fwupd_device_has_guid(dev, "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"));
+	g_assert_true(fwupd_device_has_guid_raw(dev, &guid_raw1));
+	g_assert_false(fwupd_device_has_guid_raw(dev, &guid_raw2));
+
+	/* string lookups are exact, but the binary lookup compares the value */
+	g_assert_false(fwupd_device_has_guid(dev, "2082B5E0-7A64-478A-B1B2-E3404FAB6DAD"));
+	fwupd_device_add_guid(dev_guid, "2082B5E0-7A64-478A-B1B2-E3404FAB6DAD");
+	g_assert_true(fwupd_device_has_guid_raw(dev_guid, &guid_raw1));
+	fwupd_device_add_guid(dev_guid, "2082b5e0-7a64-478a-b1b2-e3404fab6dad");
+	g_assert_cmpint(fwupd_device_get_guids(dev_guid)->len, ==, 2);
+
+	/* truncated without using the API, then added again */
+	g_ptr_array_set_size(fwupd_device_get_guids(dev_guid), 1);
+	g_assert_true(fwupd_device_has_guid_raw(dev_guid, &guid_raw1));
+	g_ptr_array_set_size(fwupd_device_get_guids(dev_guid), 0);
+	g_assert_false(fwupd_device_has_guid_raw(dev_guid, &guid_raw1));
+	fwupd_device_add_guid(dev_guid, "00112233-0000-0000-0000-000000000000");
+	g_assert_false(fwupd_device_has_guid_raw(dev_guid, &guid_raw1));
+	g_assert_true(fwupd_device_has_guid_raw(dev_guid, &guid_raw2));
 
 	/* convert the new non-breaking space back into a normal space:
 	 * https://gitlab.gnome.org/GNOME/glib/commit/76af5dabb4a25956a6c41a75c0c7feeee74496da */
@@ -1284,6 +1322,18 @@ fwupd_common_guid_func(void)
 	guid3 = fwupd_guid_hash_data(msbuf, sizeof(msbuf), FWUPD_GUID_FLAG_NAMESPACE_MICROSOFT);
 	g_assert_cmpstr(guid3, ==, "6836cfac-f77a-527f-b375-4f92f01449c5");
 
+	/* make valid without formatting */
+	ret = fwupd_guid_hash_data_raw((const guint8 *)"python.org",
+				       strlen("python.org"),
+				       FWUPD_GUID_FLAG_NONE,
+				       &buf);
+	g_assert_true(ret);
+	g_assert_cmpint(memcmp(buf,
+			       "\x88\x63\x13\xe1\x3b\x8a\x53\x72\x9b\x90\x0c\x9a\xee\x19\x9e\x5d",
+			       sizeof(buf)),
+			==,
+			0);
+
 	/* round-trip BE */
 	ret = fwupd_guid_from_string("00112233-4455-6677-8899-aabbccddeeff",
 				     &buf,
@@ -1319,6 +1369,10 @@ fwupd_common_guid_func(void)
 	    fwupd_guid_from_string("001122334455-6677-8899-aabbccddeeff", NULL, 0, NULL));
 	g_assert_false(
 	    fwupd_guid_from_string("0112233-4455-6677-8899-aabbccddeeff", NULL, 0, NULL));
+	g_assert_false(
+	    fwupd_guid_from_string("0011223-34455-6677-8899-aabbccddeeff", NULL, 0, NULL));
+	g_assert_false(
+	    fwupd_guid_from_string("00112233-4455-6677-8899-aabbccddeefX", NULL, 0, NULL));
 }
 
 static gchar *
@@ -1633,6 +1687,317 @@ fwupd_bios_settings_func(void)
 	g_assert_true(ret);
 }
 
+#ifdef HAVE_LIBCURL
+static GSubprocess *
+fwupd_test_http_server_new(gchar **port, GError **error)
+{
+	g_autofree gchar *fn = NULL;
+	g_autofree gchar *python3 = g_find_program_in_path("python3");
+	g_autoptr(GDataInputStream) stream = NULL;
+	g_autoptr(GSubprocess) subprocess = NULL;
+
+	if (python3 == NULL) {
+		g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no python3");
+		return NULL;
+	}
+
+	/* the server prints the port it is listening on */
+	fn = g_test_build_filename(G_TEST_DIST, "tests", "http-server.py", NULL);
+	subprocess = g_subprocess_new(G_SUBPROCESS_FLAGS_STDOUT_PIPE, error, python3, fn, NULL);
+	if (subprocess == NULL)
+		return NULL;
+	stream = g_data_input_stream_new(g_subprocess_get_stdout_pipe(subprocess));
+	*port = g_data_input_stream_read_line(stream, NULL, NULL, error);
+	if (*port == NULL) {
+		g_subprocess_force_exit(subprocess);
+		return NULL;
+	}
+	return g_steal_pointer(&subprocess);
+}
+#endif
+
+static void
+fwupd_client_download_stream_func(void)
+{
+#ifdef HAVE_LIBCURL
+	gboolean ret;
+	g_autofree gchar *basename = NULL;
+	g_autofree gchar *csum = NULL;
+	g_autofree gchar *fn_part = NULL;
+	g_autofree gchar *fn_validator = NULL;
+	g_autofree gchar *port = NULL;
+	g_autofree gchar *url = NULL;
+	g_autoptr(FwupdClient) client = fwupd_client_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GSubprocess) subprocess = NULL;
+
+	subprocess = fwupd_test_http_server_new(&port, &error);
+	if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+		g_test_skip(error->message);
+		return;
+	}
+	g_assert_no_error(error);
+	g_assert_nonnull(subprocess);
+
+	/* a partial file from a different version of the file must not be resumed */
+	url = g_strdup_printf("http://127.0.0.1:%s/firmware.bin", port);
+	basename = g_compute_checksum_for_string(G_CHECKSUM_SHA256, url, -1);
+	fn_part = g_strdup_printf("%s/fwupd/downloads/%s.part", g_get_user_cache_dir(), basename);
+	fn_validator = g_strdup_printf("%s.validator", fn_part);
+	g_assert_cmpint(g_mkdir_with_parents("/tmp/fwupd-self-test/cache/fwupd/downloads", 0700),
+			==,
+			0);
+	ret = g_file_set_contents(fn_part, "stale", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(fn_validator, "\"stale\"", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the server hangs up every 300kB so the client has to resume */
+	fwupd_client_set_user_agent(client, "fwupd/" PACKAGE_VERSION);
+	blob = fwupd_client_download_bytes(client,
+					   url,
+					   FWUPD_CLIENT_DOWNLOAD_FLAG_STREAM,
+					   NULL,
+					   &error);
+	g_subprocess_force_exit(subprocess);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob);
+	g_assert_cmpint(g_bytes_get_size(blob), ==, 1024 * 1024);
+	csum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, blob);
+	g_assert_cmpstr(csum,
+			==,
+			"1f8647d4cd2f7594c35c413e582e01089c00929dd4239eddd5ded3d40f325d53");
+	g_assert_false(g_file_test(fn_part, G_FILE_TEST_EXISTS));
+	g_assert_false(g_file_test(fn_validator, G_FILE_TEST_EXISTS));
+#else
+	g_test_skip("no libcurl support");
+#endif
+}
+
+#ifdef HAVE_LIBCURL
+static void
+fwupd_test_download_firmware_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	GAsyncResult **result = (GAsyncResult **)user_data;
+	*result = g_object_ref(res);
+}
+
+static GBytes *
+fwupd_test_download_firmware(FwupdClient *client, const gchar *url, GError **error)
+{
+	g_autoptr(GAsyncResult) res = NULL;
+	g_autoptr(GPtrArray) urls = g_ptr_array_new_with_free_func(g_free);
+
+	g_ptr_array_add(urls, g_strdup(url));
+	fwupd_client_download_firmware_async(
+	    client,
+	    urls,
+	    "1f8647d4cd2f7594c35c413e582e01089c00929dd4239eddd5ded3d40f325d53",
+	    FWUPD_CLIENT_DOWNLOAD_FLAG_STREAM,
+	    NULL,
+	    fwupd_test_download_firmware_cb,
+	    &res);
+	while (res == NULL)
+		g_main_context_iteration(NULL, TRUE);
+	return fwupd_client_download_firmware_finish(client, res, error);
+}
+
+static gchar *
+fwupd_test_http_server_get_stats(FwupdClient *client, const gchar *port)
+{
+	g_autofree gchar *url = g_strdup_printf("http://127.0.0.1:%s/stats", port);
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+
+	blob =
+	    fwupd_client_download_bytes(client, url, FWUPD_CLIENT_DOWNLOAD_FLAG_NONE, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob);
+	return g_strndup(g_bytes_get_data(blob, NULL), g_bytes_get_size(blob));
+}
+#endif
+
+static void
+fwupd_client_firmware_cache_func(void)
+{
+#ifdef HAVE_LIBCURL
+	gboolean ret;
+	g_autofree gchar *basename = NULL;
+	g_autofree gchar *cachedir = NULL;
+	g_autofree gchar *fn = NULL;
+	g_autofree gchar *fn_old = NULL;
+	g_autofree gchar *fn_part = NULL;
+	g_autofree gchar *port = NULL;
+	g_autofree gchar *stats1 = NULL;
+	g_autofree gchar *stats2 = NULL;
+	g_autofree gchar *url = NULL;
+	g_autofree guint8 *buf = g_malloc0(1024 * 1024);
+	g_autoptr(FwupdClient) client = fwupd_client_new();
+	g_autoptr(GBytes) blob1 = NULL;
+	g_autoptr(GBytes) blob2 = NULL;
+	g_autoptr(GBytes) blob3 = NULL;
+	g_autoptr(GBytes) blob4 = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) file_old = NULL;
+	g_autoptr(GSubprocess) subprocess = NULL;
+
+	subprocess = fwupd_test_http_server_new(&port, &error);
+	if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+		g_test_skip(error->message);
+		return;
+	}
+	g_assert_no_error(error);
+	g_assert_nonnull(subprocess);
+	fwupd_client_set_user_agent(client, "fwupd/" PACKAGE_VERSION);
+	url = g_strdup_printf("http://127.0.0.1:%s/firmware.bin", port);
+	cachedir = g_build_filename(g_get_user_cache_dir(), "fwupd", "firmware", NULL);
+	fn = g_build_filename(cachedir,
+			      "1f8647d4cd2f7594c35c413e582e01089c00929dd4239eddd5ded3d40f325d53",
+			      NULL);
+	basename = g_compute_checksum_for_string(G_CHECKSUM_SHA256, url, -1);
+	fn_part = g_strdup_printf("%s/fwupd/downloads/%s.part", g_get_user_cache_dir(), basename);
+	(void)g_unlink(fn);
+
+	/* miss: the verified partial file is moved into the cache */
+	blob1 = fwupd_test_download_firmware(client, url, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob1);
+	g_assert_cmpint(fwupd_client_get_firmware_cache_hits(client), ==, 0);
+	g_assert_cmpint(fwupd_client_get_firmware_cache_bytes_saved(client), ==, 0);
+	g_assert_true(g_file_test(fn, G_FILE_TEST_EXISTS));
+	g_assert_false(g_file_test(fn_part, G_FILE_TEST_EXISTS));
+
+	/* hit: nothing is requested from the server */
+	stats1 = fwupd_test_http_server_get_stats(client, port);
+	blob2 = fwupd_test_download_firmware(client, url, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob2);
+	g_assert_cmpint(g_bytes_get_size(blob2), ==, 1024 * 1024);
+	g_assert_cmpint(fwupd_client_get_firmware_cache_hits(client), ==, 1);
+	g_assert_cmpint(fwupd_client_get_firmware_cache_bytes_saved(client), ==, 1024 * 1024);
+	stats2 = fwupd_test_http_server_get_stats(client, port);
+	g_assert_cmpstr(stats1, ==, stats2);
+
+	/* corrupt: the entry is ignored and downloaded again */
+	ret = g_file_set_contents(fn, "hello", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob3 = fwupd_test_download_firmware(client, url, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob3);
+	g_assert_cmpint(g_bytes_get_size(blob3), ==, 1024 * 1024);
+	g_assert_cmpint(fwupd_client_get_firmware_cache_hits(client), ==, 1);
+	g_assert_true(g_file_test(fn, G_FILE_TEST_EXISTS));
+
+	/* eviction: the least recently used entry is removed to make space */
+	fn_old = g_build_filename(cachedir, "0123456789abcdef", NULL);
+	ret = g_file_set_contents(fn_old, (const gchar *)buf, 1024 * 1024, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	file_old = g_file_new_for_path(fn_old);
+	ret = g_file_set_attribute_uint64(file_old,
+					  G_FILE_ATTRIBUTE_TIME_MODIFIED,
+					  1000,
+					  G_FILE_QUERY_INFO_NONE,
+					  NULL,
+					  &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fwupd_client_set_firmware_cache_size_max(client, 1536 * 1024);
+	g_assert_cmpint(g_unlink(fn), ==, 0);
+	blob4 = fwupd_test_download_firmware(client, url, &error);
+	g_subprocess_force_exit(subprocess);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob4);
+	g_assert_false(g_file_test(fn_old, G_FILE_TEST_EXISTS));
+	g_assert_true(g_file_test(fn, G_FILE_TEST_EXISTS));
+#else
+	g_test_skip("no libcurl support");
+#endif
+}
+
+static void
+fwupd_client_refresh_conditional_func(void)
+{
+#ifdef HAVE_LIBCURL
+	gboolean ret;
+	g_autofree gchar *conf = NULL;
+	g_autofree gchar *dirname = NULL;
+	g_autofree gchar *fn = NULL;
+	g_autofree gchar *port = NULL;
+	g_autofree gchar *stats = NULL;
+	g_autofree gchar *url = NULL;
+	g_autoptr(FwupdClient) client = fwupd_client_new();
+	g_autoptr(FwupdRemote) remote = fwupd_remote_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GSubprocess) subprocess = NULL;
+
+	subprocess = fwupd_test_http_server_new(&port, &error);
+	if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+		g_test_skip(error->message);
+		return;
+	}
+	g_assert_no_error(error);
+	g_assert_nonnull(subprocess);
+
+	/* a remote that already has the signature the server provides */
+	fn = g_build_filename("/tmp", "fwupd-self-test", "conditional.conf", NULL);
+	dirname = g_path_get_dirname(fn);
+	g_assert_cmpint(g_mkdir_with_parents(dirname, 0700), ==, 0);
+	conf = g_strdup_printf("[fwupd Remote]\n"
+			       "Enabled=true\n"
+			       "Keyring=gpg\n"
+			       "MetadataURI=http://127.0.0.1:%s/firmware.xml.gz\n",
+			       port);
+	ret = g_file_set_contents(fn, conf, -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fwupd_remote_set_remotes_dir(remote, "/tmp/fwupd-self-test/remotes.d");
+	ret = fwupd_remote_load_from_filename(remote, fn, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_free(dirname);
+	dirname = g_path_get_dirname(fwupd_remote_get_filename_cache_sig(remote));
+	g_assert_cmpint(g_mkdir_with_parents(dirname, 0700), ==, 0);
+	ret = g_file_set_contents(fwupd_remote_get_filename_cache_sig(remote),
+				  "SIGNATURE\n",
+				  -1,
+				  &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fwupd_remote_setup(remote, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the first refresh learns the ETag, the second is answered with 304 */
+	fwupd_client_set_user_agent(client, "fwupd/" PACKAGE_VERSION);
+	ret = fwupd_client_refresh_remote(client, remote, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fwupd_client_refresh_remote(client, remote, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fwupd_remote_get_age(remote), <, 60);
+	g_assert_true(g_file_test("/tmp/fwupd-self-test/cache/fwupd/validators/conditional.conf",
+				  G_FILE_TEST_EXISTS));
+
+	url = g_strdup_printf("http://127.0.0.1:%s/stats", port);
+	blob =
+	    fwupd_client_download_bytes(client, url, FWUPD_CLIENT_DOWNLOAD_FLAG_NONE, NULL, &error);
+	g_subprocess_force_exit(subprocess);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob);
+	stats = g_strndup(g_bytes_get_data(blob, NULL), g_bytes_get_size(blob));
+	g_assert_cmpstr(stats, ==, "200=1 304=1");
+#else
+	g_test_skip("no libcurl support");
+#endif
+}
+
 int
 main(int argc, char **argv)
 {
@@ -1643,6 +2008,7 @@ main(int argc, char **argv)
 	/* only critical and error are fatal */
 	g_log_set_fatal_mask(NULL, G_LOG_LEVEL_ERROR | G_LOG_LEVEL_CRITICAL);
 	(void)g_setenv("G_MESSAGES_DEBUG", "all", TRUE);
+	(void)g_setenv("XDG_CACHE_HOME", "/tmp/fwupd-self-test/cache", TRUE);
 
 	/* tests go here */
 	g_test_add_func("/fwupd/enums", fwupd_enums_func);
@@ -1662,6 +2028,9 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/remote{duplicate}", fwupd_remote_duplicate_func);
 	g_test_add_func("/fwupd/remote{auth}", fwupd_remote_auth_func);
 	g_test_add_func("/fwupd/bios-attrs", fwupd_bios_settings_func);
+	g_test_add_func("/fwupd/client{download-stream}", fwupd_client_download_stream_func);
+	g_test_add_func("/fwupd/client{refresh-conditional}", fwupd_client_refresh_conditional_func);
+	g_test_add_func("/fwupd/client{firmware-cache}", fwupd_client_firmware_cache_func);
 	if (fwupd_has_system_bus()) {
 		g_test_add_func("/fwupd/client{remotes}", fwupd_client_remotes_func);
 		g_test_add_func("/fwupd/client{devices}", fwupd_client_devices_func);
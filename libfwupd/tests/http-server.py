@@ -0,0 +1,110 @@
+#!/usr/bin/python3
+#
+# SPDX-License-Identifier: LGPL-2.1+
+#
+# pylint: disable=invalid-name,missing-docstring,consider-using-f-string
+#
+# A stand-in for the metadata and firmware servers:
+#
+#  /firmware.bin           honors "Range: bytes=N-" and If-Range but drops every
+#                          connection after a fixed number of body bytes, so that
+#                          the client has to resume the transfer several times
+#  /firmware.xml.gz.asc    honors If-None-Match and If-Modified-Since
+#  /stats                  the status codes returned so far, e.g. "200=1 304=1"
+
+import collections
+import os
+import re
+import sys
+from email.utils import formatdate
+from http.server import BaseHTTPRequestHandler, HTTPServer
+
+PAYLOAD = bytes((i * 7 + (i >> 8)) & 0xFF for i in range(1024 * 1024))
+PAYLOAD_ETAG = '"payload-{}"'.format(os.getpid())
+DROP_AFTER = 300 * 1024
+SIGNATURE = b"SIGNATURE\n"
+SIGNATURE_ETAG = '"{}"'.format(os.getpid())
+SIGNATURE_LAST_MODIFIED = formatdate(usegmt=True)
+STATS = collections.Counter()
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, format, *args):  # pylint: disable=redefined-builtin
+        sys.stderr.write(format % args + "\n")
+
+    def send_response(self, code, message=None):
+        if self.path != "/stats":
+            STATS[code] += 1
+        super().send_response(code, message)
+
+    def _send_blob(self, blob):
+        self.send_header("Content-Length", str(len(blob)))
+        self.end_headers()
+        self.wfile.write(blob)
+
+    def _get_firmware(self):
+        offset = 0
+        match = re.match(r"bytes=(\d+)-$", self.headers.get("Range", ""))
+        if self.headers.get("If-Range", PAYLOAD_ETAG) != PAYLOAD_ETAG:
+            match = None
+        if match:
+            offset = int(match.group(1))
+            if offset >= len(PAYLOAD):
+                self.send_response(416)
+                self.send_header("Content-Range", "bytes */{}".format(len(PAYLOAD)))
+                self._send_blob(b"")
+                return
+            self.send_response(206)
+            self.send_header(
+                "Content-Range",
+                "bytes {}-{}/{}".format(offset, len(PAYLOAD) - 1, len(PAYLOAD)),
+            )
+        else:
+            self.send_response(200)
+        self.send_header("ETag", PAYLOAD_ETAG)
+        self.send_header("Content-Length", str(len(PAYLOAD) - offset))
+        self.end_headers()
+
+        # send a chunk then hang up without finishing the response
+        self.wfile.write(PAYLOAD[offset : offset + DROP_AFTER])
+        self.wfile.flush()
+        self.close_connection = True
+
+    def _get_signature(self):
+        # If-None-Match takes precedence when both are sent
+        if "If-None-Match" in self.headers:
+            not_modified = self.headers["If-None-Match"] == SIGNATURE_ETAG
+        else:
+            not_modified = self.headers.get("If-Modified-Since") == SIGNATURE_LAST_MODIFIED
+        if not_modified:
+            self.send_response(304)
+            self.send_header("ETag", SIGNATURE_ETAG)
+            self.end_headers()
+            return
+        self.send_response(200)
+        self.send_header("ETag", SIGNATURE_ETAG)
+        self.send_header("Last-Modified", SIGNATURE_LAST_MODIFIED)
+        self._send_blob(SIGNATURE)
+
+    def do_GET(self):
+        if self.path == "/firmware.bin":
+            self._get_firmware()
+        elif self.path == "/firmware.xml.gz.asc":
+            self._get_signature()
+        elif self.path == "/stats":
+            self.send_response(200)
+            self._send_blob(
+                " ".join(
+                    "{}={}".format(code, STATS[code]) for code in sorted(STATS)
+                ).encode()
+            )
+        else:
+            self.send_error(404)
+
+
+if __name__ == "__main__":
+    httpd = HTTPServer(("127.0.0.1", 0), Handler)
+    print(httpd.server_address[1], flush=True)
+    httpd.serve_forever()
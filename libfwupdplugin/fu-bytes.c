@@ -9,7 +9,10 @@
 #include "config.h"
 
 #ifdef HAVE_GIO_UNIX
+#include <fcntl.h>
 #include <gio/gunixinputstream.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #include "fwupd-error.h"
@@ -88,6 +91,9 @@ fu_bytes_get_contents(const gchar *filename, GError **error)
  *
  * Reads a blob from a specific file descriptor.
  *
+ * A memfd sealed against shrinking and writing is mapped read-only rather than copied, and
+ * any other regular file is read from the current offset using a single allocation.
+ *
  * Note: this will close the fd when done
  *
  * Returns: (transfer full): a #GBytes, or %NULL
@@ -98,6 +104,7 @@ GBytes *
 fu_bytes_get_contents_fd(gint fd, gsize count, GError **error)
 {
 #ifdef HAVE_GIO_UNIX
+	struct stat st = {0};
 	g_autoptr(GInputStream) stream = NULL;
 
 	g_return_val_if_fail(fd > 0, NULL);
@@ -105,6 +112,63 @@ fu_bytes_get_contents_fd(gint fd, gsize count, GError **error)
 
 	/* read the entire fd to a data blob */
 	stream = g_unix_input_stream_new(fd, TRUE);
+
+	/* pipes and sockets have no known size */
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+		off_t offset = lseek(fd, 0, SEEK_CUR);
+		gsize bufsz = 0;
+		gsize datasz;
+		g_autofree guint8 *buf = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		/* only what is left after the current offset is read */
+		if (offset < 0 || offset > st.st_size)
+			return fu_bytes_get_contents_stream(stream, count, error);
+		datasz = (gsize)(st.st_size - offset);
+		if ((guint64)datasz > count) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "cannot read from fd: %" G_GUINT64_FORMAT
+				    " > %" G_GUINT64_FORMAT,
+				    (guint64)datasz,
+				    (guint64)count);
+			return NULL;
+		}
+
+#ifdef F_GET_SEALS
+		/* the contents cannot change, so it is safe to use the pages directly -- an
+		 * unsealed file could be truncated by the client while we are using it */
+		{
+			const gint seals_required = F_SEAL_SHRINK | F_SEAL_WRITE;
+			gint seals = fcntl(fd, F_GET_SEALS);
+			if (seals >= 0 && (seals & seals_required) == seals_required) {
+				g_autoptr(GBytes) blob_mapped = NULL;
+				g_autoptr(GMappedFile) mapped_file = NULL;
+				mapped_file = g_mapped_file_new_from_fd(fd, FALSE, &error_local);
+				if (mapped_file != NULL) {
+					blob_mapped = g_mapped_file_get_bytes(mapped_file);
+					return g_bytes_new_from_bytes(blob_mapped, offset, datasz);
+				}
+				g_debug("failed to map sealed fd: %s", error_local->message);
+				g_clear_error(&error_local);
+			}
+		}
+#endif
+
+		/* read the file in one go */
+		if (datasz == 0)
+			return g_bytes_new(NULL, 0);
+		buf = g_malloc(datasz);
+		if (!g_input_stream_read_all(stream, buf, datasz, &bufsz, NULL, &error_local)) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INVALID_FILE,
+					    error_local->message);
+			return NULL;
+		}
+		return g_bytes_new_take(g_steal_pointer(&buf), bufsz);
+	}
 	return fu_bytes_get_contents_stream(stream, count, error);
 #else
 	g_set_error_literal(error,
@@ -356,3 +420,139 @@ fu_bytes_get_data_safe(GBytes *bytes, gsize *bufsz, GError **error)
 	}
 	return buf;
 }
+
+/* large enough to amortize the per-update overhead, small enough that the chunk is still in
+ * the L2 cache when it is fed to the next digest */
+#define FU_BYTES_CHECKSUM_CHUNK_SIZE 0x10000
+
+static const GChecksumType fu_bytes_checksum_types[] = {G_CHECKSUM_SHA1,
+							G_CHECKSUM_SHA256,
+							G_CHECKSUM_SHA384,
+							G_CHECKSUM_SHA512};
+
+typedef struct {
+	GBytes *bytes;	 /* owned */
+	GBytes *wrapper; /* not owned, the #GBytes handed to the caller */
+	GMutex mutex;
+	gchar *checksums[G_N_ELEMENTS(fu_bytes_checksum_types)];
+} FuBytesChecksums;
+
+static GMutex fu_bytes_checksums_mutex;
+static GHashTable *fu_bytes_checksums = NULL; /* GBytes -> FuBytesChecksums */
+
+static void
+fu_bytes_checksums_free(gpointer user_data)
+{
+	FuBytesChecksums *item = (FuBytesChecksums *)user_data;
+
+	/* the wrapper is being destroyed, so it cannot be looked up again */
+	g_mutex_lock(&fu_bytes_checksums_mutex);
+	g_hash_table_remove(fu_bytes_checksums, item->wrapper);
+	g_mutex_unlock(&fu_bytes_checksums_mutex);
+
+	for (guint i = 0; i < G_N_ELEMENTS(item->checksums); i++)
+		g_free(item->checksums[i]);
+	g_mutex_clear(&item->mutex);
+	g_bytes_unref(item->bytes);
+	g_free(item);
+}
+
+static void
+fu_bytes_checksums_compute(FuBytesChecksums *item)
+{
+	gsize bufsz = 0;
+	const guint8 *buf = g_bytes_get_data(item->bytes, &bufsz);
+	GChecksum *csums[G_N_ELEMENTS(fu_bytes_checksum_types)] = {NULL};
+
+	for (guint i = 0; i < G_N_ELEMENTS(fu_bytes_checksum_types); i++)
+		csums[i] = g_checksum_new(fu_bytes_checksum_types[i]);
+
+	/* feed each chunk to every digest while it is still hot in the cache */
+	for (gsize offset = 0; offset < bufsz; offset += FU_BYTES_CHECKSUM_CHUNK_SIZE) {
+		gsize chunksz = MIN(bufsz - offset, FU_BYTES_CHECKSUM_CHUNK_SIZE);
+		for (guint i = 0; i < G_N_ELEMENTS(csums); i++)
+			g_checksum_update(csums[i], buf + offset, (gssize)chunksz);
+	}
+	for (guint i = 0; i < G_N_ELEMENTS(csums); i++) {
+		item->checksums[i] = g_strdup(g_checksum_get_string(csums[i]));
+		g_checksum_free(csums[i]);
+	}
+}
+
+/**
+ * fu_bytes_new_with_checksums:
+ * @bytes: data blob
+ *
+ * Creates a #GBytes with the same contents as @bytes which caches the checksums returned
+ * by fu_bytes_get_checksum(). The SHA1, SHA256, SHA384 and SHA512 digests are all
+ * calculated in a single pass over the data the first time any of them is requested.
+ *
+ * This is useful when a large archive is hashed several times during one request.
+ *
+ * Returns: (transfer full): a #GBytes
+ *
+ * Since: 1.8.14
+ **/
+GBytes *
+fu_bytes_new_with_checksums(GBytes *bytes)
+{
+	FuBytesChecksums *item;
+	gsize bufsz = 0;
+	const guint8 *buf;
+
+	g_return_val_if_fail(bytes != NULL, NULL);
+
+	item = g_new0(FuBytesChecksums, 1);
+	item->bytes = g_bytes_ref(bytes);
+	g_mutex_init(&item->mutex);
+	buf = g_bytes_get_data(bytes, &bufsz);
+	item->wrapper = g_bytes_new_with_free_func(buf, bufsz, fu_bytes_checksums_free, item);
+
+	g_mutex_lock(&fu_bytes_checksums_mutex);
+	if (fu_bytes_checksums == NULL)
+		fu_bytes_checksums = g_hash_table_new(g_direct_hash, g_direct_equal);
+	g_hash_table_insert(fu_bytes_checksums, item->wrapper, item);
+	g_mutex_unlock(&fu_bytes_checksums_mutex);
+	return item->wrapper;
+}
+
+/**
+ * fu_bytes_get_checksum:
+ * @bytes: data blob
+ * @checksum_type: a #GChecksumType, e.g. %G_CHECKSUM_SHA256
+ *
+ * Gets the checksum of the blob. If @bytes was created using fu_bytes_new_with_checksums()
+ * then the result is cached for the lifetime of the blob.
+ *
+ * Returns: (transfer full): a lowercase hexadecimal checksum
+ *
+ * Since: 1.8.14
+ **/
+gchar *
+fu_bytes_get_checksum(GBytes *bytes, GChecksumType checksum_type)
+{
+	FuBytesChecksums *item = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(bytes != NULL, NULL);
+
+	/* the caller holds a reference, so the item cannot be freed under us */
+	g_mutex_lock(&fu_bytes_checksums_mutex);
+	if (fu_bytes_checksums != NULL)
+		item = g_hash_table_lookup(fu_bytes_checksums, bytes);
+	g_mutex_unlock(&fu_bytes_checksums_mutex);
+	if (item == NULL)
+		return g_compute_checksum_for_bytes(checksum_type, bytes);
+
+	locker = g_mutex_locker_new(&item->mutex);
+	for (guint i = 0; i < G_N_ELEMENTS(fu_bytes_checksum_types); i++) {
+		if (fu_bytes_checksum_types[i] != checksum_type)
+			continue;
+		if (item->checksums[i] == NULL)
+			fu_bytes_checksums_compute(item);
+		return g_strdup(item->checksums[i]);
+	}
+
+	/* not cached */
+	return g_compute_checksum_for_bytes(checksum_type, bytes);
+}
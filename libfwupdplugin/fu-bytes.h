@@ -33,3 +33,7 @@ fu_bytes_pad(GBytes *bytes, gsize sz);
 GBytes *
 fu_bytes_new_offset(GBytes *bytes, gsize offset, gsize length, GError **error)
     G_GNUC_WARN_UNUSED_RESULT;
+GBytes *
+fu_bytes_new_with_checksums(GBytes *bytes);
+gchar *
+fu_bytes_get_checksum(GBytes *bytes, GChecksumType checksum_type);
@@ -15,6 +15,7 @@
 #include "fwupd-enums.h"
 #include "fwupd-error.h"
 
+#include "fu-bytes.h"
 #include "fu-cabinet.h"
 #include "fu-common.h"
 #include "fu-string.h"
@@ -1097,8 +1098,8 @@ fu_cabinet_parse(FuCabinet *self, GBytes *data, FuCabinetParseFlags flags, GErro
 		return FALSE;
 
 	/* build xmlb silo */
-	self->container_checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA1, data);
-	self->container_checksum_alt = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, data);
+	self->container_checksum = fu_bytes_get_checksum(data, G_CHECKSUM_SHA1);
+	self->container_checksum_alt = fu_bytes_get_checksum(data, G_CHECKSUM_SHA256);
 	if (!fu_cabinet_build_silo(self, data, error))
 		return FALSE;
 
@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2023 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define G_LOG_DOMAIN "FuChunk"
+
+#include "config.h"
+
+#include "fu-chunk-view.h"
+
+/**
+ * FuChunkView:
+ *
+ * A lazy view of a linear blob of memory split into packets.
+ *
+ * Unlike fu_chunk_array_new_from_bytes() no objects or memory are allocated for each packet;
+ * the offset, page and address of each packet is calculated only when required.
+ *
+ * See also: [class@FuChunk]
+ */
+
+struct _FuChunkView {
+	GObject parent_instance;
+	GBytes *blob;
+	guint32 addr_start;
+	guint32 page_sz;
+	guint32 packet_sz;  /* G_MAXUINT32 if only split by page */
+	guint32 first_sz;   /* bytes up to the end of the first page */
+	guint first_len;    /* packets in the first page */
+	guint per_page_len; /* packets in each page after the first */
+	guint len;
+};
+
+G_DEFINE_TYPE(FuChunkView, fu_chunk_view, G_TYPE_OBJECT)
+
+static guint
+fu_chunk_view_count_packets(guint32 sz, guint32 packet_sz)
+{
+	return (guint)(((guint64)sz + packet_sz - 1) / packet_sz);
+}
+
+/* returns the offset into the blob for the start of the packet */
+static gsize
+fu_chunk_view_get_offset(FuChunkView *self, guint idx)
+{
+	guint idx_page;
+	if (idx < self->first_len)
+		return (gsize)idx * self->packet_sz;
+	idx_page = idx - self->first_len;
+	return (gsize)self->first_sz + (gsize)(idx_page / self->per_page_len) * self->page_sz +
+	       (gsize)(idx_page % self->per_page_len) * self->packet_sz;
+}
+
+/**
+ * fu_chunk_view_length:
+ * @self: a #FuChunkView
+ *
+ * Gets the number of packets in the view.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.14
+ **/
+guint
+fu_chunk_view_length(FuChunkView *self)
+{
+	g_return_val_if_fail(FU_IS_CHUNK_VIEW(self), 0);
+	return self->len;
+}
+
+/**
+ * fu_chunk_view_get_page:
+ * @self: a #FuChunkView
+ * @idx: the packet index, starting at 0
+ *
+ * Gets the hardware page of the packet.
+ *
+ * Returns: page number, or %G_MAXUINT32 if @idx is invalid
+ *
+ * Since: 1.8.14
+ **/
+guint32
+fu_chunk_view_get_page(FuChunkView *self, guint idx)
+{
+	gsize offset_last;
+
+	g_return_val_if_fail(FU_IS_CHUNK_VIEW(self), G_MAXUINT32);
+	g_return_val_if_fail(idx < self->len, G_MAXUINT32);
+
+	if (self->page_sz == 0)
+		return 0;
+
+	/* like fu_chunk_array_new() this is the page of the last byte in the packet, where
+	 * the first byte is always counted as part of the page after it */
+	offset_last = fu_chunk_view_get_offset(self, idx) + fu_chunk_view_get_data_sz(self, idx) - 1;
+	if (offset_last == 0 && g_bytes_get_size(self->blob) > 1)
+		offset_last = 1;
+	return (self->addr_start + (guint32)offset_last) / self->page_sz;
+}
+
+/**
+ * fu_chunk_view_get_address:
+ * @self: a #FuChunkView
+ * @idx: the packet index, starting at 0
+ *
+ * Gets the address of the packet *within* the page.
+ *
+ * Returns: address, or %G_MAXUINT32 if @idx is invalid
+ *
+ * Since: 1.8.14
+ **/
+guint32
+fu_chunk_view_get_address(FuChunkView *self, guint idx)
+{
+	guint32 address;
+	g_return_val_if_fail(FU_IS_CHUNK_VIEW(self), G_MAXUINT32);
+	g_return_val_if_fail(idx < self->len, G_MAXUINT32);
+	address = self->addr_start + (guint32)fu_chunk_view_get_offset(self, idx);
+	if (self->page_sz > 0)
+		address %= self->page_sz;
+	return address;
+}
+
+/**
+ * fu_chunk_view_get_data:
+ * @self: a #FuChunkView
+ * @idx: the packet index, starting at 0
+ *
+ * Gets the data of the packet, which is only valid for the lifetime of @self.
+ *
+ * Returns: (nullable): data
+ *
+ * Since: 1.8.14
+ **/
+const guint8 *
+fu_chunk_view_get_data(FuChunkView *self, guint idx)
+{
+	const guint8 *buf;
+	g_return_val_if_fail(FU_IS_CHUNK_VIEW(self), NULL);
+	g_return_val_if_fail(idx < self->len, NULL);
+	buf = g_bytes_get_data(self->blob, NULL);
+	if (buf == NULL)
+		return NULL;
+	return buf + fu_chunk_view_get_offset(self, idx);
+}
+
+/**
+ * fu_chunk_view_get_data_sz:
+ * @self: a #FuChunkView
+ * @idx: the packet index, starting at 0
+ *
+ * Gets the size of the packet.
+ *
+ * Returns: size in bytes, or 0 if @idx is invalid
+ *
+ * Since: 1.8.14
+ **/
+guint32
+fu_chunk_view_get_data_sz(FuChunkView *self, guint idx)
+{
+	gsize offset;
+	gsize offset_next;
+	g_return_val_if_fail(FU_IS_CHUNK_VIEW(self), 0);
+	g_return_val_if_fail(idx < self->len, 0);
+	offset = fu_chunk_view_get_offset(self, idx);
+	if (idx + 1 < self->len)
+		offset_next = fu_chunk_view_get_offset(self, idx + 1);
+	else
+		offset_next = g_bytes_get_size(self->blob);
+	return (guint32)(offset_next - offset);
+}
+
+/**
+ * fu_chunk_view_get_bytes:
+ * @self: a #FuChunkView
+ * @idx: the packet index, starting at 0
+ *
+ * Gets the data of the packet, referencing the blob used to create @self.
+ *
+ * Returns: (transfer full): a #GBytes, or %NULL if @idx is invalid
+ *
+ * Since: 1.8.14
+ **/
+GBytes *
+fu_chunk_view_get_bytes(FuChunkView *self, guint idx)
+{
+	g_return_val_if_fail(FU_IS_CHUNK_VIEW(self), NULL);
+	g_return_val_if_fail(idx < self->len, NULL);
+	return g_bytes_new_from_bytes(self->blob,
+				      fu_chunk_view_get_offset(self, idx),
+				      fu_chunk_view_get_data_sz(self, idx));
+}
+
+/**
+ * fu_chunk_view_index:
+ * @self: a #FuChunkView
+ * @idx: the packet index, starting at 0
+ *
+ * Creates a #FuChunk for a specific packet, which can be useful when porting code that
+ * used fu_chunk_array_new_from_bytes().
+ *
+ * Returns: (transfer full): a #FuChunk, or %NULL if @idx is invalid
+ *
+ * Since: 1.8.14
+ **/
+FuChunk *
+fu_chunk_view_index(FuChunkView *self, guint idx)
+{
+	FuChunk *chk;
+	g_autoptr(GBytes) blob = NULL;
+
+	g_return_val_if_fail(FU_IS_CHUNK_VIEW(self), NULL);
+	g_return_val_if_fail(idx < self->len, NULL);
+
+	blob = fu_chunk_view_get_bytes(self, idx);
+	chk = fu_chunk_bytes_new(blob);
+	fu_chunk_set_idx(chk, idx);
+	fu_chunk_set_page(chk, fu_chunk_view_get_page(self, idx));
+	fu_chunk_set_address(chk, fu_chunk_view_get_address(self, idx));
+	return chk;
+}
+
+static void
+fu_chunk_view_finalize(GObject *object)
+{
+	FuChunkView *self = FU_CHUNK_VIEW(object);
+	g_bytes_unref(self->blob);
+	G_OBJECT_CLASS(fu_chunk_view_parent_class)->finalize(object);
+}
+
+static void
+fu_chunk_view_class_init(FuChunkViewClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_chunk_view_finalize;
+}
+
+static void
+fu_chunk_view_init(FuChunkView *self)
+{
+}
+
+/**
+ * fu_chunk_view_new:
+ * @blob: data
+ * @addr_start: the hardware address offset, or 0
+ * @page_sz: the hardware page size, or 0
+ * @packet_sz: the transfer size, or 0
+ *
+ * Chunks a linear blob of memory into packets, ensuring each packet does not
+ * cross a page boundary and is no larger than a specific transfer size.
+ *
+ * Returns: (transfer full): a #FuChunkView
+ *
+ * Since: 1.8.14
+ **/
+FuChunkView *
+fu_chunk_view_new(GBytes *blob, guint32 addr_start, guint32 page_sz, guint32 packet_sz)
+{
+	FuChunkView *self;
+	guint32 bufsz;
+
+	g_return_val_if_fail(blob != NULL, NULL);
+
+	self = g_object_new(FU_TYPE_CHUNK_VIEW, NULL);
+	self->blob = g_bytes_ref(blob);
+	self->addr_start = addr_start;
+	self->page_sz = page_sz;
+	bufsz = (guint32)g_bytes_get_size(blob);
+	if (bufsz == 0)
+		return self;
+
+	/* a page of zero is the same as the entire blob */
+	if (page_sz == 0) {
+		self->packet_sz = packet_sz > 0 ? packet_sz : bufsz;
+		self->first_sz = bufsz;
+		self->first_len = fu_chunk_view_count_packets(bufsz, self->packet_sz);
+		self->per_page_len = 1;
+		self->len = self->first_len;
+		return self;
+	}
+
+	/* the first page may be partial, all the others are full apart from the last -- to
+	 * match fu_chunk_array_new() a first page of just one byte is merged into the next */
+	self->packet_sz = packet_sz > 0 ? packet_sz : G_MAXUINT32;
+	self->first_sz = page_sz - (addr_start % page_sz);
+	if (self->first_sz == 1 && bufsz > 1)
+		self->first_sz += page_sz;
+	self->first_sz = MIN(self->first_sz, bufsz);
+	self->first_len = fu_chunk_view_count_packets(self->first_sz, self->packet_sz);
+	self->per_page_len = fu_chunk_view_count_packets(page_sz, self->packet_sz);
+	self->len = self->first_len +
+		    ((bufsz - self->first_sz) / page_sz) * self->per_page_len +
+		    fu_chunk_view_count_packets((bufsz - self->first_sz) % page_sz, self->packet_sz);
+	return self;
+}
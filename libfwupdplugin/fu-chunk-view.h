@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2023 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include "fu-chunk.h"
+
+#define FU_TYPE_CHUNK_VIEW (fu_chunk_view_get_type())
+
+G_DECLARE_FINAL_TYPE(FuChunkView, fu_chunk_view, FU, CHUNK_VIEW, GObject)
+
+FuChunkView *
+fu_chunk_view_new(GBytes *blob, guint32 addr_start, guint32 page_sz, guint32 packet_sz);
+guint
+fu_chunk_view_length(FuChunkView *self);
+guint32
+fu_chunk_view_get_page(FuChunkView *self, guint idx);
+guint32
+fu_chunk_view_get_address(FuChunkView *self, guint idx);
+const guint8 *
+fu_chunk_view_get_data(FuChunkView *self, guint idx);
+guint32
+fu_chunk_view_get_data_sz(FuChunkView *self, guint idx);
+GBytes *
+fu_chunk_view_get_bytes(FuChunkView *self, guint idx);
+FuChunk *
+fu_chunk_view_index(FuChunkView *self, guint idx);
@@ -8,8 +8,24 @@
 
 #include "config.h"
 
+#include "fwupd-common.h"
+
 #include "fu-common-guid.h"
 
+/* the same instance IDs are hashed for each replug, child and emulation reload */
+#define FU_COMMON_GUID_CACHE_SIZE 2048
+
+typedef struct {
+	gchar *str;
+	gchar *guid;
+} FuCommonGuidCacheItem;
+
+static GMutex fu_common_guid_cache_mutex;
+static GHashTable *fu_common_guid_cache = NULL; /* str -> GList link of FuCommonGuidCacheItem */
+static GQueue fu_common_guid_cache_lru = G_QUEUE_INIT; /* most recently used first */
+static guint fu_common_guid_cache_hits = 0;
+static guint fu_common_guid_cache_misses = 0;
+
 /**
  * fu_common_guid_is_plausible:
  * @buf: a buffer of data
@@ -33,3 +49,142 @@ fu_common_guid_is_plausible(const guint8 *buf)
 		return FALSE;
 	return TRUE;
 }
+
+static void
+fu_common_guid_cache_item_free(FuCommonGuidCacheItem *item)
+{
+	g_free(item->str);
+	g_free(item->guid);
+	g_free(item);
+}
+
+/* called with the mutex held */
+static gchar *
+fu_common_guid_cache_lookup(const gchar *str)
+{
+	FuCommonGuidCacheItem *item;
+	GList *link;
+
+	if (fu_common_guid_cache == NULL)
+		return NULL;
+	link = g_hash_table_lookup(fu_common_guid_cache, str);
+	if (link == NULL)
+		return NULL;
+
+	/* make it the most recently used */
+	g_queue_unlink(&fu_common_guid_cache_lru, link);
+	g_queue_push_head_link(&fu_common_guid_cache_lru, link);
+	item = link->data;
+	return g_strdup(item->guid);
+}
+
+/**
+ * fu_common_guid_clear_cache:
+ *
+ * Frees all the GUIDs cached by fu_common_guid_hash_string(). This is safe to call at any
+ * time, and should be called by the daemon and tools before exiting.
+ *
+ * Since: 1.8.14
+ **/
+void
+fu_common_guid_clear_cache(void)
+{
+	FuCommonGuidCacheItem *item;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_common_guid_cache_mutex);
+
+	while ((item = g_queue_pop_head(&fu_common_guid_cache_lru)) != NULL)
+		fu_common_guid_cache_item_free(item);
+	g_clear_pointer(&fu_common_guid_cache, g_hash_table_unref);
+}
+
+/**
+ * fu_common_guid_hash_string:
+ * @str: (nullable): a source string to use as a key, e.g. `USB\VID_273F&PID_1004`
+ *
+ * Returns a GUID for a given string, in the same way as fwupd_guid_hash_string().
+ *
+ * The most recently used GUIDs are kept in a process-wide cache so that instance IDs that are
+ * added again, for instance when the device is replugged, do not have to be hashed again.
+ *
+ * Returns: a new GUID, or %NULL if the string was invalid
+ *
+ * Since: 1.8.14
+ **/
+gchar *
+fu_common_guid_hash_string(const gchar *str)
+{
+	FuCommonGuidCacheItem *item;
+	gchar *guid;
+	g_autofree gchar *guid_new = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	if (str == NULL || str[0] == '\0')
+		return NULL;
+
+	/* already hashed */
+	locker = g_mutex_locker_new(&fu_common_guid_cache_mutex);
+	guid = fu_common_guid_cache_lookup(str);
+	if (guid != NULL) {
+		fu_common_guid_cache_hits++;
+		return guid;
+	}
+	fu_common_guid_cache_misses++;
+	g_clear_pointer(&locker, g_mutex_locker_free);
+
+	/* do not block other threads while hashing */
+	guid_new = fwupd_guid_hash_string(str);
+	if (guid_new == NULL)
+		return NULL;
+
+	/* another thread may have added it in the meantime */
+	locker = g_mutex_locker_new(&fu_common_guid_cache_mutex);
+	if (fu_common_guid_cache == NULL)
+		fu_common_guid_cache = g_hash_table_new(g_str_hash, g_str_equal);
+	if (g_hash_table_contains(fu_common_guid_cache, str))
+		return g_steal_pointer(&guid_new);
+
+	/* evict the least recently used */
+	if (g_queue_get_length(&fu_common_guid_cache_lru) >= FU_COMMON_GUID_CACHE_SIZE) {
+		item = g_queue_pop_tail(&fu_common_guid_cache_lru);
+		g_hash_table_remove(fu_common_guid_cache, item->str);
+		fu_common_guid_cache_item_free(item);
+	}
+	item = g_new0(FuCommonGuidCacheItem, 1);
+	item->str = g_strdup(str);
+	item->guid = g_strdup(guid_new);
+	g_queue_push_head(&fu_common_guid_cache_lru, item);
+	g_hash_table_insert(fu_common_guid_cache, item->str, fu_common_guid_cache_lru.head);
+	return g_steal_pointer(&guid_new);
+}
+
+/**
+ * fu_common_guid_get_cache_hits:
+ *
+ * Gets the number of fu_common_guid_hash_string() calls that did not need to hash the string.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.14
+ **/
+guint
+fu_common_guid_get_cache_hits(void)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_common_guid_cache_mutex);
+	return fu_common_guid_cache_hits;
+}
+
+/**
+ * fu_common_guid_get_cache_misses:
+ *
+ * Gets the number of fu_common_guid_hash_string() calls that hashed the string.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.14
+ **/
+guint
+fu_common_guid_get_cache_misses(void)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_common_guid_cache_mutex);
+	return fu_common_guid_cache_misses;
+}
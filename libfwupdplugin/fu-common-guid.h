@@ -10,3 +10,11 @@
 
 gboolean
 fu_common_guid_is_plausible(const guint8 *buf);
+gchar *
+fu_common_guid_hash_string(const gchar *str);
+guint
+fu_common_guid_get_cache_hits(void);
+guint
+fu_common_guid_get_cache_misses(void);
+void
+fu_common_guid_clear_cache(void);
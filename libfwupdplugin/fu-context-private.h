@@ -53,5 +53,7 @@ FuSmbios *
 fu_context_get_smbios(FuContext *self);
 FuHwids *
 fu_context_get_hwids(FuContext *self);
+FuQuirks *
+fu_context_get_quirks(FuContext *self);
 void
 fu_context_set_chassis_kind(FuContext *self, FuSmbiosChassisKind chassis_kind);
@@ -148,6 +148,24 @@ fu_context_get_smbios(FuContext *self)
 	return priv->smbios;
 }
 
+/**
+ * fu_context_get_quirks:
+ * @self: a #FuContext
+ *
+ * Gets the quirks store.
+ *
+ * Returns: (transfer none): a #FuQuirks
+ *
+ * Since: 1.8.14
+ **/
+FuQuirks *
+fu_context_get_quirks(FuContext *self)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CONTEXT(self), NULL);
+	return priv->quirks;
+}
+
 /**
  * fu_context_get_hwids:
  * @self: a #FuContext
@@ -10,6 +10,91 @@
 
 #include "fu-crc.h"
 
+/*
+ * The tables are built the first time each polynomial is used and then kept for the lifetime
+ * of the process; only a handful of different polynomials are ever used by plugins.
+ */
+typedef struct {
+	guint32 polynomial;
+	guint8 width;
+	gpointer table;
+} FuCrcTableItem;
+
+static GMutex fu_crc_tables_mutex;
+static GArray *fu_crc_tables = NULL; /* (element-type FuCrcTableItem) */
+
+static gpointer
+fu_crc8_table_new(guint8 polynomial)
+{
+	guint8 *table = g_new0(guint8, 256);
+	for (guint i = 0; i < 256; i++) {
+		guint8 crc = (guint8)i;
+		for (guint j = 0; j < 8; j++)
+			crc = (crc & 0x80) ? (guint8)((crc << 1) ^ polynomial) : (guint8)(crc << 1);
+		table[i] = crc;
+	}
+	return table;
+}
+
+static gpointer
+fu_crc16_table_new(guint16 polynomial)
+{
+	guint16 *table = g_new0(guint16, 256);
+	for (guint i = 0; i < 256; i++) {
+		guint16 crc = (guint16)i;
+		for (guint j = 0; j < 8; j++)
+			crc = (crc & 0x1) ? (guint16)((crc >> 1) ^ polynomial) : (guint16)(crc >> 1);
+		table[i] = crc;
+	}
+	return table;
+}
+
+/* eight tables so that 8 bytes can be processed in each iteration, aka slice-by-8 */
+static gpointer
+fu_crc32_table_new(guint32 polynomial)
+{
+	guint32 *table = g_new0(guint32, 8 * 256);
+	for (guint i = 0; i < 256; i++) {
+		guint32 crc = i;
+		for (guint j = 0; j < 8; j++)
+			crc = (crc >> 1) ^ (polynomial & -(crc & 1));
+		table[i] = crc;
+	}
+	for (guint i = 0; i < 256; i++) {
+		for (guint k = 1; k < 8; k++) {
+			guint32 crc = table[(k - 1) * 256 + i];
+			table[k * 256 + i] = (crc >> 8) ^ table[crc & 0xFF];
+		}
+	}
+	return table;
+}
+
+static gconstpointer
+fu_crc_get_table(guint8 width, guint32 polynomial)
+{
+	FuCrcTableItem item = {.polynomial = polynomial, .width = width};
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_crc_tables_mutex);
+
+	/* already built */
+	if (fu_crc_tables == NULL)
+		fu_crc_tables = g_array_new(FALSE, FALSE, sizeof(FuCrcTableItem));
+	for (guint i = 0; i < fu_crc_tables->len; i++) {
+		FuCrcTableItem *item_tmp = &g_array_index(fu_crc_tables, FuCrcTableItem, i);
+		if (item_tmp->width == width && item_tmp->polynomial == polynomial)
+			return item_tmp->table;
+	}
+
+	/* build and cache */
+	if (width == 8)
+		item.table = fu_crc8_table_new((guint8)polynomial);
+	else if (width == 16)
+		item.table = fu_crc16_table_new((guint16)polynomial);
+	else
+		item.table = fu_crc32_table_new(polynomial);
+	g_array_append_val(fu_crc_tables, item);
+	return item.table;
+}
+
 /**
  * fu_crc8_full:
  * @buf: memory buffer
@@ -26,16 +111,17 @@
 guint8
 fu_crc8_full(const guint8 *buf, gsize bufsz, guint8 crc_init, guint8 polynomial)
 {
-	guint32 crc = crc_init;
-	for (gsize j = bufsz; j > 0; j--) {
-		crc ^= (*(buf++) << 8);
-		for (guint32 i = 8; i; i--) {
-			if (crc & 0x8000)
-				crc ^= ((polynomial | 0x100) << 7);
-			crc <<= 1;
-		}
-	}
-	return ~((guint8)(crc >> 8));
+	const guint8 *table;
+	guint8 crc;
+
+	/* the initial value is only mixed in after the first byte */
+	if (bufsz == 0)
+		return 0xFF;
+	table = fu_crc_get_table(8, polynomial);
+	crc = table[buf[0]] ^ crc_init;
+	for (gsize i = 1; i < bufsz; i++)
+		crc = table[crc ^ buf[i]];
+	return ~crc;
 }
 
 /**
@@ -71,16 +157,9 @@ fu_crc8(const guint8 *buf, gsize bufsz)
 guint16
 fu_crc16_full(const guint8 *buf, gsize bufsz, guint16 crc, guint16 polynomial)
 {
-	for (gsize len = bufsz; len > 0; len--) {
-		crc = (guint16)(crc ^ (*buf++));
-		for (guint8 i = 0; i < 8; i++) {
-			if (crc & 0x1) {
-				crc = (crc >> 1) ^ polynomial;
-			} else {
-				crc >>= 1;
-			}
-		}
-	}
+	const guint16 *table = fu_crc_get_table(16, polynomial);
+	for (gsize i = 0; i < bufsz; i++)
+		crc = (crc >> 8) ^ table[(crc ^ buf[i]) & 0xFF];
 	return ~crc;
 }
 
@@ -117,14 +196,22 @@ fu_crc16(const guint8 *buf, gsize bufsz)
 guint32
 fu_crc32_full(const guint8 *buf, gsize bufsz, guint32 crc, guint32 polynomial)
 {
-	for (guint32 idx = 0; idx < bufsz; idx++) {
-		guint8 data = *buf++;
-		crc = crc ^ data;
-		for (guint32 bit = 0; bit < 8; bit++) {
-			guint32 mask = -(crc & 1);
-			crc = (crc >> 1) ^ (polynomial & mask);
-		}
+	const guint32 *table = fu_crc_get_table(32, polynomial);
+	gsize i = 0;
+
+	/* eight bytes at a time, built up bytewise so this works on any endian */
+	for (; i + 8 <= bufsz; i += 8) {
+		guint32 lo = crc ^ ((guint32)buf[i + 0] | (guint32)buf[i + 1] << 8 |
+				    (guint32)buf[i + 2] << 16 | (guint32)buf[i + 3] << 24);
+		crc = table[7 * 256 + (lo & 0xFF)] ^ table[6 * 256 + ((lo >> 8) & 0xFF)] ^
+		      table[5 * 256 + ((lo >> 16) & 0xFF)] ^ table[4 * 256 + (lo >> 24)] ^
+		      table[3 * 256 + buf[i + 4]] ^ table[2 * 256 + buf[i + 5]] ^
+		      table[1 * 256 + buf[i + 6]] ^ table[0 * 256 + buf[i + 7]];
 	}
+
+	/* any remaining bytes */
+	for (; i < bufsz; i++)
+		crc = (crc >> 8) ^ table[(crc ^ buf[i]) & 0xFF];
 	return ~crc;
 }
 
@@ -52,6 +52,8 @@ void
 fu_device_add_possible_plugin(FuDevice *self, const gchar *plugin);
 guint
 fu_device_get_request_cnt(FuDevice *self, FwupdRequestKind request_kind);
+guint
+fu_device_get_identity_generation(FuDevice *self);
 guint64
 fu_device_get_private_flags(FuDevice *self);
 void
@@ -14,6 +14,7 @@
 #include "fwupd-common.h"
 #include "fwupd-device-private.h"
 
+#include "fu-common-guid.h"
 #include "fu-common.h"
 #include "fu-device-private.h"
 #include "fu-mutex.h"
@@ -83,8 +84,12 @@ typedef struct {
 	gchar *custom_flags;
 	gulong notify_flags_handler_id;
 	GHashTable *instance_hash;
+	guint identity_generation; /* atomic */
 } FuDevicePrivate;
 
+/* used to make the identity generation of each device unique */
+static gint fu_device_identity_generation = 0;
+
 typedef struct {
 	GQuark domain;
 	gint code;
@@ -108,13 +113,55 @@ enum {
 	PROP_LAST
 };
 
-enum { SIGNAL_CHILD_ADDED, SIGNAL_CHILD_REMOVED, SIGNAL_REQUEST, SIGNAL_LAST };
+enum {
+	SIGNAL_CHILD_ADDED,
+	SIGNAL_CHILD_REMOVED,
+	SIGNAL_REQUEST,
+	SIGNAL_IDENTITY_CHANGED,
+	SIGNAL_LAST
+};
 
 static guint signals[SIGNAL_LAST] = {0};
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuDevice, fu_device, FWUPD_TYPE_DEVICE)
 #define GET_PRIVATE(o) (fu_device_get_instance_private(o))
 
+static void
+fu_device_identity_generation_bump(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	gint generation = g_atomic_int_add(&fu_device_identity_generation, 1) + 1;
+	g_atomic_int_set((gint *)&priv->identity_generation, generation);
+}
+
+static void
+fu_device_identity_changed(FuDevice *self)
+{
+	fu_device_identity_generation_bump(self);
+	g_signal_emit(self, signals[SIGNAL_IDENTITY_CHANGED], 0);
+}
+
+/**
+ * fu_device_get_identity_generation:
+ * @self: a #FuDevice
+ *
+ * Gets a number that changes every time the device ID, equivalent ID, GUIDs, physical ID
+ * or logical ID are modified. The value is unique across all devices in the process.
+ *
+ * This allows callers to cache lookups using these properties.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.14
+ **/
+guint
+fu_device_get_identity_generation(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_DEVICE(self), 0);
+	return (guint)g_atomic_int_get((gint *)&priv->identity_generation);
+}
+
 static void
 fu_device_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
 {
@@ -1008,6 +1055,7 @@ fu_device_set_equivalent_id(FuDevice *self, const gchar *equivalent_id)
 
 	g_free(priv->equivalent_id);
 	priv->equivalent_id = g_strdup(equivalent_id);
+	fu_device_identity_changed(self);
 }
 
 /**
@@ -1529,7 +1577,7 @@ fu_device_add_parent_guid(FuDevice *self, const gchar *guid)
 
 	/* make valid */
 	if (!fwupd_guid_is_valid(guid)) {
-		g_autofree gchar *tmp = fwupd_guid_hash_string(guid);
+		g_autofree gchar *tmp = fu_common_guid_hash_string(guid);
 		if (fu_device_has_parent_guid(self, tmp))
 			return;
 		g_debug("using %s for %s", tmp, guid);
@@ -2073,8 +2121,10 @@ fu_device_add_guid_safe(FuDevice *self, const gchar *guid, FuDeviceInstanceFlags
 {
 	/* add the device GUID before adding additional GUIDs from quirks
 	 * to ensure the bootloader GUID is listed after the runtime GUID */
-	if (flags & FU_DEVICE_INSTANCE_FLAG_VISIBLE)
+	if (flags & FU_DEVICE_INSTANCE_FLAG_VISIBLE) {
 		fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+		fu_device_identity_changed(self);
+	}
 	if (flags & FU_DEVICE_INSTANCE_FLAG_QUIRKS)
 		fu_device_add_guid_quirks(self, guid);
 }
@@ -2084,7 +2134,8 @@ fu_device_add_guid_safe(FuDevice *self, const gchar *guid, FuDeviceInstanceFlags
  * @self: a #FuDevice
  * @guid: a GUID, e.g. `WacomAES`
  *
- * Finds out if the device has a specific GUID.
+ * Finds out if the device has a specific GUID. If @guid is not a valid GUID then it is
+ * hashed into one first. The GUID strings are compared exactly, so the case must match.
  *
  * Returns: %TRUE if the GUID is found
  *
@@ -2093,16 +2144,34 @@ fu_device_add_guid_safe(FuDevice *self, const gchar *guid, FuDeviceInstanceFlags
 gboolean
 fu_device_has_guid(FuDevice *self, const gchar *guid)
 {
+	fwupd_guid_t guid_raw;
+
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(guid != NULL, FALSE);
 
-	/* make valid */
+	/* make valid, without formatting it as a string */
 	if (!fwupd_guid_is_valid(guid)) {
-		g_autofree gchar *tmp = fwupd_guid_hash_string(guid);
+		g_autofree gchar *tmp = NULL;
+		if (guid[0] == '\0')
+			return FALSE;
+		if (!fwupd_guid_hash_data_raw((const guint8 *)guid,
+					      strlen(guid),
+					      FWUPD_GUID_FLAG_NONE,
+					      &guid_raw))
+			return FALSE;
+		if (!fwupd_device_has_guid_raw(FWUPD_DEVICE(self), &guid_raw))
+			return FALSE;
+
+		/* the value matches, but the string might be in a different case */
+		tmp = fwupd_guid_to_string(&guid_raw, FWUPD_GUID_FLAG_NONE);
 		return fwupd_device_has_guid(FWUPD_DEVICE(self), tmp);
 	}
 
-	/* already valid */
+	/* already valid, so only compare the strings when the value matches */
+	if (!fwupd_guid_from_string(guid, &guid_raw, FWUPD_GUID_FLAG_NONE, NULL))
+		return FALSE;
+	if (!fwupd_device_has_guid_raw(FWUPD_DEVICE(self), &guid_raw))
+		return FALSE;
 	return fwupd_device_has_guid(FWUPD_DEVICE(self), guid);
 }
 
@@ -2161,7 +2230,7 @@ fu_device_add_instance_id_full(FuDevice *self,
 	 * calling fu_device_add_guid_safe() -- but we want the quirks to match
 	 * so the plugin is set, but not the LVFS metadata to match firmware
 	 * until we're sure the device isn't using _NO_AUTO_INSTANCE_IDS */
-	guid = fwupd_guid_hash_string(instance_id);
+	guid = fu_common_guid_hash_string(instance_id);
 	if (flags & FU_DEVICE_INSTANCE_FLAG_QUIRKS)
 		fu_device_add_guid_quirks(self, guid);
 	if (flags & FU_DEVICE_INSTANCE_FLAG_VISIBLE)
@@ -2173,8 +2242,10 @@ fu_device_add_instance_id_full(FuDevice *self,
 		fu_device_add_instance_id_quirk(self, instance_id);
 
 	/* already done by ->setup(), so this must be ->registered() */
-	if (priv->done_setup)
+	if (priv->done_setup) {
 		fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+		fu_device_identity_changed(self);
+	}
 }
 
 /**
@@ -2267,13 +2338,15 @@ fu_device_add_counterpart_guid(FuDevice *self, const gchar *guid)
 
 	/* make valid */
 	if (!fwupd_guid_is_valid(guid)) {
-		g_autofree gchar *tmp = fwupd_guid_hash_string(guid);
+		g_autofree gchar *tmp = fu_common_guid_hash_string(guid);
 		fwupd_device_add_guid(FWUPD_DEVICE(self), tmp);
+		fu_device_identity_changed(self);
 		return;
 	}
 
 	/* already valid */
 	fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+	fu_device_identity_changed(self);
 }
 
 /**
@@ -2620,6 +2693,7 @@ fu_device_set_id(FuDevice *self, const gchar *id)
 	}
 	fwupd_device_set_id(FWUPD_DEVICE(self), id_hash);
 	priv->device_id_valid = TRUE;
+	fu_device_identity_changed(self);
 
 	/* ensure the parent ID is set */
 	children = fu_device_get_children(self);
@@ -3228,6 +3302,7 @@ fu_device_set_logical_id(FuDevice *self, const gchar *logical_id)
 	g_free(priv->logical_id);
 	priv->logical_id = g_strdup(logical_id);
 	priv->device_id_valid = FALSE;
+	fu_device_identity_changed(self);
 	g_object_notify(G_OBJECT(self), "logical-id");
 }
 
@@ -3403,6 +3478,7 @@ fu_device_set_physical_id(FuDevice *self, const gchar *physical_id)
 	g_free(priv->physical_id);
 	priv->physical_id = g_strdup(physical_id);
 	priv->device_id_valid = FALSE;
+	fu_device_identity_changed(self);
 	g_object_notify(G_OBJECT(self), "physical-id");
 }
 
@@ -4801,7 +4877,7 @@ fu_device_rescan(FuDevice *self, GError **error)
 
 	/* remove all GUIDs */
 	g_ptr_array_set_size(fu_device_get_instance_ids(self), 0);
-	g_ptr_array_set_size(fu_device_get_guids(self), 0);
+	fwupd_device_remove_guids(FWUPD_DEVICE(self));
 
 	/* subclassed */
 	if (klass->rescan != NULL) {
@@ -4863,9 +4939,10 @@ fu_device_convert_instance_ids(FuDevice *self)
 	instance_ids = fwupd_device_get_instance_ids(FWUPD_DEVICE(self));
 	for (guint i = 0; i < instance_ids->len; i++) {
 		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
-		g_autofree gchar *guid = fwupd_guid_hash_string(instance_id);
+		g_autofree gchar *guid = fu_common_guid_hash_string(instance_id);
 		fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
 	}
+	fu_device_identity_changed(self);
 }
 
 /**
@@ -5223,6 +5300,7 @@ fu_device_incorporate(FuDevice *self, FuDevice *donor)
 
 	/* now the base class, where all the interesting bits are */
 	fwupd_device_incorporate(FWUPD_DEVICE(self), FWUPD_DEVICE(donor));
+	fu_device_identity_changed(self);
 
 	/* set by the superclass */
 	if (fu_device_get_id(self) != NULL)
@@ -5235,7 +5313,7 @@ fu_device_incorporate(FuDevice *self, FuDevice *donor)
 	/* call the set_quirk_kv() vfunc for the superclassed object */
 	for (guint i = 0; i < instance_ids->len; i++) {
 		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
-		g_autofree gchar *guid = fwupd_guid_hash_string(instance_id);
+		g_autofree gchar *guid = fu_common_guid_hash_string(instance_id);
 		fu_device_add_guid_quirks(self, guid);
 	}
 }
@@ -6005,6 +6083,24 @@ fu_device_class_init(FuDeviceClass *klass)
 					       G_TYPE_NONE,
 					       1,
 					       FWUPD_TYPE_REQUEST);
+	/**
+	 * FuDevice::identity-changed:
+	 * @self: the #FuDevice instance that emitted the signal
+	 *
+	 * The ::identity-changed signal is emitted when the device ID, equivalent ID, GUIDs,
+	 * physical ID or logical ID have been modified.
+	 *
+	 * Since: 1.8.14
+	 **/
+	signals[SIGNAL_IDENTITY_CHANGED] = g_signal_new("identity-changed",
+							G_TYPE_FROM_CLASS(object_class),
+							G_SIGNAL_RUN_LAST,
+							0,
+							NULL,
+							NULL,
+							g_cclosure_marshal_VOID__VOID,
+							G_TYPE_NONE,
+							0);
 
 	/**
 	 * FuDevice:physical-id:
@@ -6102,6 +6198,7 @@ fu_device_init(FuDevice *self)
 	priv->retry_recs = g_ptr_array_new_with_free_func(g_free);
 	priv->instance_hash = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	priv->acquiesce_delay = 50; /* ms */
+	fu_device_identity_generation_bump(self);
 	priv->notify_flags_handler_id = g_signal_connect(FWUPD_DEVICE(self),
 							 "notify::flags",
 							 G_CALLBACK(fu_device_flags_notify_cb),
@@ -42,6 +42,8 @@ fu_ifd_firmware_export(FuFirmware *firmware, FuFirmwareExportFlags flags, XbBuil
 	}
 }
 
+static const guint8 fu_efi_firmware_volume_magic[] = {'_', 'F', 'V', 'H'};
+
 static gboolean
 fu_efi_firmware_volume_check_magic(FuFirmware *firmware, GBytes *fw, gsize offset, GError **error)
 {
@@ -269,6 +271,9 @@ fu_efi_firmware_volume_class_init(FuEfiFirmwareVolumeClass *klass)
 {
 	FuFirmwareClass *klass_firmware = FU_FIRMWARE_CLASS(klass);
 	klass_firmware->check_magic = fu_efi_firmware_volume_check_magic;
+	klass_firmware->magic = fu_efi_firmware_volume_magic;
+	klass_firmware->magicsz = sizeof(fu_efi_firmware_volume_magic);
+	klass_firmware->magic_offset = FU_STRUCT_EFI_VOLUME_OFFSET_SIGNATURE;
 	klass_firmware->parse = fu_efi_firmware_volume_parse;
 	klass_firmware->write = fu_efi_firmware_volume_write;
 	klass_firmware->export = fu_ifd_firmware_export;
@@ -320,6 +320,8 @@ fu_fdt_firmware_parse_mem_rsvmap(FuFdtFirmware *self,
 	return TRUE;
 }
 
+static const guint8 fu_fdt_firmware_magic[] = {0xD0, 0x0D, 0xFE, 0xED};
+
 static gboolean
 fu_fdt_firmware_check_magic(FuFirmware *firmware, GBytes *fw, gsize offset, GError **error)
 {
@@ -585,6 +587,9 @@ fu_fdt_firmware_class_init(FuFdtFirmwareClass *klass)
 {
 	FuFirmwareClass *klass_firmware = FU_FIRMWARE_CLASS(klass);
 	klass_firmware->check_magic = fu_fdt_firmware_check_magic;
+	klass_firmware->magic = fu_fdt_firmware_magic;
+	klass_firmware->magicsz = sizeof(fu_fdt_firmware_magic);
+	klass_firmware->magic_offset = FU_STRUCT_FDT_OFFSET_MAGIC;
 	klass_firmware->export = fu_fdt_firmware_export;
 	klass_firmware->parse = fu_fdt_firmware_parse;
 	klass_firmware->write = fu_fdt_firmware_write;
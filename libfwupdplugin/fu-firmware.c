@@ -40,6 +40,8 @@ typedef struct {
 	gsize size;
 	GPtrArray *chunks;  /* nullable, element-type FuChunk */
 	GPtrArray *patches; /* nullable, element-type FuFirmwarePatch */
+	GHashTable *image_checksums; /* nullable, checksum:FuFirmware (noref) */
+	guint image_checksum_kinds;  /* bitfield of 1 << GChecksumType */
 } FuFirmwarePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuFirmware, fu_firmware, G_TYPE_OBJECT)
@@ -407,6 +409,19 @@ fu_firmware_get_parent(FuFirmware *self)
 	return priv->parent;
 }
 
+/* the images have changed, so any checksums need computing again -- the checksum of this
+ * firmware may also be written from the images, so do the same for all the ancestors */
+static void
+fu_firmware_invalidate_image_checksums(FuFirmware *self)
+{
+	for (FuFirmware *firmware = self; firmware != NULL;
+	     firmware = fu_firmware_get_parent(firmware)) {
+		FuFirmwarePrivate *priv = GET_PRIVATE(firmware);
+		g_clear_pointer(&priv->image_checksums, g_hash_table_unref);
+		priv->image_checksum_kinds = 0;
+	}
+}
+
 /**
  * fu_firmware_set_parent:
  * @self: a #FuFirmware
@@ -526,6 +541,10 @@ fu_firmware_set_bytes(FuFirmware *self, GBytes *bytes)
 	if (priv->bytes != NULL)
 		g_bytes_unref(priv->bytes);
 	priv->bytes = g_bytes_ref(bytes);
+
+	/* the checksum of this image may have changed */
+	if (priv->parent != NULL)
+		fu_firmware_invalidate_image_checksums(priv->parent);
 }
 
 /**
@@ -842,6 +861,34 @@ fu_firmware_check_magic_for_offset(FuFirmware *self,
 		return TRUE;
 	}
 
+	/* only check the offsets where the fixed magic bytes are found */
+	if (klass->magic != NULL) {
+		gsize bufsz = 0;
+		const guint8 *buf = g_bytes_get_data(fw, &bufsz);
+		for (gsize pos = *offset + klass->magic_offset; pos + klass->magicsz <= bufsz;) {
+			gsize offset_found = 0;
+			if (!fu_memmem_safe(buf + pos,
+					    bufsz - pos,
+					    klass->magic,
+					    klass->magicsz,
+					    &offset_found,
+					    NULL))
+				break;
+			pos += offset_found;
+			if (klass->check_magic(self, fw, pos - klass->magic_offset, NULL)) {
+				fu_firmware_set_offset(self, pos - klass->magic_offset);
+				*offset = pos - klass->magic_offset;
+				return TRUE;
+			}
+			pos++;
+		}
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "did not find magic");
+		return FALSE;
+	}
+
 	/* increment the offset, looking for the magic */
 	for (gsize offset_tmp = *offset; offset_tmp < g_bytes_get_size(fw); offset_tmp++) {
 		if (klass->check_magic(self, fw, offset_tmp, NULL)) {
@@ -1292,6 +1339,10 @@ fu_firmware_add_patch(FuFirmware *self, gsize offset, GBytes *blob)
 	g_return_if_fail(FU_IS_FIRMWARE(self));
 	g_return_if_fail(blob != NULL);
 
+	/* the checksum of this image will change */
+	if (priv->parent != NULL)
+		fu_firmware_invalidate_image_checksums(priv->parent);
+
 	/* ensure exists */
 	if (priv->patches == NULL) {
 		priv->patches =
@@ -1454,6 +1505,7 @@ fu_firmware_add_image(FuFirmware *self, FuFirmware *img)
 	}
 
 	g_ptr_array_add(priv->images, g_object_ref(img));
+	fu_firmware_invalidate_image_checksums(self);
 
 	/* set the other way around */
 	fu_firmware_set_parent(img, self);
@@ -1480,8 +1532,10 @@ fu_firmware_remove_image(FuFirmware *self, FuFirmware *img, GError **error)
 	g_return_val_if_fail(FU_IS_FIRMWARE(img), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
-	if (g_ptr_array_remove(priv->images, img))
+	if (g_ptr_array_remove(priv->images, img)) {
+		fu_firmware_invalidate_image_checksums(self);
 		return TRUE;
+	}
 
 	/* did not exist */
 	g_set_error(error,
@@ -1517,6 +1571,7 @@ fu_firmware_remove_image_by_idx(FuFirmware *self, guint64 idx, GError **error)
 	if (img == NULL)
 		return FALSE;
 	g_ptr_array_remove(priv->images, img);
+	fu_firmware_invalidate_image_checksums(self);
 	return TRUE;
 }
 
@@ -1545,6 +1600,7 @@ fu_firmware_remove_image_by_id(FuFirmware *self, const gchar *id, GError **error
 	if (img == NULL)
 		return FALSE;
 	g_ptr_array_remove(priv->images, img);
+	fu_firmware_invalidate_image_checksums(self);
 	return TRUE;
 }
 
@@ -1661,6 +1717,52 @@ fu_firmware_get_image_by_idx(FuFirmware *self, guint64 idx, GError **error)
 	return NULL;
 }
 
+/* the checksum length is different for each kind, so one table works for all of them */
+static void
+fu_firmware_ensure_image_checksums(FuFirmware *self, GChecksumType csum_kind)
+{
+	FuFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GHashTable) image_checksums = NULL;
+
+	/* already done */
+	if (priv->image_checksum_kinds & (1u << csum_kind))
+		return;
+
+	/* if this expensive then the subclassed FuFirmware can cache the result as required */
+	image_checksums = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	for (guint i = 0; i < priv->images->len; i++) {
+		FuFirmware *img = g_ptr_array_index(priv->images, i);
+		g_autoptr(GError) error_local = NULL;
+		gchar *checksum = fu_firmware_get_checksum(img, csum_kind, &error_local);
+
+		/* an image without a checksum cannot match, but the others still might */
+		if (checksum == NULL) {
+			g_debug("ignoring image %u: %s", i, error_local->message);
+			continue;
+		}
+		if (g_hash_table_contains(image_checksums, checksum)) {
+			g_free(checksum);
+			continue;
+		}
+		g_hash_table_insert(image_checksums, checksum, img);
+	}
+
+	/* merge in, keeping any other kinds */
+	if (priv->image_checksums == NULL) {
+		priv->image_checksums = g_steal_pointer(&image_checksums);
+	} else {
+		GHashTableIter iter;
+		gpointer key;
+		gpointer value;
+		g_hash_table_iter_init(&iter, image_checksums);
+		while (g_hash_table_iter_next(&iter, &key, &value)) {
+			g_hash_table_iter_steal(&iter);
+			g_hash_table_insert(priv->image_checksums, key, value);
+		}
+	}
+	priv->image_checksum_kinds |= 1u << csum_kind;
+}
+
 /**
  * fu_firmware_get_image_by_checksum:
  * @self: a #FuPlugin
@@ -1678,6 +1780,7 @@ FuFirmware *
 fu_firmware_get_image_by_checksum(FuFirmware *self, const gchar *checksum, GError **error)
 {
 	FuFirmwarePrivate *priv = GET_PRIVATE(self);
+	FuFirmware *img;
 	GChecksumType csum_kind;
 
 	g_return_val_if_fail(FU_IS_FIRMWARE(self), NULL);
@@ -1685,18 +1788,10 @@ fu_firmware_get_image_by_checksum(FuFirmware *self, const gchar *checksum, GErro
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
 	csum_kind = fwupd_checksum_guess_kind(checksum);
-	for (guint i = 0; i < priv->images->len; i++) {
-		FuFirmware *img = g_ptr_array_index(priv->images, i);
-		g_autofree gchar *checksum_tmp = NULL;
-
-		/* if this expensive then the subclassed FuFirmware can
-		 * cache the result as required */
-		checksum_tmp = fu_firmware_get_checksum(img, csum_kind, error);
-		if (checksum_tmp == NULL)
-			return NULL;
-		if (g_strcmp0(checksum_tmp, checksum) == 0)
-			return g_object_ref(img);
-	}
+	fu_firmware_ensure_image_checksums(self, csum_kind);
+	img = g_hash_table_lookup(priv->image_checksums, checksum);
+	if (img != NULL)
+		return g_object_ref(img);
 	g_set_error(error,
 		    FWUPD_ERROR,
 		    FWUPD_ERROR_NOT_FOUND,
@@ -1922,6 +2017,8 @@ fu_firmware_finalize(GObject *object)
 		g_ptr_array_unref(priv->chunks);
 	if (priv->patches != NULL)
 		g_ptr_array_unref(priv->patches);
+	if (priv->image_checksums != NULL)
+		g_hash_table_unref(priv->image_checksums);
 	if (priv->parent != NULL)
 		g_object_remove_weak_pointer(G_OBJECT(priv->parent), (gpointer *)&priv->parent);
 	g_ptr_array_unref(priv->images);
@@ -67,6 +67,11 @@ struct _FuFirmwareClass {
 				     FuFirmware *other,
 				     FwupdInstallFlags flags,
 				     GError **error);
+	/* optional fixed bytes found at @magic_offset into the image, used to find candidate
+	 * offsets quickly when searching -- ->check_magic is still used to verify each one */
+	const guint8 *magic;
+	gsize magicsz;
+	gsize magic_offset;
 };
 
 /**
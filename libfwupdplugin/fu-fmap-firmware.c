@@ -24,6 +24,8 @@
 
 G_DEFINE_TYPE(FuFmapFirmware, fu_fmap_firmware, FU_TYPE_FIRMWARE)
 
+static const guint8 fu_fmap_firmware_magic[] = {'_', '_', 'F', 'M', 'A', 'P', '_', '_'};
+
 static gboolean
 fu_fmap_firmware_check_magic(FuFirmware *firmware, GBytes *fw, gsize offset, GError **error)
 {
@@ -181,6 +183,9 @@ fu_fmap_firmware_class_init(FuFmapFirmwareClass *klass)
 {
 	FuFirmwareClass *klass_firmware = FU_FIRMWARE_CLASS(klass);
 	klass_firmware->check_magic = fu_fmap_firmware_check_magic;
+	klass_firmware->magic = fu_fmap_firmware_magic;
+	klass_firmware->magicsz = sizeof(fu_fmap_firmware_magic);
+	klass_firmware->magic_offset = FU_STRUCT_FMAP_OFFSET_SIGNATURE;
 	klass_firmware->parse = fu_fmap_firmware_parse;
 	klass_firmware->write = fu_fmap_firmware_write;
 }
@@ -97,6 +97,8 @@ fu_ifd_firmware_export(FuFirmware *firmware, FuFirmwareExportFlags flags, XbBuil
 	}
 }
 
+static const guint8 fu_ifd_firmware_magic[] = {0x5A, 0xA5, 0xF0, 0x0F}; /* FU_IFD_SIGNATURE */
+
 static gboolean
 fu_ifd_firmware_check_magic(FuFirmware *firmware, GBytes *fw, gsize offset, GError **error)
 {
@@ -494,6 +496,9 @@ fu_ifd_firmware_class_init(FuIfdFirmwareClass *klass)
 	FuFirmwareClass *klass_firmware = FU_FIRMWARE_CLASS(klass);
 	object_class->finalize = fu_ifd_firmware_finalize;
 	klass_firmware->check_magic = fu_ifd_firmware_check_magic;
+	klass_firmware->magic = fu_ifd_firmware_magic;
+	klass_firmware->magicsz = sizeof(fu_ifd_firmware_magic);
+	klass_firmware->magic_offset = FU_IFD_FDBAR_SIGNATURE;
 	klass_firmware->export = fu_ifd_firmware_export;
 	klass_firmware->parse = fu_ifd_firmware_parse;
 	klass_firmware->write = fu_ifd_firmware_write;
@@ -123,6 +123,8 @@ fu_ifwi_cpd_firmware_parse_manifest(FuFirmware *firmware, GBytes *fw, GError **e
 	return TRUE;
 }
 
+static const guint8 fu_ifwi_cpd_firmware_magic[] = {'$', 'C', 'P', 'D'};
+
 static gboolean
 fu_ifwi_cpd_firmware_check_magic(FuFirmware *firmware, GBytes *fw, gsize offset, GError **error)
 {
@@ -319,6 +321,9 @@ fu_ifwi_cpd_firmware_class_init(FuIfwiCpdFirmwareClass *klass)
 {
 	FuFirmwareClass *klass_firmware = FU_FIRMWARE_CLASS(klass);
 	klass_firmware->check_magic = fu_ifwi_cpd_firmware_check_magic;
+	klass_firmware->magic = fu_ifwi_cpd_firmware_magic;
+	klass_firmware->magicsz = sizeof(fu_ifwi_cpd_firmware_magic);
+	klass_firmware->magic_offset = FU_STRUCT_IFWI_CPD_OFFSET_HEADER_MARKER;
 	klass_firmware->export = fu_ifwi_cpd_firmware_export;
 	klass_firmware->parse = fu_ifwi_cpd_firmware_parse;
 	klass_firmware->write = fu_ifwi_cpd_firmware_write;
@@ -35,6 +35,8 @@ G_DEFINE_TYPE(FuIfwiFptFirmware, fu_ifwi_fpt_firmware, FU_TYPE_FIRMWARE)
 #define FU_IFWI_FPT_ENTRY_VERSION  0x10
 #define FU_IFWI_FPT_MAX_ENTRIES	   56
 
+static const guint8 fu_ifwi_fpt_firmware_magic[] = {'$', 'F', 'P', 'T'};
+
 static gboolean
 fu_ifwi_fpt_firmware_check_magic(FuFirmware *firmware, GBytes *fw, gsize offset, GError **error)
 {
@@ -181,6 +183,9 @@ fu_ifwi_fpt_firmware_class_init(FuIfwiFptFirmwareClass *klass)
 {
 	FuFirmwareClass *klass_firmware = FU_FIRMWARE_CLASS(klass);
 	klass_firmware->check_magic = fu_ifwi_fpt_firmware_check_magic;
+	klass_firmware->magic = fu_ifwi_fpt_firmware_magic;
+	klass_firmware->magicsz = sizeof(fu_ifwi_fpt_firmware_magic);
+	klass_firmware->magic_offset = FU_STRUCT_IFWI_FPT_OFFSET_HEADER_MARKER;
 	klass_firmware->parse = fu_ifwi_fpt_firmware_parse;
 	klass_firmware->write = fu_ifwi_fpt_firmware_write;
 }
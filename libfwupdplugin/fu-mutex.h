@@ -47,3 +47,26 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC(GRWLockWriterLocker, g_rw_lock_writer_locker_free)
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GRWLockReaderLocker, g_rw_lock_reader_locker_free)
 
 #endif
+
+#if !GLIB_CHECK_VERSION(2, 60, 0)
+
+/* Backported GRecMutex autoptr support for older glib versions */
+
+typedef void GRecMutexLocker;
+
+static inline GRecMutexLocker *
+g_rec_mutex_locker_new(GRecMutex *rec_mutex)
+{
+	g_rec_mutex_lock(rec_mutex);
+	return (GRecMutexLocker *)rec_mutex;
+}
+
+static inline void
+g_rec_mutex_locker_free(GRecMutexLocker *locker)
+{
+	g_rec_mutex_unlock((GRecMutex *)locker);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GRecMutexLocker, g_rec_mutex_locker_free)
+
+#endif
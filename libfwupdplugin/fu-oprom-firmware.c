@@ -102,6 +102,8 @@ fu_oprom_firmware_export(FuFirmware *firmware, FuFirmwareExportFlags flags, XbBu
 	fu_xmlb_builder_insert_kx(bn, "compression_type", priv->compression_type);
 }
 
+static const guint8 fu_oprom_firmware_magic[] = {0x55, 0xAA};
+
 static gboolean
 fu_oprom_firmware_check_magic(FuFirmware *firmware, GBytes *fw, gsize offset, GError **error)
 {
@@ -288,6 +290,9 @@ fu_oprom_firmware_class_init(FuOpromFirmwareClass *klass)
 {
 	FuFirmwareClass *klass_firmware = FU_FIRMWARE_CLASS(klass);
 	klass_firmware->check_magic = fu_oprom_firmware_check_magic;
+	klass_firmware->magic = fu_oprom_firmware_magic;
+	klass_firmware->magicsz = sizeof(fu_oprom_firmware_magic);
+	klass_firmware->magic_offset = FU_STRUCT_OPROM_OFFSET_SIGNATURE;
 	klass_firmware->export = fu_oprom_firmware_export;
 	klass_firmware->parse = fu_oprom_firmware_parse;
 	klass_firmware->write = fu_oprom_firmware_write;
@@ -27,6 +27,8 @@
 
 G_DEFINE_TYPE(FuPefileFirmware, fu_pefile_firmware, FU_TYPE_FIRMWARE)
 
+static const guint8 fu_pefile_firmware_magic[] = {'M', 'Z'};
+
 static gboolean
 fu_pefile_firmware_check_magic(FuFirmware *firmware, GBytes *fw, gsize offset, GError **error)
 {
@@ -195,6 +197,9 @@ fu_pefile_firmware_class_init(FuPefileFirmwareClass *klass)
 {
 	FuFirmwareClass *klass_firmware = FU_FIRMWARE_CLASS(klass);
 	klass_firmware->check_magic = fu_pefile_firmware_check_magic;
+	klass_firmware->magic = fu_pefile_firmware_magic;
+	klass_firmware->magicsz = sizeof(fu_pefile_firmware_magic);
+	klass_firmware->magic_offset = 0x0;
 	klass_firmware->parse = fu_pefile_firmware_parse;
 }
 
@@ -17,6 +17,7 @@
 #include <unistd.h>
 
 #include "fu-bytes.h"
+#include "fu-common-guid.h"
 #include "fu-context-private.h"
 #include "fu-device-private.h"
 #include "fu-kernel.h"
@@ -1544,7 +1545,7 @@ fu_plugin_check_supported_device(FuPlugin *self, FuDevice *device)
 	GPtrArray *instance_ids = fu_device_get_instance_ids(device);
 	for (guint i = 0; i < instance_ids->len; i++) {
 		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
-		g_autofree gchar *guid = fwupd_guid_hash_string(instance_id);
+		g_autofree gchar *guid = fu_common_guid_hash_string(instance_id);
 		if (fu_plugin_check_supported(self, guid))
 			return TRUE;
 	}
@@ -8,6 +8,7 @@
 
 #include "config.h"
 
+#include <json-glib/json-glib.h>
 #include <math.h>
 
 #include "fu-progress.h"
@@ -66,7 +67,8 @@ struct _FuProgress {
 	FwupdStatus status;
 	GPtrArray *children; /* of FuProgress */
 	gboolean profile;
-	gdouble duration; /* seconds */
+	gdouble duration;  /* seconds */
+	gint64 time_start; /* monotonic µs, only set when profiling */
 	guint step_weighting;
 	GTimer *timer;
 	GTimer *timer_child;
@@ -444,6 +446,8 @@ fu_progress_set_profile(FuProgress *self, gboolean profile)
 {
 	g_return_if_fail(FU_IS_PROGRESS(self));
 	self->profile = profile;
+	if (profile)
+		self->time_start = g_get_monotonic_time();
 }
 
 /**
@@ -844,8 +848,11 @@ fu_progress_step_done(FuProgress *self)
 
 	/* save the duration in the array */
 	if (self->profile) {
-		if (child != NULL)
-			fu_progress_set_duration(child, g_timer_elapsed(self->timer_child, NULL));
+		if (child != NULL) {
+			gdouble duration = g_timer_elapsed(self->timer_child, NULL);
+			fu_progress_set_duration(child, duration);
+			child->time_start = g_get_monotonic_time() - (gint64)(duration * 1000000.f);
+		}
 		g_timer_start(self->timer_child);
 	}
 
@@ -981,6 +988,92 @@ fu_progress_traceback(FuProgress *self)
 	return g_string_free(g_steal_pointer(&str), FALSE);
 }
 
+static void
+fu_progress_to_trace_cb(FuProgress *self, guint child_idx, gint64 time_zero, JsonBuilder *builder)
+{
+	g_autoptr(GString) name = g_string_new(NULL);
+
+	/* not completed */
+	if (self->time_start == 0 || self->duration < 0.0000001)
+		return;
+
+	/* same format as the traceback */
+	if (self->id != NULL)
+		g_string_append(name, self->id);
+	if (self->name != NULL)
+		g_string_append_printf(name, "%s%s", name->len > 0 ? ":" : "", self->name);
+	if (self->id == NULL && self->name == NULL && child_idx != G_MAXUINT)
+		g_string_append_printf(name, "@%u", child_idx);
+
+	/* a complete event, in µs */
+	json_builder_begin_object(builder);
+	json_builder_set_member_name(builder, "name");
+	json_builder_add_string_value(builder, name->str);
+	json_builder_set_member_name(builder, "cat");
+	json_builder_add_string_value(builder, fwupd_status_to_string(self->status));
+	json_builder_set_member_name(builder, "ph");
+	json_builder_add_string_value(builder, "X");
+	json_builder_set_member_name(builder, "ts");
+	json_builder_add_int_value(builder, self->time_start - time_zero);
+	json_builder_set_member_name(builder, "dur");
+	json_builder_add_int_value(builder, (gint64)(self->duration * 1000000.f));
+	json_builder_set_member_name(builder, "pid");
+	json_builder_add_int_value(builder, 1);
+	json_builder_set_member_name(builder, "tid");
+	json_builder_add_int_value(builder, 1);
+	if (self->step_weighting > 0) {
+		json_builder_set_member_name(builder, "args");
+		json_builder_begin_object(builder);
+		json_builder_set_member_name(builder, "StepWeighting");
+		json_builder_add_int_value(builder, self->step_weighting);
+		json_builder_end_object(builder);
+	}
+	json_builder_end_object(builder);
+
+	for (guint i = 0; i < self->children->len; i++) {
+		FuProgress *child = g_ptr_array_index(self->children, i);
+		fu_progress_to_trace_cb(child, i, time_zero, builder);
+	}
+}
+
+/**
+ * fu_progress_to_trace:
+ * @self: A #FuProgress
+ *
+ * Exports the profiled steps as Trace Event Format JSON, which can be loaded into tools such
+ * as `chrome://tracing` or Perfetto. Profiling must have been enabled using
+ * fu_progress_set_profile() before any steps were added.
+ *
+ * Return value: (transfer full): string
+ *
+ * Since: 1.8.14
+ **/
+gchar *
+fu_progress_to_trace(FuProgress *self)
+{
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	g_autoptr(JsonGenerator) json_generator = NULL;
+	g_autoptr(JsonNode) json_root = NULL;
+
+	g_return_val_if_fail(FU_IS_PROGRESS(self), NULL);
+
+	json_builder_begin_object(builder);
+	json_builder_set_member_name(builder, "traceEvents");
+	json_builder_begin_array(builder);
+	fu_progress_to_trace_cb(self, G_MAXUINT, self->time_start, builder);
+	json_builder_end_array(builder);
+	json_builder_set_member_name(builder, "displayTimeUnit");
+	json_builder_add_string_value(builder, "ms");
+	json_builder_end_object(builder);
+
+	/* export as a string */
+	json_root = json_builder_get_root(builder);
+	json_generator = json_generator_new();
+	json_generator_set_pretty(json_generator, TRUE);
+	json_generator_set_root(json_generator, json_root);
+	return json_generator_to_data(json_generator, NULL);
+}
+
 static void
 fu_progress_to_string_cb(FuProgress *self, guint idt, GString *str)
 {
@@ -129,3 +129,5 @@ gchar *
 fu_progress_traceback(FuProgress *self);
 gchar *
 fu_progress_to_string(FuProgress *self);
+gchar *
+fu_progress_to_trace(FuProgress *self);
@@ -55,9 +55,12 @@ struct _FuQuirks {
 	GHashTable *possible_keys;
 	GPtrArray *invalid_keys;
 	XbSilo *silo;
-	XbQuery *query_kv;
 	XbQuery *query_vs;
 	gboolean verbose;
+	GMutex cache_mutex;
+	GHashTable *cache; /* (element-type utf8 GPtrArray) of XbNode, or empty if not found */
+	guint cache_hits;
+	guint cache_misses;
 };
 
 G_DEFINE_TYPE(FuQuirks, fu_quirks, G_TYPE_OBJECT)
@@ -360,6 +363,11 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 	if (self->silo != NULL && xb_silo_is_valid(self->silo))
 		return TRUE;
 
+	/* any cached results are from the old silo */
+	g_hash_table_remove_all(self->cache);
+	g_clear_object(&self->query_vs);
+	g_clear_object(&self->silo);
+
 	/* system datadir */
 	builder = xb_builder_new();
 	datadir = fu_path_from_kind(FU_PATH_KIND_DATADIR_QUIRKS);
@@ -410,14 +418,6 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 	}
 
 	/* create prepared queries to save time later */
-	self->query_kv = xb_query_new_full(self->silo,
-					   "quirk/device[@id=?]/value[@key=?]",
-					   XB_QUERY_FLAG_OPTIMIZE,
-					   error);
-	if (self->query_kv == NULL) {
-		g_prefix_error(error, "failed to prepare query: ");
-		return FALSE;
-	}
 	self->query_vs = xb_query_new_full(self->silo,
 					   "quirk/device[@id=?]/value",
 					   XB_QUERY_FLAG_OPTIMIZE,
@@ -435,31 +435,16 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 	return TRUE;
 }
 
-/**
- * fu_quirks_lookup_by_id:
- * @self: a #FuQuirks
- * @guid: GUID to lookup
- * @key: an ID to match the entry, e.g. `Name`
- *
- * Looks up an entry in the hardware database using a string value.
- *
- * Returns: (transfer none): values from the database, or %NULL if not found
- *
- * Since: 1.0.1
- **/
-const gchar *
-fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
+/* returns all the values for the GUID, caching negative results too */
+static GPtrArray *
+fu_quirks_lookup_values(FuQuirks *self, const gchar *guid)
 {
+	GPtrArray *results;
 	g_autoptr(GError) error = NULL;
-	g_autoptr(XbNode) n = NULL;
 #if LIBXMLB_CHECK_VERSION(0, 3, 0)
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
 #endif
 
-	g_return_val_if_fail(FU_IS_QUIRKS(self), NULL);
-	g_return_val_if_fail(guid != NULL, NULL);
-	g_return_val_if_fail(key != NULL, NULL);
-
 	/* ensure up to date */
 	if (!fu_quirks_check_silo(self, &error)) {
 		g_warning("failed to build silo: %s", error->message);
@@ -467,38 +452,80 @@ fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 	}
 
 	/* no quirk data */
-	if (self->query_kv == NULL)
+	if (self->query_vs == NULL)
 		return NULL;
 
+	/* already queried */
+	results = g_hash_table_lookup(self->cache, guid);
+	if (results != NULL) {
+		self->cache_hits++;
+		return results;
+	}
+	self->cache_misses++;
+
 	/* query */
 #if LIBXMLB_CHECK_VERSION(0, 3, 0)
 	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 1, key, NULL);
-	n = xb_silo_query_first_with_context(self->silo, self->query_kv, &context, &error);
+	results = xb_silo_query_with_context(self->silo, self->query_vs, &context, &error);
 #else
-	if (!xb_query_bind_str(self->query_kv, 0, guid, &error)) {
+	if (!xb_query_bind_str(self->query_vs, 0, guid, &error)) {
 		g_warning("failed to bind 0: %s", error->message);
 		return NULL;
 	}
-	if (!xb_query_bind_str(self->query_kv, 1, key, &error)) {
-		g_warning("failed to bind 1: %s", error->message);
-		return NULL;
-	}
-	n = xb_silo_query_first_full(self->silo, self->query_kv, &error);
+	results = xb_silo_query_full(self->silo, self->query_vs, &error);
 #endif
-
-	if (n == NULL) {
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
-			return NULL;
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
+	if (results == NULL) {
+		if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) &&
+		    !g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
+			g_warning("failed to query: %s", error->message);
 			return NULL;
-		g_warning("failed to query: %s", error->message);
+		}
+		results = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	}
+	g_hash_table_insert(self->cache, g_strdup(guid), results);
+	return results;
+}
+
+/**
+ * fu_quirks_lookup_by_id:
+ * @self: a #FuQuirks
+ * @guid: GUID to lookup
+ * @key: an ID to match the entry, e.g. `Name`
+ *
+ * Looks up an entry in the hardware database using a string value.
+ *
+ * The returned string is interned, and so is valid even if the database is reloaded.
+ *
+ * Returns: (transfer none): values from the database, or %NULL if not found
+ *
+ * Since: 1.0.1
+ **/
+const gchar *
+fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
+{
+	GPtrArray *results;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_QUIRKS(self), NULL);
+	g_return_val_if_fail(guid != NULL, NULL);
+	g_return_val_if_fail(key != NULL, NULL);
+
+	locker = g_mutex_locker_new(&self->cache_mutex);
+	results = fu_quirks_lookup_values(self, guid);
+	if (results == NULL)
 		return NULL;
+	for (guint i = 0; i < results->len; i++) {
+		XbNode *n = g_ptr_array_index(results, i);
+		if (g_strcmp0(xb_node_get_attr(n, "key"), key) != 0)
+			continue;
+		if (self->verbose)
+			g_debug("%s:%s → %s", guid, key, xb_node_get_text(n));
+
+		/* another thread may rebuild the silo as soon as the lock is dropped */
+		return g_intern_string(xb_node_get_text(n));
 	}
-	if (self->verbose)
-		g_debug("%s:%s → %s", guid, key, xb_node_get_text(n));
-	return xb_node_get_text(n);
+	return NULL;
 }
 
 /**
@@ -520,56 +547,69 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 			    FuQuirksIter iter_cb,
 			    gpointer user_data)
 {
-	g_autoptr(GError) error = NULL;
-	g_autoptr(GPtrArray) results = NULL;
-#if LIBXMLB_CHECK_VERSION(0, 3, 0)
-	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
-#endif
+	GPtrArray *results;
+	g_autoptr(GPtrArray) keyvals = g_ptr_array_new_with_free_func(g_free);
 
 	g_return_val_if_fail(FU_IS_QUIRKS(self), FALSE);
 	g_return_val_if_fail(guid != NULL, FALSE);
 	g_return_val_if_fail(iter_cb != NULL, FALSE);
 
-	/* ensure up to date */
-	if (!fu_quirks_check_silo(self, &error)) {
-		g_warning("failed to build silo: %s", error->message);
-		return FALSE;
+	/* the callback may do another lookup, so do not hold the lock -- but copy the
+	 * values first as the silo may be rebuilt as soon as the lock is dropped */
+	g_mutex_lock(&self->cache_mutex);
+	results = fu_quirks_lookup_values(self, guid);
+	for (guint i = 0; results != NULL && i < results->len; i++) {
+		XbNode *n = g_ptr_array_index(results, i);
+		g_ptr_array_add(keyvals, g_strdup(xb_node_get_attr(n, "key")));
+		g_ptr_array_add(keyvals, g_strdup(xb_node_get_text(n)));
 	}
-
-	/* no quirk data */
-	if (self->query_vs == NULL)
+	g_mutex_unlock(&self->cache_mutex);
+	if (keyvals->len == 0)
 		return FALSE;
-
-	/* query */
-#if LIBXMLB_CHECK_VERSION(0, 3, 0)
-	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-	results = xb_silo_query_with_context(self->silo, self->query_vs, &context, &error);
-#else
-	if (!xb_query_bind_str(self->query_vs, 0, guid, &error)) {
-		g_warning("failed to bind 0: %s", error->message);
-		return FALSE;
-	}
-	results = xb_silo_query_full(self->silo, self->query_vs, &error);
-#endif
-
-	if (results == NULL) {
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
-			return FALSE;
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
-			return FALSE;
-		g_warning("failed to query: %s", error->message);
-		return FALSE;
-	}
-	for (guint i = 0; i < results->len; i++) {
-		XbNode *n = g_ptr_array_index(results, i);
+	for (guint i = 0; i < keyvals->len; i += 2) {
+		const gchar *key = g_ptr_array_index(keyvals, i);
+		const gchar *value = g_ptr_array_index(keyvals, i + 1);
 		if (self->verbose)
-			g_debug("%s → %s", guid, xb_node_get_text(n));
-		iter_cb(self, xb_node_get_attr(n, "key"), xb_node_get_text(n), user_data);
+			g_debug("%s → %s", guid, value);
+		iter_cb(self, key, value, user_data);
 	}
 	return TRUE;
 }
 
+/**
+ * fu_quirks_get_cache_hits:
+ * @self: a #FuQuirks
+ *
+ * Gets the number of GUID lookups that did not need to query the silo.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.14
+ **/
+guint
+fu_quirks_get_cache_hits(FuQuirks *self)
+{
+	g_return_val_if_fail(FU_IS_QUIRKS(self), 0);
+	return self->cache_hits;
+}
+
+/**
+ * fu_quirks_get_cache_misses:
+ * @self: a #FuQuirks
+ *
+ * Gets the number of GUID lookups that queried the silo.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.14
+ **/
+guint
+fu_quirks_get_cache_misses(FuQuirks *self)
+{
+	g_return_val_if_fail(FU_IS_QUIRKS(self), 0);
+	return self->cache_misses;
+}
+
 /**
  * fu_quirks_load: (skip)
  * @self: a #FuQuirks
@@ -585,8 +625,12 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 gboolean
 fu_quirks_load(FuQuirks *self, FuQuirksLoadFlags load_flags, GError **error)
 {
+	g_autoptr(GMutexLocker) locker = NULL;
+
 	g_return_val_if_fail(FU_IS_QUIRKS(self), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	locker = g_mutex_locker_new(&self->cache_mutex);
 	self->load_flags = load_flags;
 	self->verbose = g_getenv("FWUPD_XMLB_VERBOSE") != NULL;
 	return fu_quirks_check_silo(self, error);
@@ -621,6 +665,11 @@ static void
 fu_quirks_init(FuQuirks *self)
 {
 	self->possible_keys = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	self->cache = g_hash_table_new_full(g_str_hash,
+					    g_str_equal,
+					    g_free,
+					    (GDestroyNotify)g_ptr_array_unref);
+	g_mutex_init(&self->cache_mutex);
 	self->invalid_keys = g_ptr_array_new_with_free_func(g_free);
 
 	/* built in */
@@ -672,13 +721,13 @@ static void
 fu_quirks_finalize(GObject *obj)
 {
 	FuQuirks *self = FU_QUIRKS(obj);
-	if (self->query_kv != NULL)
-		g_object_unref(self->query_kv);
 	if (self->query_vs != NULL)
 		g_object_unref(self->query_vs);
 	if (self->silo != NULL)
 		g_object_unref(self->silo);
 	g_hash_table_unref(self->possible_keys);
+	g_hash_table_unref(self->cache);
+	g_mutex_clear(&self->cache_mutex);
 	g_ptr_array_unref(self->invalid_keys);
 	G_OBJECT_CLASS(fu_quirks_parent_class)->finalize(obj);
 }
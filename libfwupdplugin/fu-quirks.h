@@ -59,6 +59,10 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 			    gpointer user_data);
 void
 fu_quirks_add_possible_key(FuQuirks *self, const gchar *possible_key);
+guint
+fu_quirks_get_cache_hits(FuQuirks *self);
+guint
+fu_quirks_get_cache_misses(FuQuirks *self);
 
 /**
  * FU_QUIRKS_PLUGIN:
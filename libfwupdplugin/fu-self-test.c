@@ -8,9 +8,16 @@
 
 #include <fwupdplugin.h>
 
+#include <fcntl.h>
 #include <glib/gstdio.h>
 #include <libgcab.h>
 #include <string.h>
+#ifdef HAVE_MEMFD_CREATE
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_GIO_UNIX
+#include <unistd.h>
+#endif
 
 #include "fwupd-bios-setting-private.h"
 #include "fwupd-security-attr-private.h"
@@ -188,6 +195,118 @@ fu_common_crc_func(void)
 	g_assert_cmpint(fu_crc32(buf, sizeof(buf)), ==, 0x40EFAB9E);
 }
 
+static void
+fu_common_crc_tables_func(void)
+{
+	guint8 buf[1024];
+	for (guint i = 0; i < sizeof(buf); i++)
+		buf[i] = (guint8)(i * 7 + 3);
+
+	/* exercise the multi-byte CRC32 path, and the trailing bytes */
+	g_assert_cmpint(fu_crc8(buf, sizeof(buf)), ==, 0x0A);
+	g_assert_cmpint(fu_crc16(buf, sizeof(buf)), ==, 0xB8A6);
+	g_assert_cmpint(fu_crc32(buf, sizeof(buf)), ==, 0x5D3DE8ED);
+	g_assert_cmpint(fu_crc32(buf, sizeof(buf) - 1), ==, 0x5A999F20);
+	g_assert_cmpint(fu_crc32(buf, 17), ==, 0x7BA75EE3);
+
+	/* the initial value is ignored for an empty buffer */
+	g_assert_cmpint(fu_crc8_full(buf, 0, 0x12, 0x07), ==, 0xFF);
+}
+
+static void
+fu_common_crc_performance_func(void)
+{
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	for (gsize sz = 1 * 1024 * 1024; sz <= 64 * 1024 * 1024; sz *= 4) {
+		guint32 crc;
+		g_autofree guint8 *buf = g_malloc(sz);
+		for (gsize i = 0; i < sz; i++)
+			buf[i] = (guint8)i;
+		g_timer_reset(timer);
+		crc = fu_crc32(buf, sz);
+		g_assert_cmpint(crc, !=, 0x0);
+		g_print("%" G_GSIZE_FORMAT "MiB=%.1fMB/s ",
+			sz / (1024 * 1024),
+			(sz / 1000000.f) / g_timer_elapsed(timer, NULL));
+	}
+}
+
+static void
+fu_common_sum_func(void)
+{
+	guint8 buf[1031];
+	for (guint i = 0; i < sizeof(buf); i++)
+		buf[i] = (guint8)(i * 13 + 7);
+
+	/* compare against a simple implementation for every length and alignment */
+	for (gsize offset = 0; offset < 8; offset++) {
+		for (gsize bufsz = 0; bufsz + offset <= sizeof(buf); bufsz++) {
+			const guint8 *data = buf + offset;
+			guint8 sum8 = 0;
+			guint16 sum16 = 0;
+			guint32 sum32 = 0;
+			for (gsize i = 0; i < bufsz; i++) {
+				sum8 += data[i];
+				sum16 += data[i];
+				sum32 += data[i];
+			}
+			g_assert_cmpint(fu_sum8(data, bufsz), ==, sum8);
+			g_assert_cmpint(fu_sum16(data, bufsz), ==, sum16);
+			g_assert_cmpint(fu_sum32(data, bufsz), ==, sum32);
+			if (bufsz % 2 == 0) {
+				guint16 sum16le = 0;
+				guint16 sum16be = 0;
+				for (gsize i = 0; i < bufsz; i += 2) {
+					sum16le += fu_memread_uint16(data + i, G_LITTLE_ENDIAN);
+					sum16be += fu_memread_uint16(data + i, G_BIG_ENDIAN);
+				}
+				g_assert_cmpint(fu_sum16w(data, bufsz, G_LITTLE_ENDIAN), ==, sum16le);
+				g_assert_cmpint(fu_sum16w(data, bufsz, G_BIG_ENDIAN), ==, sum16be);
+			}
+			if (bufsz % 4 == 0) {
+				guint32 sum32le = 0;
+				guint32 sum32be = 0;
+				for (gsize i = 0; i < bufsz; i += 4) {
+					sum32le += fu_memread_uint32(data + i, G_LITTLE_ENDIAN);
+					sum32be += fu_memread_uint32(data + i, G_BIG_ENDIAN);
+				}
+				g_assert_cmpint(fu_sum32w(data, bufsz, G_LITTLE_ENDIAN), ==, sum32le);
+				g_assert_cmpint(fu_sum32w(data, bufsz, G_BIG_ENDIAN), ==, sum32be);
+			}
+		}
+	}
+}
+
+static void
+fu_common_sum_performance_func(void)
+{
+	gsize bufsz = 64 * 1024 * 1024;
+	guint32 sum_simple = 0;
+	gdouble elapsed;
+	g_autofree guint8 *buf = g_malloc(bufsz);
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	for (gsize i = 0; i < bufsz; i++)
+		buf[i] = (guint8)(i ^ (i >> 8));
+
+	/* a dword at a time */
+	for (gsize i = 0; i < bufsz; i += 4)
+		sum_simple += fu_memread_uint32(buf + i, G_BIG_ENDIAN);
+	elapsed = g_timer_elapsed(timer, NULL);
+	g_print("simple=%.2fGB/s ", (bufsz / 1e9) / elapsed);
+
+	/* optimized */
+	g_timer_reset(timer);
+	g_assert_cmpint(fu_sum32w(buf, bufsz, G_BIG_ENDIAN), ==, sum_simple);
+	elapsed = g_timer_elapsed(timer, NULL);
+	g_print("sum32w=%.2fGB/s ", (bufsz / 1e9) / elapsed);
+	g_timer_reset(timer);
+	g_assert_cmpint(fu_sum8(buf, bufsz), ==, fu_sum32(buf, bufsz) & 0xFF);
+	elapsed = g_timer_elapsed(timer, NULL);
+	g_print("sum8+sum32=%.2fGB/s ", (bufsz / 1e9) / elapsed);
+}
+
 static void
 fu_string_append_func(void)
 {
@@ -467,6 +586,46 @@ _strnsplit_nop_cb(GString *token, guint token_idx, gpointer user_data, GError **
 	return TRUE;
 }
 
+static void
+fu_common_guid_cache_func(void)
+{
+	guint hits = fu_common_guid_get_cache_hits();
+	guint misses = fu_common_guid_get_cache_misses();
+	g_autofree gchar *guid1 = NULL;
+	g_autofree gchar *guid2 = NULL;
+	g_autofree gchar *guid3 = NULL;
+	g_autofree gchar *guid4 = NULL;
+
+	/* same result as without the cache */
+	guid1 = fu_common_guid_hash_string("FuSelfTest\\GuidCache");
+	g_assert_cmpstr(guid1, ==, "677ff245-d1f9-5ab7-b8c0-325ed6049e47");
+	guid2 = fu_common_guid_hash_string("FuSelfTest\\GuidCache");
+	g_assert_cmpstr(guid2, ==, guid1);
+	g_assert_cmpint(fu_common_guid_get_cache_hits() - hits, ==, 1);
+	g_assert_cmpint(fu_common_guid_get_cache_misses() - misses, ==, 1);
+	g_assert_null(fu_common_guid_hash_string(NULL));
+	g_assert_null(fu_common_guid_hash_string(""));
+
+	/* least recently used is evicted */
+	for (guint i = 0; i < 10000; i++) {
+		g_autofree gchar *str = g_strdup_printf("USB\\VID_%04X&PID_%04X", i, i);
+		g_autofree gchar *guid = fu_common_guid_hash_string(str);
+		g_assert_nonnull(guid);
+	}
+	misses = fu_common_guid_get_cache_misses();
+	guid3 = fu_common_guid_hash_string("FuSelfTest\\GuidCache");
+	g_assert_cmpstr(guid3, ==, guid1);
+	g_assert_cmpint(fu_common_guid_get_cache_misses() - misses, ==, 1);
+
+	/* hashed again after clearing */
+	fu_common_guid_clear_cache();
+	misses = fu_common_guid_get_cache_misses();
+	guid4 = fu_common_guid_hash_string("FuSelfTest\\GuidCache");
+	g_assert_cmpstr(guid4, ==, guid1);
+	g_assert_cmpint(fu_common_guid_get_cache_misses() - misses, ==, 1);
+	fu_common_guid_clear_cache();
+}
+
 static void
 fu_common_memmem_func(void)
 {
@@ -903,6 +1062,20 @@ fu_plugin_quirks_performance_func(void)
 		}
 	}
 	g_print("lookup=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(fu_quirks_get_cache_misses(quirks), ==, 1);
+	g_assert_cmpint(fu_quirks_get_cache_hits(quirks), ==, 2999);
+
+	/* negative results are cached too */
+	g_timer_reset(timer);
+	for (guint j = 0; j < 1000; j++) {
+		const gchar *group = "00000000-0000-0000-0000-000000000000";
+		for (guint i = 0; keys[i] != NULL; i++) {
+			const gchar *tmp = fu_quirks_lookup_by_id(quirks, group, keys[i]);
+			g_assert_cmpstr(tmp, ==, NULL);
+		}
+	}
+	g_print("missing=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(fu_quirks_get_cache_misses(quirks), ==, 2);
 }
 
 typedef struct {
@@ -1193,6 +1366,233 @@ fu_common_bytes_get_data_func(void)
 	g_assert_null(buf);
 }
 
+static void
+fu_common_bytes_get_contents_fd_func(void)
+{
+#ifdef HAVE_GIO_UNIX
+	const gchar *fn = "/tmp/fwupd-self-test/bytes-get-contents-fd.bin";
+	const guint8 buf_new[0x10] = {0xff};
+	guint8 buf[0x10000];
+	gboolean ret;
+	gint fd;
+	g_autoptr(GBytes) blob_file = NULL;
+	g_autoptr(GBytes) blob_large = NULL;
+	g_autoptr(GBytes) blob_offset = NULL;
+	g_autoptr(GError) error = NULL;
+
+	for (gsize i = 0; i < sizeof(buf); i++)
+		buf[i] = i % 251;
+	ret = fu_path_mkdir_parent(fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(fn, (const gchar *)buf, sizeof(buf), &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* regular file of known size */
+	fd = g_open(fn, O_RDONLY, 0);
+	g_assert_cmpint(fd, >, 0);
+	blob_file = fu_bytes_get_contents_fd(fd, sizeof(buf), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_file);
+	g_assert_cmpint(g_bytes_get_size(blob_file), ==, sizeof(buf));
+	g_assert_cmpint(memcmp(g_bytes_get_data(blob_file, NULL), buf, sizeof(buf)), ==, 0);
+
+	/* the file is not sealed so must have been copied rather than mapped */
+	fd = g_open(fn, O_WRONLY, 0);
+	g_assert_cmpint(fd, >, 0);
+	g_assert_cmpint(write(fd, buf_new, sizeof(buf_new)), ==, sizeof(buf_new));
+	g_assert_true(g_close(fd, NULL));
+	g_assert_cmpint(memcmp(g_bytes_get_data(blob_file, NULL), buf, sizeof(buf)), ==, 0);
+	ret = g_file_set_contents(fn, (const gchar *)buf, sizeof(buf), &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the current offset is honoured */
+	fd = g_open(fn, O_RDONLY, 0);
+	g_assert_cmpint(fd, >, 0);
+	g_assert_cmpint(lseek(fd, 0x100, SEEK_SET), ==, 0x100);
+	blob_offset = fu_bytes_get_contents_fd(fd, sizeof(buf) - 0x100, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_offset);
+	g_assert_cmpint(g_bytes_get_size(blob_offset), ==, sizeof(buf) - 0x100);
+	g_assert_cmpint(
+	    memcmp(g_bytes_get_data(blob_offset, NULL), buf + 0x100, sizeof(buf) - 0x100),
+	    ==,
+	    0);
+
+	/* larger than the limit */
+	fd = g_open(fn, O_RDONLY, 0);
+	g_assert_cmpint(fd, >, 0);
+	blob_large = fu_bytes_get_contents_fd(fd, sizeof(buf) - 1, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
+	g_assert_null(blob_large);
+	g_clear_error(&error);
+
+#if defined(HAVE_MEMFD_CREATE) && defined(F_ADD_SEALS)
+	{
+		g_autoptr(GBytes) blob_memfd = NULL;
+
+		/* sealed memfd, read from the current offset */
+		fd = memfd_create("fwupd", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		g_assert_cmpint(fd, >, 0);
+		g_assert_cmpint(write(fd, buf, sizeof(buf)), ==, sizeof(buf));
+		g_assert_cmpint(lseek(fd, 0x100, SEEK_SET), ==, 0x100);
+		g_assert_cmpint(fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE),
+				==,
+				0);
+		blob_memfd = fu_bytes_get_contents_fd(fd, sizeof(buf), &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(blob_memfd);
+		g_assert_cmpint(g_bytes_get_size(blob_memfd), ==, sizeof(buf) - 0x100);
+		g_assert_cmpint(
+		    memcmp(g_bytes_get_data(blob_memfd, NULL), buf + 0x100, sizeof(buf) - 0x100),
+		    ==,
+		    0);
+	}
+#endif
+	g_assert_cmpint(g_unlink(fn), ==, 0);
+#else
+	g_test_skip("no GIO unix support");
+#endif
+}
+
+static void
+fu_common_bytes_get_contents_fd_performance_func(void)
+{
+#ifdef HAVE_GIO_UNIX
+	const gchar *fn = "/tmp/fwupd-self-test/bytes-get-contents-fd-performance.bin";
+	const gsize bufsz = 64 * 1024 * 1024;
+	gboolean ret;
+	gint fd;
+	g_autofree guint8 *buf = g_malloc(bufsz);
+	g_autoptr(GBytes) blob_file = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	for (gsize i = 0; i < bufsz; i++)
+		buf[i] = i % 251;
+	ret = fu_path_mkdir_parent(fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(fn, (const gchar *)buf, bufsz, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* regular file of known size */
+	fd = g_open(fn, O_RDONLY, 0);
+	g_assert_cmpint(fd, >, 0);
+	g_timer_reset(timer);
+	blob_file = fu_bytes_get_contents_fd(fd, bufsz, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_file);
+	g_print("file=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(g_bytes_get_size(blob_file), ==, bufsz);
+
+#if defined(HAVE_MEMFD_CREATE) && defined(F_ADD_SEALS)
+	{
+		gsize offset = 0;
+		g_autoptr(GBytes) blob_memfd = NULL;
+
+		/* sealed memfd is mapped and not copied */
+		fd = memfd_create("fwupd", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		g_assert_cmpint(fd, >, 0);
+		while (offset < bufsz) {
+			gssize rc = write(fd, buf + offset, bufsz - offset);
+			g_assert_cmpint(rc, >, 0);
+			offset += rc;
+		}
+		g_assert_cmpint(lseek(fd, 0, SEEK_SET), ==, 0);
+		g_assert_cmpint(fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE),
+				==,
+				0);
+		g_timer_reset(timer);
+		blob_memfd = fu_bytes_get_contents_fd(fd, bufsz, &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(blob_memfd);
+		g_print("memfd=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+		g_assert_cmpint(g_bytes_get_size(blob_memfd), ==, bufsz);
+		g_assert_cmpint(memcmp(g_bytes_get_data(blob_memfd, NULL), buf, bufsz), ==, 0);
+	}
+#endif
+	g_assert_cmpint(g_unlink(fn), ==, 0);
+#else
+	g_test_skip("no GIO unix support");
+#endif
+}
+
+static void
+fu_common_bytes_checksum_func(void)
+{
+	GChecksumType checksum_types[] =
+	    {G_CHECKSUM_SHA1, G_CHECKSUM_SHA256, G_CHECKSUM_SHA384, G_CHECKSUM_SHA512, 0};
+	guint8 buf[0x30001];
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob_cached = NULL;
+	g_autofree gchar *csum_md5 = NULL;
+
+	/* not a multiple of the chunk size */
+	for (gsize i = 0; i < sizeof(buf); i++)
+		buf[i] = (guint8)(i * 5 + 1);
+	blob = g_bytes_new_static(buf, sizeof(buf));
+	blob_cached = fu_bytes_new_with_checksums(blob);
+	g_assert_true(g_bytes_equal(blob, blob_cached));
+
+	/* every digest matches the slow way, and asking twice returns the same thing */
+	for (guint i = 0; checksum_types[i] != 0; i++) {
+		g_autofree gchar *csum = g_compute_checksum_for_bytes(checksum_types[i], blob);
+		g_autofree gchar *csum1 = fu_bytes_get_checksum(blob_cached, checksum_types[i]);
+		g_autofree gchar *csum2 = fu_bytes_get_checksum(blob_cached, checksum_types[i]);
+		g_autofree gchar *csum3 = fu_bytes_get_checksum(blob, checksum_types[i]);
+		g_assert_cmpstr(csum1, ==, csum);
+		g_assert_cmpstr(csum2, ==, csum);
+		g_assert_cmpstr(csum3, ==, csum);
+	}
+
+	/* not cached */
+	csum_md5 = fu_bytes_get_checksum(blob_cached, G_CHECKSUM_MD5);
+	g_assert_cmpstr(csum_md5, ==, "8c2a52f1898206df84a543af5e4ba01d");
+}
+
+static void
+fu_common_bytes_checksum_performance_func(void)
+{
+	GChecksumType checksum_types[] =
+	    {G_CHECKSUM_SHA1, G_CHECKSUM_SHA256, G_CHECKSUM_SHA384, G_CHECKSUM_SHA512, 0};
+	const gsize bufsz = 128 * 1024 * 1024;
+	guint8 *buf = g_malloc(bufsz);
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob_cached = NULL;
+	g_autoptr(GPtrArray) checksums = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* about the size of a large cabinet archive */
+	for (gsize i = 0; i < bufsz; i++)
+		buf[i] = (guint8)(i ^ (i >> 12));
+	blob = g_bytes_new_take(buf, bufsz);
+
+	/* one full pass for each digest */
+	g_timer_reset(timer);
+	for (guint i = 0; checksum_types[i] != 0; i++)
+		g_ptr_array_add(checksums, g_compute_checksum_for_bytes(checksum_types[i], blob));
+	g_print("separate=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* all digests in one pass, and then from the cache */
+	blob_cached = fu_bytes_new_with_checksums(blob);
+	g_timer_reset(timer);
+	for (guint i = 0; checksum_types[i] != 0; i++) {
+		g_autofree gchar *csum = fu_bytes_get_checksum(blob_cached, checksum_types[i]);
+		g_assert_cmpstr(csum, ==, g_ptr_array_index(checksums, i));
+	}
+	g_print("single=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_timer_reset(timer);
+	for (guint i = 0; checksum_types[i] != 0; i++) {
+		g_autofree gchar *csum = fu_bytes_get_checksum(blob_cached, checksum_types[i]);
+		g_assert_cmpstr(csum, ==, g_ptr_array_index(checksums, i));
+	}
+	g_print("cached=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+}
+
 static gboolean
 fu_device_poll_cb(FuDevice *device, GError **error)
 {
@@ -1266,6 +1666,21 @@ fu_device_instance_ids_func(void)
 	/* this gets added immediately */
 	fu_device_add_instance_id(device, "bazbarfoo");
 	g_assert_true(fu_device_has_guid(device, "77e49bb0-2cd6-5faf-bcee-5b7fbe6e944d"));
+	g_assert_true(fu_device_has_guid(device, "bazbarfoo"));
+
+	/* the GUID strings are compared exactly */
+	g_assert_false(fu_device_has_guid(device, "77E49BB0-2CD6-5FAF-BCEE-5B7FBE6E944D"));
+	fwupd_device_add_guid(FWUPD_DEVICE(device), "2082B5E0-7A64-478A-B1B2-E3404FAB6DAD");
+	g_assert_true(fu_device_has_guid(device, "2082B5E0-7A64-478A-B1B2-E3404FAB6DAD"));
+	g_assert_false(fu_device_has_guid(device, "2082b5e0-7a64-478a-b1b2-e3404fab6dad"));
+
+	/* all the GUIDs are removed on rescan */
+	ret = fu_device_rescan(device, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_false(fu_device_has_guid(device, "77e49bb0-2cd6-5faf-bcee-5b7fbe6e944d"));
+	fu_device_add_instance_id(device, "bazbarfoo");
+	g_assert_true(fu_device_has_guid(device, "77e49bb0-2cd6-5faf-bcee-5b7fbe6e944d"));
 }
 
 static void
@@ -1628,6 +2043,98 @@ fu_backend_func(void)
 	g_assert_true(dev == dev1);
 }
 
+static void
+fu_chunk_view_func(void)
+{
+	struct {
+		guint32 bufsz;
+		guint32 addr_start;
+		guint32 page_sz;
+		guint32 packet_sz;
+	} map[] = {
+	    {6, 0x0, 3, 3},
+	    {6, 0x4, 4, 4},
+	    {16, 0x0, 10, 4},
+	    {18, 0x0, 6, 4},
+	    {1, 0x0, 0, 0},
+	    {100, 0x0, 0, 7},
+	    {100, 0x5, 16, 0},
+	    {1000, 0x40, 64, 24},
+	    {0, 0x0, 0, 0},
+	    /* starting on the last byte of a page */
+	    {10, 0x3, 4, 2},
+	    {10, 0x3, 4, 0},
+	    {10, 0x3, 4, 8},
+	    {9, 0x7, 8, 3},
+	    {2, 0x0, 1, 1},
+	    {1, 0x3, 4, 2},
+	};
+	g_autofree guint8 *buf = g_malloc0(1000);
+	for (guint i = 0; i < 1000; i++)
+		buf[i] = (guint8)i;
+
+	/* compare against the array of objects */
+	for (guint i = 0; i < G_N_ELEMENTS(map); i++) {
+		g_autoptr(GBytes) blob = g_bytes_new_static(buf, map[i].bufsz);
+		g_autoptr(GPtrArray) chunks = NULL;
+		g_autoptr(FuChunkView) view = NULL;
+
+		chunks = fu_chunk_array_new_from_bytes(blob,
+						       map[i].addr_start,
+						       map[i].page_sz,
+						       map[i].packet_sz);
+		view = fu_chunk_view_new(blob, map[i].addr_start, map[i].page_sz, map[i].packet_sz);
+		g_assert_cmpint(fu_chunk_view_length(view), ==, chunks->len);
+		for (guint j = 0; j < chunks->len; j++) {
+			FuChunk *chk = g_ptr_array_index(chunks, j);
+			g_autoptr(FuChunk) chk2 = fu_chunk_view_index(view, j);
+			g_autofree gchar *str = fu_chunk_to_string(chk);
+			g_autofree gchar *str2 = fu_chunk_to_string(chk2);
+			g_assert_cmpint(fu_chunk_view_get_page(view, j), ==, fu_chunk_get_page(chk));
+			g_assert_cmpint(fu_chunk_view_get_address(view, j),
+					==,
+					fu_chunk_get_address(chk));
+			g_assert_true(fu_chunk_view_get_data(view, j) == fu_chunk_get_data(chk));
+			g_assert_cmpint(fu_chunk_view_get_data_sz(view, j),
+					==,
+					fu_chunk_get_data_sz(chk));
+			g_assert_cmpstr(str, ==, str2);
+		}
+	}
+}
+
+static void
+fu_chunk_view_performance_func(void)
+{
+	gsize bufsz = 32 * 1024 * 1024;
+	gsize total = 0;
+	g_autofree guint8 *buf = g_malloc0(bufsz);
+	g_autoptr(GBytes) blob = g_bytes_new_static(buf, bufsz);
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* one FuChunk and one GBytes per packet */
+	{
+		g_autoptr(GPtrArray) chunks = fu_chunk_array_new_from_bytes(blob, 0x0, 0x1000, 256);
+		for (guint i = 0; i < chunks->len; i++) {
+			FuChunk *chk = g_ptr_array_index(chunks, i);
+			total += fu_chunk_get_data_sz(chk);
+		}
+	}
+	g_assert_cmpint(total, ==, bufsz);
+	g_print("array=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* one object in total */
+	total = 0;
+	g_timer_reset(timer);
+	{
+		g_autoptr(FuChunkView) view = fu_chunk_view_new(blob, 0x0, 0x1000, 256);
+		for (guint i = 0; i < fu_chunk_view_length(view); i++)
+			total += fu_chunk_view_get_data_sz(view, i);
+	}
+	g_assert_cmpint(total, ==, bufsz);
+	g_print("view=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+}
+
 static void
 fu_chunk_func(void)
 {
@@ -2692,6 +3199,56 @@ fu_firmware_ifwi_cpd_func(void)
 	g_assert_cmpint(fu_firmware_get_size(img2), ==, 11);
 }
 
+static void
+fu_firmware_search_magic_func(void)
+{
+	gboolean ret;
+	gsize bufsz = 4 * 1024 * 1024;
+	gsize offset = 0x3F0000;
+	g_autofree gchar *filename_ifwi_cpd = NULL;
+	g_autofree guint8 *buf = g_malloc(bufsz);
+	g_autoptr(FuFirmware) firmware = fu_ifwi_cpd_firmware_new();
+	g_autoptr(FuFirmware) firmware2 = fu_ifwi_cpd_firmware_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) data_ifwi_cpd = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	filename_ifwi_cpd = g_test_build_filename(G_TEST_DIST, "tests", "ifwi-cpd.bin", NULL);
+	data_ifwi_cpd = fu_bytes_get_contents(filename_ifwi_cpd, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(data_ifwi_cpd);
+
+	/* hide the image in a large blob with lots of partial matches */
+	memset(buf, 0xFF, bufsz);
+	for (gsize i = 0; i < bufsz - 3; i += 0x1000)
+		memcpy(buf + i, "$CP", 3);
+	ret = fu_memcpy_safe(buf,
+			     bufsz,
+			     offset,
+			     g_bytes_get_data(data_ifwi_cpd, NULL),
+			     g_bytes_get_size(data_ifwi_cpd),
+			     0x0,
+			     g_bytes_get_size(data_ifwi_cpd),
+			     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob = g_bytes_new_static(buf, bufsz);
+
+	/* found by searching */
+	ret = fu_firmware_parse(firmware, blob, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_firmware_get_offset(firmware), ==, offset);
+	g_assert_cmpint(fu_firmware_get_idx(firmware), ==, 0x1234);
+	g_print("search=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* not found when searching is disabled */
+	ret = fu_firmware_parse(firmware2, blob, FWUPD_INSTALL_FLAG_NO_SEARCH, &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+	g_assert_false(ret);
+}
+
 static void
 fu_firmware_ifwi_fpt_func(void)
 {
@@ -2897,6 +3454,47 @@ fu_firmware_common_func(void)
 	g_assert_false(ret);
 }
 
+static void
+fu_firmware_image_checksum_func(void)
+{
+	g_autoptr(FuFirmware) firmware = fu_firmware_new();
+	g_autoptr(FuFirmware) img_nopayload = fu_firmware_new();
+	g_autoptr(FuFirmware) img = fu_linear_firmware_new(FU_TYPE_FIRMWARE);
+	g_autoptr(FuFirmware) img_child = fu_firmware_new();
+	g_autoptr(FuFirmware) img_found = NULL;
+	g_autoptr(GBytes) blob1 = g_bytes_new_static("AAAA", 4);
+	g_autoptr(GBytes) blob2 = g_bytes_new_static("BBBB", 4);
+	g_autoptr(GError) error = NULL;
+	g_autofree gchar *csum1 = NULL;
+	g_autofree gchar *csum2 = NULL;
+
+	/* the first image cannot be written, so has no checksum */
+	fu_firmware_add_image(firmware, img_nopayload);
+	fu_firmware_set_bytes(img_child, blob1);
+	fu_firmware_add_image(img, img_child);
+	fu_firmware_add_image(firmware, img);
+	csum1 = fu_firmware_get_checksum(img, G_CHECKSUM_SHA256, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(csum1);
+	img_found = fu_firmware_get_image_by_checksum(firmware, csum1, &error);
+	g_assert_no_error(error);
+	g_assert_true(img_found == img);
+	g_clear_object(&img_found);
+
+	/* changing the grandchild changes the checksum of the child */
+	fu_firmware_set_bytes(img_child, blob2);
+	csum2 = fu_firmware_get_checksum(img, G_CHECKSUM_SHA256, &error);
+	g_assert_no_error(error);
+	g_assert_cmpstr(csum1, !=, csum2);
+	img_found = fu_firmware_get_image_by_checksum(firmware, csum2, &error);
+	g_assert_no_error(error);
+	g_assert_true(img_found == img);
+	g_clear_object(&img_found);
+	img_found = fu_firmware_get_image_by_checksum(firmware, csum1, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(img_found);
+}
+
 static void
 fu_firmware_dedupe_func(void)
 {
@@ -3618,6 +4216,53 @@ fu_progress_child_func(void)
 	g_assert_cmpint(helper.last_percentage, ==, 100);
 }
 
+static void
+fu_progress_trace_func(void)
+{
+	FuProgress *child;
+	JsonArray *json_events;
+	JsonObject *json_event;
+	gboolean ret;
+	g_autofree gchar *str = NULL;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	fu_progress_set_profile(progress, TRUE);
+	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 50, "load-quirks");
+	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 50, "backend-coldplug");
+	g_usleep(10 * 1000);
+	fu_progress_step_done(progress);
+
+	/* one device */
+	child = fu_progress_get_child(progress);
+	fu_progress_set_id(child, G_STRLOC);
+	fu_progress_set_steps(child, 1);
+	fu_progress_set_name(fu_progress_get_child(child), "usb:01:00");
+	g_usleep(10 * 1000);
+	fu_progress_step_done(child);
+	fu_progress_step_done(progress);
+
+	str = fu_progress_to_trace(progress);
+	g_debug("%s", str);
+	ret = json_parser_load_from_data(parser, str, -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	json_events = json_object_get_array_member(json_node_get_object(json_parser_get_root(parser)),
+						   "traceEvents");
+	g_assert_cmpint(json_array_get_length(json_events), ==, 4);
+
+	/* the device is inside the second step */
+	json_event = json_array_get_object_element(json_events, 2);
+	g_assert_cmpstr(json_object_get_string_member(json_event, "ph"), ==, "X");
+	g_assert_true(
+	    g_str_has_suffix(json_object_get_string_member(json_event, "name"), "backend-coldplug"));
+	g_assert_cmpint(json_object_get_int_member(json_event, "ts"), >=, 10000);
+	json_event = json_array_get_object_element(json_events, 3);
+	g_assert_cmpstr(json_object_get_string_member(json_event, "name"), ==, "usb:01:00");
+	g_assert_cmpint(json_object_get_int_member(json_event, "dur"), >=, 10000);
+}
+
 static void
 fu_progress_parent_one_step_proxy_func(void)
 {
@@ -3851,9 +4496,11 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/plugin{quirks-append}", fu_plugin_quirks_append_func);
 	g_test_add_func("/fwupd/common{strnsplit}", fu_strsplit_func);
 	g_test_add_func("/fwupd/common{memmem}", fu_common_memmem_func);
+	g_test_add_func("/fwupd/common{guid-cache}", fu_common_guid_cache_func);
 	if (g_test_slow())
 		g_test_add_func("/fwupd/progress", fu_progress_func);
 	g_test_add_func("/fwupd/progress{child}", fu_progress_child_func);
+	g_test_add_func("/fwupd/progress{trace}", fu_progress_trace_func);
 	g_test_add_func("/fwupd/progress{child-finished}", fu_progress_child_finished);
 	g_test_add_func("/fwupd/progress{parent-1-step}", fu_progress_parent_one_step_proxy_func);
 	g_test_add_func("/fwupd/progress{no-equal}", fu_progress_non_equal_steps_func);
@@ -3871,10 +4518,19 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/plugin{quirks-device}", fu_plugin_quirks_device_func);
 	g_test_add_func("/fwupd/backend", fu_backend_func);
 	g_test_add_func("/fwupd/chunk", fu_chunk_func);
+	g_test_add_func("/fwupd/chunk{view}", fu_chunk_view_func);
+	if (g_test_slow())
+		g_test_add_func("/fwupd/chunk{view-performance}", fu_chunk_view_performance_func);
 	g_test_add_func("/fwupd/common{align-up}", fu_common_align_up_func);
 	g_test_add_func("/fwupd/volume{gpt-type}", fu_volume_gpt_type_func);
 	g_test_add_func("/fwupd/common{byte-array}", fu_common_byte_array_func);
 	g_test_add_func("/fwupd/common{crc}", fu_common_crc_func);
+	g_test_add_func("/fwupd/common{crc-tables}", fu_common_crc_tables_func);
+	if (g_test_slow())
+		g_test_add_func("/fwupd/common{crc-performance}", fu_common_crc_performance_func);
+	g_test_add_func("/fwupd/common{sum}", fu_common_sum_func);
+	if (g_test_slow())
+		g_test_add_func("/fwupd/common{sum-performance}", fu_common_sum_performance_func);
 	g_test_add_func("/fwupd/common{string-append-kv}", fu_string_append_func);
 	g_test_add_func("/fwupd/common{version-guess-format}", fu_version_guess_format_func);
 	g_test_add_func("/fwupd/common{strtoull}", fu_strtoull_func);
@@ -3885,6 +4541,15 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/common{endian}", fu_common_endian_func);
 	g_test_add_func("/fwupd/common{cabinet}", fu_common_cabinet_func);
 	g_test_add_func("/fwupd/common{bytes-get-data}", fu_common_bytes_get_data_func);
+	g_test_add_func("/fwupd/common{bytes-get-contents-fd}",
+			fu_common_bytes_get_contents_fd_func);
+	if (g_test_slow())
+		g_test_add_func("/fwupd/common{bytes-get-contents-fd-performance}",
+				fu_common_bytes_get_contents_fd_performance_func);
+	g_test_add_func("/fwupd/common{bytes-checksum}", fu_common_bytes_checksum_func);
+	if (g_test_slow())
+		g_test_add_func("/fwupd/common{bytes-checksum-performance}",
+				fu_common_bytes_checksum_performance_func);
 	g_test_add_func("/fwupd/common{kernel-lockdown}", fu_common_kernel_lockdown_func);
 	g_test_add_func("/fwupd/common{strsafe}", fu_strsafe_func);
 	g_test_add_func("/fwupd/efivar", fu_efivar_func);
@@ -3898,6 +4563,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/firmware{archive}", fu_firmware_archive_func);
 	g_test_add_func("/fwupd/firmware{linear}", fu_firmware_linear_func);
 	g_test_add_func("/fwupd/firmware{dedupe}", fu_firmware_dedupe_func);
+	g_test_add_func("/fwupd/firmware{image-checksum}", fu_firmware_image_checksum_func);
 	g_test_add_func("/fwupd/firmware{build}", fu_firmware_build_func);
 	g_test_add_func("/fwupd/firmware{raw-aligned}", fu_firmware_raw_aligned_func);
 	g_test_add_func("/fwupd/firmware{ihex}", fu_firmware_ihex_func);
@@ -3908,6 +4574,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/firmware{fdt}", fu_firmware_fdt_func);
 	g_test_add_func("/fwupd/firmware{fit}", fu_firmware_fit_func);
 	g_test_add_func("/fwupd/firmware{ifwi-cpd}", fu_firmware_ifwi_cpd_func);
+	g_test_add_func("/fwupd/firmware{search-magic}", fu_firmware_search_magic_func);
 	g_test_add_func("/fwupd/firmware{ifwi-fpt}", fu_firmware_ifwi_fpt_func);
 	g_test_add_func("/fwupd/firmware{oprom}", fu_firmware_oprom_func);
 	g_test_add_func("/fwupd/firmware{dfu}", fu_firmware_dfu_func);
@@ -21,6 +21,7 @@
 #include <libfwupdplugin/fu-cfu-common.h>
 #include <libfwupdplugin/fu-cfu-offer.h>
 #include <libfwupdplugin/fu-cfu-payload.h>
+#include <libfwupdplugin/fu-chunk-view.h>
 #include <libfwupdplugin/fu-chunk.h>
 #include <libfwupdplugin/fu-common-guid.h>
 #include <libfwupdplugin/fu-common.h>
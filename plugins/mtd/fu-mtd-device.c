@@ -6,20 +6,28 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #ifdef HAVE_MTD_USER_H
 #include <mtd/mtd-user.h>
 #endif
 
 #include "fu-mtd-device.h"
 
+/* read the existing contents first and only erase and write the blocks that are different */
+#define FU_MTD_DEVICE_FLAG_SKIP_UNCHANGED (1 << 0)
+
 struct _FuMtdDevice {
 	FuUdevDevice parent_instance;
 	guint64 erasesize;
+	guint blocks_written;
+	guint blocks_skipped;
 };
 
 G_DEFINE_TYPE(FuMtdDevice, fu_mtd_device, FU_TYPE_UDEV_DEVICE)
 
 #define FU_MTD_DEVICE_IOCTL_TIMEOUT 5000 /* ms */
+#define FU_MTD_DEVICE_CHUNK_SIZE    (10 * 1024)
 
 static void
 fu_mtd_device_to_string(FuDevice *device, guint idt, GString *str)
@@ -186,11 +194,9 @@ fu_mtd_device_probe(FuDevice *device, GError **error)
 }
 
 static gboolean
-fu_mtd_device_erase(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError **error)
+fu_mtd_device_erase(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress, GError **error)
 {
 #ifdef HAVE_MTD_USER_H
-	g_autoptr(GPtrArray) chunks = fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, self->erasesize);
-
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, chunks->len);
@@ -297,10 +303,11 @@ fu_mtd_device_verify(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress,
 }
 
 static gboolean
-fu_mtd_device_write_verify(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError **error)
+fu_mtd_device_write_verify(FuMtdDevice *self,
+			   GPtrArray *chunks,
+			   FuProgress *progress,
+			   GError **error)
 {
-	g_autoptr(GPtrArray) chunks = fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, 10 * 1024);
-
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
@@ -321,6 +328,108 @@ fu_mtd_device_write_verify(FuMtdDevice *self, GBytes *fw, FuProgress *progress,
 	return TRUE;
 }
 
+static GPtrArray *
+fu_mtd_device_get_changed_blocks(FuMtdDevice *self,
+				 GBytes *fw,
+				 FuProgress *progress,
+				 GError **error)
+{
+	gsize blocksz = self->erasesize > 0 ? self->erasesize : FU_MTD_DEVICE_CHUNK_SIZE;
+	g_autofree guint8 *buf = g_malloc0(blocksz);
+	g_autoptr(GPtrArray) blocks = fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, blocksz);
+	g_autoptr(GPtrArray) blocks_changed =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, blocks->len);
+
+	/* compare each block with the existing contents */
+	for (guint i = 0; i < blocks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(blocks, i);
+		if (!fu_udev_device_pread(FU_UDEV_DEVICE(self),
+					  fu_chunk_get_address(chk),
+					  buf,
+					  fu_chunk_get_data_sz(chk),
+					  error)) {
+			g_prefix_error(error,
+				       "failed to read @0x%x: ",
+				       (guint)fu_chunk_get_address(chk));
+			return NULL;
+		}
+		if (memcmp(buf, fu_chunk_get_data(chk), fu_chunk_get_data_sz(chk)) != 0)
+			g_ptr_array_add(blocks_changed, g_object_ref(chk));
+		fu_progress_step_done(progress);
+	}
+	self->blocks_written = blocks_changed->len;
+	self->blocks_skipped = blocks->len - blocks_changed->len;
+
+	/* success */
+	return g_steal_pointer(&blocks_changed);
+}
+
+static gboolean
+fu_mtd_device_write_firmware_changed(FuMtdDevice *self,
+				     GBytes *fw,
+				     FuProgress *progress,
+				     GError **error)
+{
+	gsize changedsz = 0;
+	g_autofree gchar *name = NULL;
+	g_autoptr(GPtrArray) blocks = NULL;
+	g_autoptr(GPtrArray) chunks = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_READ, 20, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 35, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 45, NULL);
+
+	/* find the blocks that need updating */
+	blocks = fu_mtd_device_get_changed_blocks(self, fw, fu_progress_get_child(progress), error);
+	if (blocks == NULL)
+		return FALSE;
+	for (guint i = 0; i < blocks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(blocks, i);
+		g_autoptr(GPtrArray) chunks_tmp = fu_chunk_array_new(fu_chunk_get_data(chk),
+								     fu_chunk_get_data_sz(chk),
+								     fu_chunk_get_address(chk),
+								     0x0,
+								     FU_MTD_DEVICE_CHUNK_SIZE);
+		for (guint j = 0; j < chunks_tmp->len; j++)
+			g_ptr_array_add(chunks, g_object_ref(g_ptr_array_index(chunks_tmp, j)));
+		changedsz += fu_chunk_get_data_sz(chk);
+	}
+	name = g_strdup_printf("skipped 0x%x of 0x%x bytes",
+			       (guint)(g_bytes_get_size(fw) - changedsz),
+			       (guint)g_bytes_get_size(fw));
+	fu_progress_set_name(fu_progress_get_child(progress), name);
+	g_debug("%s", name);
+	fu_progress_step_done(progress);
+
+	/* nothing to do */
+	if (blocks->len == 0) {
+		fu_progress_finished(progress);
+		return TRUE;
+	}
+
+	/* erase */
+	if (self->erasesize > 0) {
+		if (!fu_mtd_device_erase(self, blocks, fu_progress_get_child(progress), error))
+			return FALSE;
+	}
+	fu_progress_step_done(progress);
+
+	/* write and verify only the ranges that were erased */
+	if (!fu_mtd_device_write_verify(self, chunks, fu_progress_get_child(progress), error))
+		return FALSE;
+	fu_progress_step_done(progress);
+
+	/* success */
+	return TRUE;
+}
+
 static GBytes *
 fu_mtd_device_dump_firmware(FuDevice *device, FuProgress *progress, GError **error)
 {
@@ -334,7 +443,7 @@ fu_mtd_device_dump_firmware(FuDevice *device, FuProgress *progress, GError **err
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_READ);
 
 	/* read each chunk */
-	chunks = fu_chunk_array_mutable_new(buf, bufsz, 0x0, 0x0, 10 * 1024);
+	chunks = fu_chunk_array_mutable_new(buf, bufsz, 0x0, 0x0, FU_MTD_DEVICE_CHUNK_SIZE);
 	fu_progress_set_steps(progress, chunks->len);
 	for (guint i = 0; i < chunks->len; i++) {
 		FuChunk *chk = g_ptr_array_index(chunks, i);
@@ -364,6 +473,12 @@ fu_mtd_device_write_firmware(FuDevice *device,
 {
 	FuMtdDevice *self = FU_MTD_DEVICE(device);
 	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GPtrArray) blocks = NULL;
+	g_autoptr(GPtrArray) chunks = NULL;
+
+	/* reset stats */
+	self->blocks_written = 0;
+	self->blocks_skipped = 0;
 
 	/* get data to write */
 	fw = fu_firmware_get_bytes(firmware, error);
@@ -379,9 +494,14 @@ fu_mtd_device_write_firmware(FuDevice *device,
 		return FALSE;
 	}
 
+	/* only rewrite the blocks that are different */
+	if (fu_device_has_private_flag(device, FU_MTD_DEVICE_FLAG_SKIP_UNCHANGED))
+		return fu_mtd_device_write_firmware_changed(self, fw, progress, error);
+
 	/* just one step required */
+	chunks = fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, FU_MTD_DEVICE_CHUNK_SIZE);
 	if (self->erasesize == 0)
-		return fu_mtd_device_write_verify(self, fw, progress, error);
+		return fu_mtd_device_write_verify(self, chunks, progress, error);
 
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
@@ -390,12 +510,14 @@ fu_mtd_device_write_firmware(FuDevice *device,
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50, NULL);
 
 	/* erase */
-	if (!fu_mtd_device_erase(self, fw, fu_progress_get_child(progress), error))
+	blocks = fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, self->erasesize);
+	if (!fu_mtd_device_erase(self, blocks, fu_progress_get_child(progress), error))
 		return FALSE;
 	fu_progress_step_done(progress);
+	self->blocks_written = blocks->len;
 
 	/* write */
-	if (!fu_mtd_device_write_verify(self, fw, fu_progress_get_child(progress), error))
+	if (!fu_mtd_device_write_verify(self, chunks, fu_progress_get_child(progress), error))
 		return FALSE;
 	fu_progress_step_done(progress);
 
@@ -403,6 +525,22 @@ fu_mtd_device_write_firmware(FuDevice *device,
 	return TRUE;
 }
 
+/* for the self tests */
+guint
+fu_mtd_device_get_blocks_written(FuMtdDevice *self)
+{
+	g_return_val_if_fail(FU_IS_MTD_DEVICE(self), G_MAXUINT);
+	return self->blocks_written;
+}
+
+/* for the self tests */
+guint
+fu_mtd_device_get_blocks_skipped(FuMtdDevice *self)
+{
+	g_return_val_if_fail(FU_IS_MTD_DEVICE(self), G_MAXUINT);
+	return self->blocks_skipped;
+}
+
 static void
 fu_mtd_device_init(FuMtdDevice *self)
 {
@@ -413,6 +551,9 @@ fu_mtd_device_init(FuMtdDevice *self)
 	fu_device_add_flag(FU_DEVICE(self), FWUPD_DEVICE_FLAG_CAN_VERIFY_IMAGE);
 	fu_device_add_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_MD_SET_SIGNED);
 	fu_device_add_icon(FU_DEVICE(self), "drive-harddisk-solidstate");
+	fu_device_register_private_flag(FU_DEVICE(self),
+					FU_MTD_DEVICE_FLAG_SKIP_UNCHANGED,
+					"skip-unchanged");
 	fu_udev_device_set_flags(FU_UDEV_DEVICE(self),
 				 FU_UDEV_DEVICE_FLAG_OPEN_READ | FU_UDEV_DEVICE_FLAG_OPEN_WRITE |
 				     FU_UDEV_DEVICE_FLAG_OPEN_SYNC);
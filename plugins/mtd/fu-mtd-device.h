@@ -10,3 +10,8 @@
 
 #define FU_TYPE_MTD_DEVICE (fu_mtd_device_get_type())
 G_DECLARE_FINAL_TYPE(FuMtdDevice, fu_mtd_device, FU, MTD_DEVICE, FuUdevDevice)
+
+guint
+fu_mtd_device_get_blocks_written(FuMtdDevice *self);
+guint
+fu_mtd_device_get_blocks_skipped(FuMtdDevice *self);
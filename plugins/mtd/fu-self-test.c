@@ -21,6 +21,7 @@ fu_test_mtd_device_func(void)
 	g_autoptr(FuProgress) progress = fu_progress_new(NULL);
 	g_autoptr(GByteArray) buf = g_byte_array_new();
 	g_autoptr(GBytes) fw2 = NULL;
+	g_autoptr(GBytes) fw3 = NULL;
 	g_autoptr(GBytes) fw = NULL;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GRand) rand = g_rand_new_with_seed(0);
@@ -91,6 +92,29 @@ fu_test_mtd_device_func(void)
 	ret = fu_bytes_compare(fw, fw2, &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+
+	/* change a single byte and only rewrite that block */
+	buf = g_bytes_unref_to_array(g_steal_pointer(&fw));
+	buf->data[0x12345] ^= 0xFF;
+	fw = g_byte_array_free_to_bytes(g_steal_pointer(&buf));
+	fu_device_set_custom_flags(device, "skip-unchanged");
+	fu_progress_reset(progress);
+	ret = fu_device_write_firmware(device, fw, progress, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_mtd_device_get_blocks_written(FU_MTD_DEVICE(device)), ==, 1);
+	g_assert_cmpint(fu_mtd_device_get_blocks_skipped(FU_MTD_DEVICE(device)), >, 0);
+
+	/* dump back */
+	fu_progress_reset(progress);
+	fw3 = fu_device_dump_firmware(device, progress, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(fw3);
+
+	/* verify */
+	ret = fu_bytes_compare(fw, fw3, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 #else
 	g_test_skip("no GUdev support");
 #endif
@@ -40,6 +40,8 @@ struct _FuRedfishBackend {
 
 G_DEFINE_TYPE(FuRedfishBackend, fu_redfish_backend, FU_TYPE_BACKEND)
 
+#define FU_REDFISH_BACKEND_MAX_CONNECTIONS 8
+
 const gchar *
 fu_redfish_backend_get_vendor(FuRedfishBackend *self)
 {
@@ -152,11 +154,12 @@ fu_redfish_backend_coldplug_collection(FuRedfishBackend *self,
 				       GError **error)
 {
 	JsonArray *members = json_object_get_array_member(collection, "Members");
+	g_autoptr(GPtrArray) member_uris = g_ptr_array_new();
+	g_autoptr(GPtrArray) requests = g_ptr_array_new_with_free_func(g_object_unref);
+
 	for (guint i = 0; i < json_array_get_length(members); i++) {
-		JsonObject *json_obj;
 		JsonObject *member_id;
 		const gchar *member_uri;
-		g_autoptr(FuRedfishRequest) request = fu_redfish_backend_request_new(self);
 
 		member_id = json_array_get_object_element(members, i);
 		member_uri = json_object_get_string_member(member_id, "@odata.id");
@@ -167,14 +170,22 @@ fu_redfish_backend_coldplug_collection(FuRedfishBackend *self,
 					    "no @odata.id string");
 			return FALSE;
 		}
+		g_ptr_array_add(member_uris, (gpointer)member_uri);
+		g_ptr_array_add(requests, fu_redfish_backend_request_new(self));
+	}
 
-		/* create the device for the member */
-		if (!fu_redfish_request_perform(request,
-						member_uri,
-						FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
-						error))
-			return FALSE;
-		json_obj = fu_redfish_request_get_json_object(request);
+	/* get all the members at the same time */
+	if (!fu_redfish_request_perform_multi(requests,
+					      member_uris,
+					      FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
+					      FU_REDFISH_BACKEND_MAX_CONNECTIONS,
+					      error))
+		return FALSE;
+
+	/* create the device for each member, in order */
+	for (guint i = 0; i < requests->len; i++) {
+		FuRedfishRequest *request = g_ptr_array_index(requests, i);
+		JsonObject *json_obj = fu_redfish_request_get_json_object(request);
 		if (!fu_redfish_backend_coldplug_member(self, json_obj, error))
 			return FALSE;
 	}
@@ -151,52 +151,61 @@ fu_redfish_request_load_json(FuRedfishRequest *self, GByteArray *buf, GError **e
 	return TRUE;
 }
 
-gboolean
-fu_redfish_request_perform(FuRedfishRequest *self,
-			   const gchar *path,
-			   FuRedfishRequestPerformFlags flags,
-			   GError **error)
+static gboolean
+fu_redfish_request_perform_cached(FuRedfishRequest *self,
+				  const gchar *path,
+				  FuRedfishRequestPerformFlags flags,
+				  gboolean *cached,
+				  GError **error)
 {
-	CURLcode res;
-	g_autofree gchar *str = NULL;
-#ifdef HAVE_LIBCURL_7_62_0
-	g_autoptr(curlptr) uri_str = NULL;
-#else
-	g_autofree gchar *uri_str = NULL;
-#endif
-
-	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
-	g_return_val_if_fail(path != NULL, FALSE);
-	g_return_val_if_fail(self->status_code == 0, FALSE);
-	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	GByteArray *buf;
 
 	/* already in cache? */
-	if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE && self->cache != NULL) {
-		GByteArray *buf = g_hash_table_lookup(self->cache, path);
-		if (buf != NULL) {
-			if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON)
-				return fu_redfish_request_load_json(self, buf, error);
-			g_byte_array_unref(self->buf);
-			self->buf = g_byte_array_ref(buf);
-			return TRUE;
-		}
-	}
+	*cached = FALSE;
+	if ((flags & FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE) == 0 || self->cache == NULL)
+		return TRUE;
+	buf = g_hash_table_lookup(self->cache, path);
+	if (buf == NULL)
+		return TRUE;
+	*cached = TRUE;
+	if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON)
+		return fu_redfish_request_load_json(self, buf, error);
+	g_byte_array_unref(self->buf);
+	self->buf = g_byte_array_ref(buf);
+	return TRUE;
+}
 
-	/* do request */
+static gchar *
+fu_redfish_request_perform_prepare(FuRedfishRequest *self, const gchar *path, GError **error)
+{
 #ifdef HAVE_LIBCURL_7_62_0
+	g_autoptr(curlptr) uri_str = NULL;
 	(void)curl_url_set(self->uri, CURLUPART_PATH, path, 0);
 	(void)curl_url_get(self->uri, CURLUPART_URL, &uri_str, 0);
+	return g_strdup(uri_str);
 #else
-	uri_str = g_strdup_printf("%s%s", self->uri_base, path);
+	g_autofree gchar *uri_str = g_strdup_printf("%s%s", self->uri_base, path);
 	if (curl_easy_setopt(self->curl, CURLOPT_URL, uri_str) != CURLE_OK) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "failed to create message for URI");
-		return FALSE;
+		return NULL;
 	}
+	return g_steal_pointer(&uri_str);
 #endif
-	res = curl_easy_perform(self->curl);
+}
+
+static gboolean
+fu_redfish_request_perform_finish(FuRedfishRequest *self,
+				  const gchar *path,
+				  const gchar *uri_str,
+				  CURLcode res,
+				  FuRedfishRequestPerformFlags flags,
+				  GError **error)
+{
+	g_autofree gchar *str = NULL;
+
 	curl_easy_getinfo(self->curl, CURLINFO_RESPONSE_CODE, &self->status_code);
 	str = g_strndup((const gchar *)self->buf->data, self->buf->len);
 	g_debug("%s: %s [%li]", uri_str, str, self->status_code);
@@ -228,6 +237,165 @@ fu_redfish_request_perform(FuRedfishRequest *self,
 	return TRUE;
 }
 
+gboolean
+fu_redfish_request_perform(FuRedfishRequest *self,
+			   const gchar *path,
+			   FuRedfishRequestPerformFlags flags,
+			   GError **error)
+{
+	CURLcode res;
+	gboolean cached = FALSE;
+	g_autofree gchar *uri_str = NULL;
+
+	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
+	g_return_val_if_fail(path != NULL, FALSE);
+	g_return_val_if_fail(self->status_code == 0, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* already in cache? */
+	if (!fu_redfish_request_perform_cached(self, path, flags, &cached, error))
+		return FALSE;
+	if (cached)
+		return TRUE;
+
+	/* do request */
+	uri_str = fu_redfish_request_perform_prepare(self, path, error);
+	if (uri_str == NULL)
+		return FALSE;
+	res = curl_easy_perform(self->curl);
+	return fu_redfish_request_perform_finish(self, path, uri_str, res, flags, error);
+}
+
+typedef struct {
+	FuRedfishRequest *request; /* noref */
+	const gchar *path;
+	gchar *uri_str;
+} FuRedfishRequestMultiItem;
+
+static void
+fu_redfish_request_multi_item_free(FuRedfishRequestMultiItem *item)
+{
+	g_free(item->uri_str);
+	g_free(item);
+}
+
+static gboolean
+fu_redfish_request_perform_multi_loop(CURLM *multi,
+				      FuRedfishRequestPerformFlags flags,
+				      GError **error)
+{
+	gint running = 0;
+
+	do {
+		CURLMcode mres;
+		CURLMsg *msg;
+		gint msgs_left = 0;
+
+		mres = curl_multi_perform(multi, &running);
+		if (mres != CURLM_OK) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "failed to perform requests: %s",
+				    curl_multi_strerror(mres));
+			return FALSE;
+		}
+
+		/* process any completed transfers */
+		while ((msg = curl_multi_info_read(multi, &msgs_left)) != NULL) {
+			FuRedfishRequestMultiItem *item = NULL;
+			if (msg->msg != CURLMSG_DONE)
+				continue;
+			(void)curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (gchar **)&item);
+			if (!fu_redfish_request_perform_finish(item->request,
+							       item->path,
+							       item->uri_str,
+							       msg->data.result,
+							       flags,
+							       error))
+				return FALSE;
+		}
+
+		/* wait for activity on any of the connections */
+		if (running > 0) {
+			mres = curl_multi_wait(multi, NULL, 0, 1000, NULL);
+			if (mres != CURLM_OK) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "failed to wait for requests: %s",
+					    curl_multi_strerror(mres));
+				return FALSE;
+			}
+		}
+	} while (running > 0);
+
+	/* success */
+	return TRUE;
+}
+
+/* performs multiple GET requests concurrently, as BMCs often have high latency */
+gboolean
+fu_redfish_request_perform_multi(GPtrArray *requests,
+				 GPtrArray *paths,
+				 FuRedfishRequestPerformFlags flags,
+				 guint max_connections,
+				 GError **error)
+{
+	CURLM *multi;
+	gboolean ret;
+	g_autoptr(GPtrArray) items = NULL;
+
+	g_return_val_if_fail(requests != NULL, FALSE);
+	g_return_val_if_fail(paths != NULL, FALSE);
+	g_return_val_if_fail(requests->len == paths->len, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* prepare each request that is not already in the cache */
+	items = g_ptr_array_new_with_free_func((GDestroyNotify)fu_redfish_request_multi_item_free);
+	for (guint i = 0; i < requests->len; i++) {
+		FuRedfishRequest *request = g_ptr_array_index(requests, i);
+		FuRedfishRequestMultiItem *item;
+		const gchar *path = g_ptr_array_index(paths, i);
+		gboolean cached = FALSE;
+		g_autofree gchar *uri_str = NULL;
+
+		g_return_val_if_fail(request->status_code == 0, FALSE);
+		if (!fu_redfish_request_perform_cached(request, path, flags, &cached, error))
+			return FALSE;
+		if (cached)
+			continue;
+		uri_str = fu_redfish_request_perform_prepare(request, path, error);
+		if (uri_str == NULL)
+			return FALSE;
+		item = g_new0(FuRedfishRequestMultiItem, 1);
+		item->request = request;
+		item->path = path;
+		item->uri_str = g_steal_pointer(&uri_str);
+		(void)curl_easy_setopt(request->curl, CURLOPT_PRIVATE, item);
+		g_ptr_array_add(items, item);
+	}
+	if (items->len == 0)
+		return TRUE;
+
+	/* the multi handle queues anything over the connection limit */
+	multi = curl_multi_init();
+	(void)curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, (glong)max_connections);
+	(void)curl_multi_setopt(multi, CURLMOPT_PIPELINING, (glong)CURLPIPE_MULTIPLEX);
+	for (guint i = 0; i < items->len; i++) {
+		FuRedfishRequestMultiItem *item = g_ptr_array_index(items, i);
+		(void)curl_multi_add_handle(multi, item->request->curl);
+	}
+	ret = fu_redfish_request_perform_multi_loop(multi, flags, error);
+	for (guint i = 0; i < items->len; i++) {
+		FuRedfishRequestMultiItem *item = g_ptr_array_index(items, i);
+		(void)curl_multi_remove_handle(multi, item->request->curl);
+		(void)curl_easy_setopt(item->request->curl, CURLOPT_PRIVATE, NULL);
+	}
+	curl_multi_cleanup(multi);
+	return ret;
+}
+
 typedef struct curl_slist _curl_slist;
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(_curl_slist, curl_slist_free_all)
 
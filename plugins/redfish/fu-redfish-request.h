@@ -25,6 +25,12 @@ fu_redfish_request_perform(FuRedfishRequest *self,
 			   FuRedfishRequestPerformFlags flags,
 			   GError **error);
 gboolean
+fu_redfish_request_perform_multi(GPtrArray *requests,
+				 GPtrArray *paths,
+				 FuRedfishRequestPerformFlags flags,
+				 guint max_connections,
+				 GError **error);
+gboolean
 fu_redfish_request_perform_full(FuRedfishRequest *self,
 				const gchar *path,
 				const gchar *request,
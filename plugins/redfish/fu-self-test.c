@@ -85,6 +85,38 @@ fu_test_self_init(FuTest *self)
 	}
 }
 
+static void
+fu_test_redfish_coldplug_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuPlugin) plugin = NULL;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* set REDFISH_LATENCY when running redfish.py to simulate a slow BMC */
+	ret = fu_context_load_quirks(ctx,
+				     FU_QUIRKS_LOAD_FLAG_NO_CACHE | FU_QUIRKS_LOAD_FLAG_NO_VERIFY,
+				     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	plugin = fu_plugin_new_from_gtype(fu_redfish_plugin_get_type(), ctx);
+	ret = fu_plugin_runner_startup(plugin, progress, &error);
+	if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE)) {
+		g_test_skip("no redfish.py running");
+		return;
+	}
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_timer_reset(timer);
+	ret = fu_plugin_runner_coldplug(plugin, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_print("coldplug=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(fu_plugin_get_devices(plugin)->len, ==, 2);
+}
+
 static void
 fu_test_redfish_ipmi_func(void)
 {
@@ -515,5 +547,6 @@ main(int argc, char **argv)
 	g_test_add_data_func("/redfish/smc_plugin{update}", self, fu_test_redfish_smc_update_func);
 	g_test_add_data_func("/redfish/plugin{devices}", self, fu_test_redfish_devices_func);
 	g_test_add_data_func("/redfish/plugin{update}", self, fu_test_redfish_update_func);
+	g_test_add_func("/redfish/plugin{coldplug}", fu_test_redfish_coldplug_func);
 	return g_test_run();
 }
@@ -6,6 +6,8 @@
 # SPDX-License-Identifier: LGPL-2.1+
 
 import json
+import os
+import time
 
 from flask import Flask, Response, request
 
@@ -19,6 +21,9 @@ HARDCODED_PASSWORD = "password2"
 app._percentage545: int = 0
 app._percentage546: int = 0
 
+# simulate a slow BMC, e.g. REDFISH_LATENCY=0.2 for 200ms
+app._latency: float = float(os.environ.get("REDFISH_LATENCY", "0"))
+
 
 def _failure(msg: str, status=400):
     res = {
@@ -27,6 +32,12 @@ def _failure(msg: str, status=400):
     return Response(response=json.dumps(res), status=401, mimetype="application/json")
 
 
+@app.before_request
+def latency():
+    if app._latency:
+        time.sleep(app._latency)
+
+
 @app.route("/redfish/v1/")
 def index():
 
@@ -469,4 +480,4 @@ def startupdate():
 
 
 if __name__ == "__main__":
-    app.run(host="0.0.0.0", port=4661)
+    app.run(host="0.0.0.0", port=4661, threaded=True)
@@ -141,6 +141,32 @@ fu_test_plugin_coldplug(FuPlugin *plugin, FuProgress *progress, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_test_plugin_backend_device_added(FuPlugin *plugin,
+				    FuDevice *device,
+				    FuProgress *progress,
+				    GError **error)
+{
+	const gchar *backend_id = fu_device_get_backend_id(device);
+	gboolean supported = FALSE;
+	g_autofree gchar *guid = fwupd_guid_hash_string(backend_id);
+	g_autoptr(FuDevice) device_new = fu_device_new(fu_plugin_get_context(plugin));
+
+	fu_device_set_backend_id(device_new, backend_id);
+	fu_device_set_physical_id(device_new, backend_id);
+	fu_device_set_name(device_new, "Emulated");
+	fu_device_add_guid(device_new, guid);
+	g_signal_emit_by_name(plugin, "check-supported", guid, &supported);
+	if (supported)
+		fu_device_add_flag(device_new, FWUPD_DEVICE_FLAG_UPDATABLE);
+	fu_plugin_device_add(plugin, device_new);
+
+	/* the device went away straight after being added */
+	if (g_str_has_suffix(backend_id, ":04"))
+		fu_plugin_device_remove(plugin, device_new);
+	return TRUE;
+}
+
 static void
 fu_test_plugin_device_registered(FuPlugin *plugin, FuDevice *device)
 {
@@ -352,4 +378,5 @@ fu_test_plugin_class_init(FuTestPluginClass *klass)
 	plugin_class->startup = fu_test_plugin_startup;
 	plugin_class->coldplug = fu_test_plugin_coldplug;
 	plugin_class->device_registered = fu_test_plugin_device_registered;
+	plugin_class->backend_device_added = fu_test_plugin_backend_device_added;
 }
@@ -8,6 +8,8 @@
 
 #include <fwupdplugin.h>
 
+#include <string.h>
+
 #include "fu-efi-image.h"
 #include "fu-uefi-dbx-common.h"
 
@@ -40,6 +42,165 @@ fu_efi_image_func(void)
 			"e99707d4378140c01eb3f867240d5cc9e237b126d3db0c3b4bbcd3da1720ddff");
 }
 
+static void
+fu_efi_image_not_pe_func(void)
+{
+	g_autofree gchar *checksum = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* rejected before parsing the PE header */
+	checksum = fu_uefi_dbx_get_authenticode_hash(SRCDIR "/README.md", &error);
+	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED);
+	g_assert_null(checksum);
+}
+
+/* the smallest PE32+ image that has an Authenticode checksum */
+static GBytes *
+fu_efi_image_build_test_blob(guint8 seed)
+{
+	guint8 buf[0x200] = {0x0};
+
+	buf[0] = 'M';
+	buf[1] = 'Z';
+	fu_memwrite_uint32(buf + 0x3c, 0x40, G_LITTLE_ENDIAN);	 /* PE header */
+	fu_memwrite_uint32(buf + 0x40, 0x4550, G_LITTLE_ENDIAN); /* PE\0\0 */
+	fu_memwrite_uint16(buf + 0x44, 0x8664, G_LITTLE_ENDIAN); /* AMD64 */
+	fu_memwrite_uint16(buf + 0x54, 0xf0, G_LITTLE_ENDIAN);	 /* optional header size */
+	fu_memwrite_uint16(buf + 0x58, 0x020b, G_LITTLE_ENDIAN); /* PE32+ */
+	fu_memwrite_uint32(buf + 0x94, sizeof(buf), G_LITTLE_ENDIAN); /* size of headers */
+	for (guint i = 0x100; i < sizeof(buf); i++)
+		buf[i] = seed;
+	return g_bytes_new(buf, sizeof(buf));
+}
+
+static void
+fu_uefi_dbx_validate_path_func(void)
+{
+	gboolean ret;
+	const gchar *esp_path = "/tmp/fwupd-self-test/uefi-dbx";
+	const guint8 sig_type[] = {0x26, 0x16, 0xC4, 0xC1, 0x4C, 0x50, 0x92, 0x40,
+				   0xAC, 0xA9, 0x41, 0xF9, 0x36, 0x93, 0x43, 0x28};
+	g_autofree gchar *checksum_hit = NULL;
+	g_autofree gchar *fn_hit = NULL;
+	g_autofree gchar *fn_txt = g_build_filename(esp_path, "README.txt", NULL);
+	g_autoptr(FuFirmware) siglist_empty = fu_efi_signature_list_new();
+	g_autoptr(FuFirmware) siglist = fu_efi_signature_list_new();
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* more PE files than worker threads, and a file that is not PE */
+	if (g_file_test(esp_path, G_FILE_TEST_EXISTS)) {
+		ret = fu_path_rmtree(esp_path, &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+	for (guint i = 0; i < 64; i++) {
+		g_autofree gchar *fn = g_strdup_printf("%s/EFI/BOOT/file%02u.efi", esp_path, i);
+		g_autoptr(GBytes) blob_tmp = fu_efi_image_build_test_blob(i);
+		ret = fu_path_mkdir_parent(fn, &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+		ret = fu_bytes_set_contents(fn, blob_tmp, &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+	ret = g_file_set_contents(fn_txt, "hello world", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* nothing is blocked by an empty dbx */
+	ret = fu_uefi_dbx_signature_list_validate_path(FU_EFI_SIGNATURE_LIST(siglist_empty),
+						       esp_path,
+						       &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* EFI_SIGNATURE_LIST with the checksum of one file, computed in this thread */
+	fn_hit = g_strdup_printf("%s/EFI/BOOT/file%02u.efi", esp_path, (guint)42);
+	checksum_hit = fu_uefi_dbx_get_authenticode_hash(fn_hit, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(checksum_hit);
+	g_assert_cmpint(strlen(checksum_hit), ==, 64);
+	g_byte_array_append(buf, sig_type, sizeof(sig_type));
+	fu_byte_array_append_uint32(buf, 0x1c + 48, G_LITTLE_ENDIAN);
+	fu_byte_array_append_uint32(buf, 0x0, G_LITTLE_ENDIAN);
+	fu_byte_array_append_uint32(buf, 48, G_LITTLE_ENDIAN);
+	fu_byte_array_set_size(buf, buf->len + 16, 0x0); /* owner */
+	for (guint i = 0; i < 32; i++) {
+		fu_byte_array_append_uint8(buf,
+					   (g_ascii_xdigit_value(checksum_hit[i * 2]) << 4) |
+					       g_ascii_xdigit_value(checksum_hit[i * 2 + 1]));
+	}
+	blob = g_bytes_new(buf->data, buf->len);
+	ret = fu_firmware_parse(siglist, blob, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the file hashed in a worker thread is found */
+	ret = fu_uefi_dbx_signature_list_validate_path(FU_EFI_SIGNATURE_LIST(siglist),
+						       esp_path,
+						       &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NEEDS_USER_ACTION);
+	g_assert_false(ret);
+	g_assert_nonnull(g_strstr_len(error->message, -1, fn_hit));
+}
+
+static void
+fu_efi_signature_list_lookup_func(void)
+{
+	const guint entries = 4000;
+	const guint lookups = 500;
+	const gchar *suffix = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa";
+	const guint8 sig_type[] = {0x26, 0x16, 0xC4, 0xC1, 0x4C, 0x50, 0x92, 0x40,
+				   0xAC, 0xA9, 0x41, 0xF9, 0x36, 0x93, 0x43, 0x28};
+	gboolean ret;
+	g_autofree gchar *checksum_hit = g_strdup_printf("%08x%s", (guint)5, suffix);
+	g_autoptr(FuFirmware) siglist = fu_efi_signature_list_new();
+	g_autoptr(FuFirmware) img = NULL;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* EFI_SIGNATURE_LIST of SHA256 hashes, like a large dbx */
+	g_byte_array_append(buf, sig_type, sizeof(sig_type));
+	fu_byte_array_append_uint32(buf, 0x1c + entries * 48, G_LITTLE_ENDIAN);
+	fu_byte_array_append_uint32(buf, 0x0, G_LITTLE_ENDIAN);
+	fu_byte_array_append_uint32(buf, 48, G_LITTLE_ENDIAN);
+	for (guint i = 0; i < entries; i++) {
+		fu_byte_array_set_size(buf, buf->len + 16, 0x0); /* owner */
+		fu_byte_array_append_uint32(buf, i, G_BIG_ENDIAN);
+		fu_byte_array_set_size(buf, buf->len + 28, 0xAA);
+	}
+	blob = g_bytes_new(buf->data, buf->len);
+	ret = fu_firmware_parse(siglist, blob, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* look up each "file on the ESP", most of which are not in the list */
+	g_timer_reset(timer);
+	for (guint i = 0; i < lookups; i++) {
+		g_autofree gchar *checksum = g_strdup_printf("%08x%s", i * 10, suffix);
+		g_autoptr(FuFirmware) img_tmp =
+		    fu_firmware_get_image_by_checksum(siglist, checksum, NULL);
+		g_assert_true((img_tmp != NULL) == (i * 10 < entries));
+	}
+	g_print("lookup=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* the index is dropped when an image is removed */
+	img = fu_firmware_get_image_by_checksum(siglist, checksum_hit, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(img);
+	ret = fu_firmware_remove_image(siglist, img, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_clear_object(&img);
+	img = fu_firmware_get_image_by_checksum(siglist, checksum_hit, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(img);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -52,5 +213,8 @@ main(int argc, char **argv)
 
 	/* tests go here */
 	g_test_add_func("/uefi-dbx/image", fu_efi_image_func);
+	g_test_add_func("/uefi-dbx/image{not-pe}", fu_efi_image_not_pe_func);
+	g_test_add_func("/uefi-dbx/validate-path", fu_uefi_dbx_validate_path_func);
+	g_test_add_func("/uefi-dbx/signature-list{lookup}", fu_efi_signature_list_lookup_func);
 	return g_test_run();
 }
@@ -11,9 +11,26 @@
 #include "fu-efi-image.h"
 #include "fu-uefi-dbx-common.h"
 
+typedef struct {
+	gchar *fn;
+	gchar *checksum;
+	GError *error;
+} FuUefiDbxHashItem;
+
+static void
+fu_uefi_dbx_hash_item_free(FuUefiDbxHashItem *item)
+{
+	g_free(item->fn);
+	g_free(item->checksum);
+	if (item->error != NULL)
+		g_error_free(item->error);
+	g_free(item);
+}
+
 gchar *
 fu_uefi_dbx_get_authenticode_hash(const gchar *fn, GError **error)
 {
+	const gchar *buf;
 	g_autoptr(FuEfiImage) img = NULL;
 	g_autoptr(GBytes) bytes = NULL;
 	g_autoptr(GMappedFile) mmap = NULL;
@@ -22,6 +39,16 @@ fu_uefi_dbx_get_authenticode_hash(const gchar *fn, GError **error)
 	mmap = g_mapped_file_new(fn, FALSE, error);
 	if (mmap == NULL)
 		return NULL;
+
+	/* only the first page is read for files that are not PE */
+	buf = g_mapped_file_get_contents(mmap);
+	if (g_mapped_file_get_length(mmap) < 2 || buf[0] != 'M' || buf[1] != 'Z') {
+		g_set_error_literal(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_NOT_SUPPORTED,
+				    "no DOS header magic");
+		return NULL;
+	}
 	bytes = g_mapped_file_get_bytes(mmap);
 
 	img = fu_efi_image_new(bytes, error);
@@ -31,46 +58,69 @@ fu_uefi_dbx_get_authenticode_hash(const gchar *fn, GError **error)
 	return g_strdup(fu_efi_image_get_checksum(img));
 }
 
-static gboolean
-fu_uefi_dbx_signature_list_validate_volume(FuEfiSignatureList *siglist,
-					   FuVolume *esp,
-					   GError **error)
+static void
+fu_uefi_dbx_hash_item_worker_cb(gpointer data, gpointer user_data)
+{
+	FuUefiDbxHashItem *item = (FuUefiDbxHashItem *)data;
+	item->checksum = fu_uefi_dbx_get_authenticode_hash(item->fn, &item->error);
+}
+
+/* the files are hashed in parallel, but checked in order so the reported file is stable */
+gboolean
+fu_uefi_dbx_signature_list_validate_path(FuEfiSignatureList *siglist,
+					 const gchar *path,
+					 GError **error)
 {
-	g_autofree gchar *esp_path = NULL;
+	GThreadPool *pool;
 	g_autoptr(GPtrArray) files = NULL;
+	g_autoptr(GPtrArray) items = NULL;
 
 	/* get list of files contained in the ESP */
-	esp_path = fu_volume_get_mount_point(esp);
-	if (esp_path == NULL)
-		return TRUE;
-	files = fu_path_get_files(esp_path, error);
+	files = fu_path_get_files(path, error);
 	if (files == NULL)
 		return FALSE;
 
-	/* verify each file does not exist in the ESP */
+	/* get checksum of each file */
+	items = g_ptr_array_new_with_free_func((GDestroyNotify)fu_uefi_dbx_hash_item_free);
+	pool = g_thread_pool_new(fu_uefi_dbx_hash_item_worker_cb,
+				 NULL,
+				 (gint)g_get_num_processors(),
+				 FALSE,
+				 error);
+	if (pool == NULL)
+		return FALSE;
 	for (guint i = 0; i < files->len; i++) {
 		const gchar *fn = g_ptr_array_index(files, i);
-		g_autofree gchar *checksum = NULL;
+		FuUefiDbxHashItem *item = g_new0(FuUefiDbxHashItem, 1);
+		item->fn = g_strdup(fn);
+		g_ptr_array_add(items, item);
+		if (!g_thread_pool_push(pool, item, error)) {
+			g_thread_pool_free(pool, FALSE, TRUE);
+			return FALSE;
+		}
+	}
+	g_thread_pool_free(pool, FALSE, TRUE);
+
+	/* verify each file does not exist in the ESP */
+	for (guint i = 0; i < items->len; i++) {
+		FuUefiDbxHashItem *item = g_ptr_array_index(items, i);
 		g_autoptr(FuFirmware) img = NULL;
-		g_autoptr(GError) error_local = NULL;
 
-		/* get checksum of file */
-		checksum = fu_uefi_dbx_get_authenticode_hash(fn, &error_local);
-		if (checksum == NULL) {
-			g_debug("failed to get checksum for %s: %s", fn, error_local->message);
+		if (item->error != NULL) {
+			g_debug("failed to get checksum for %s: %s", item->fn, item->error->message);
 			continue;
 		}
 
 		/* Authenticode signature is present in dbx! */
-		g_debug("fn=%s, checksum=%s", fn, checksum);
-		img = fu_firmware_get_image_by_checksum(FU_FIRMWARE(siglist), checksum, NULL);
+		g_debug("fn=%s, checksum=%s", item->fn, item->checksum);
+		img = fu_firmware_get_image_by_checksum(FU_FIRMWARE(siglist), item->checksum, NULL);
 		if (img != NULL) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NEEDS_USER_ACTION,
 				    "%s Authenticode checksum [%s] is present in dbx",
-				    fn,
-				    checksum);
+				    item->fn,
+				    item->checksum);
 			return FALSE;
 		}
 	}
@@ -88,6 +138,7 @@ fu_uefi_dbx_signature_list_validate(FuContext *ctx, FuEfiSignatureList *siglist,
 		return FALSE;
 	for (guint i = 0; i < volumes->len; i++) {
 		FuVolume *esp = g_ptr_array_index(volumes, i);
+		g_autofree gchar *esp_path = NULL;
 		g_autoptr(FuDeviceLocker) locker = NULL;
 		g_autoptr(GError) error_local = NULL;
 		locker = fu_volume_locker(esp, &error_local);
@@ -99,7 +150,10 @@ fu_uefi_dbx_signature_list_validate(FuContext *ctx, FuEfiSignatureList *siglist,
 			g_debug("failed to mount ESP: %s", error_local->message);
 			continue;
 		}
-		if (!fu_uefi_dbx_signature_list_validate_volume(siglist, esp, error))
+		esp_path = fu_volume_get_mount_point(esp);
+		if (esp_path == NULL)
+			continue;
+		if (!fu_uefi_dbx_signature_list_validate_path(siglist, esp_path, error))
 			return FALSE;
 	}
 	return TRUE;
@@ -11,4 +11,8 @@
 gchar *
 fu_uefi_dbx_get_authenticode_hash(const gchar *fn, GError **error);
 gboolean
+fu_uefi_dbx_signature_list_validate_path(FuEfiSignatureList *siglist,
+					 const gchar *path,
+					 GError **error);
+gboolean
 fu_uefi_dbx_signature_list_validate(FuContext *ctx, FuEfiSignatureList *siglist, GError **error);
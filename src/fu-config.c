@@ -12,6 +12,9 @@
 
 #include "fu-config.h"
 
+/* more threads than this just contend on the plugin locks */
+#define FU_CONFIG_COLDPLUG_THREADS_MAX 64
+
 enum { SIGNAL_CHANGED, SIGNAL_LAST };
 
 static guint signals[SIGNAL_LAST] = {0};
@@ -31,6 +34,7 @@ struct _FuConfig {
 	GArray *trusted_uids;	      /* (elementy type guint64) */
 	guint64 archive_size_max;
 	guint idle_timeout;
+	guint coldplug_threads;
 	gchar *host_bkc;
 	gchar *esp_location;
 	gboolean update_motd;
@@ -54,6 +58,7 @@ static gboolean
 fu_config_reload(FuConfig *self, GError **error)
 {
 	guint64 archive_size_max;
+	guint64 coldplug_threads = 0;
 	guint idle_timeout;
 	g_auto(GStrv) approved_firmware = NULL;
 	g_auto(GStrv) blocked_firmware = NULL;
@@ -67,6 +72,7 @@ fu_config_reload(FuConfig *self, GError **error)
 	g_autoptr(GKeyFile) keyfile = g_key_file_new();
 	g_autoptr(GError) error_disabled_plugins = NULL;
 	g_autoptr(GError) error_timeout = NULL;
+	g_autoptr(GError) error_coldplug_threads = NULL;
 	g_autoptr(GError) error_update_motd = NULL;
 	g_autoptr(GError) error_ignore_power = NULL;
 	g_autoptr(GError) error_only_trusted = NULL;
@@ -200,6 +206,29 @@ fu_config_reload(FuConfig *self, GError **error)
 	else if (error_timeout != NULL)
 		self->idle_timeout = 7200;
 
+	/* get the number of threads to use when probing devices at startup */
+	coldplug_threads =
+	    g_key_file_get_uint64(keyfile, "fwupd", "ColdplugThreads", &error_coldplug_threads);
+	if (error_coldplug_threads != NULL) {
+		if (!g_error_matches(error_coldplug_threads,
+				     G_KEY_FILE_ERROR,
+				     G_KEY_FILE_ERROR_KEY_NOT_FOUND) &&
+		    !g_error_matches(error_coldplug_threads,
+				     G_KEY_FILE_ERROR,
+				     G_KEY_FILE_ERROR_GROUP_NOT_FOUND)) {
+			g_warning("failed to read ColdplugThreads key: %s",
+				  error_coldplug_threads->message);
+		}
+		self->coldplug_threads = 0;
+	} else if (coldplug_threads > FU_CONFIG_COLDPLUG_THREADS_MAX) {
+		g_warning("ColdplugThreads %" G_GUINT64_FORMAT " too large, using %u",
+			  coldplug_threads,
+			  (guint)FU_CONFIG_COLDPLUG_THREADS_MAX);
+		self->coldplug_threads = FU_CONFIG_COLDPLUG_THREADS_MAX;
+	} else {
+		self->coldplug_threads = coldplug_threads;
+	}
+
 	/* get the domains to run in verbose */
 	domains = g_key_file_get_string(keyfile, "fwupd", "VerboseDomains", NULL);
 	if (domains != NULL && domains[0] != '\0')
@@ -369,6 +398,13 @@ fu_config_get_idle_timeout(FuConfig *self)
 	return self->idle_timeout;
 }
 
+guint
+fu_config_get_coldplug_threads(FuConfig *self)
+{
+	g_return_val_if_fail(FU_IS_CONFIG(self), 0);
+	return self->coldplug_threads;
+}
+
 GPtrArray *
 fu_config_get_disabled_devices(FuConfig *self)
 {
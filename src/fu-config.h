@@ -22,6 +22,8 @@ guint64
 fu_config_get_archive_size_max(FuConfig *self);
 guint
 fu_config_get_idle_timeout(FuConfig *self);
+guint
+fu_config_get_coldplug_threads(FuConfig *self);
 GPtrArray *
 fu_config_get_disabled_devices(FuConfig *self);
 GPtrArray *
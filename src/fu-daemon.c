@@ -26,12 +26,19 @@
 
 #include "fu-bios-settings-private.h"
 #include "fu-daemon.h"
+#include "fu-device-changed-queue.h"
 #include "fu-device-private.h"
 #include "fu-engine.h"
 #include "fu-polkit-authority.h"
 #include "fu-release.h"
 #include "fu-security-attrs-private.h"
 
+/* merge repeated DeviceChanged signals for the same device within this window */
+#define FU_DAEMON_DEVICE_CHANGED_DELAY 100 /* ms */
+
+/* emit the Changed signal at most once in this window */
+#define FU_DAEMON_CHANGED_DELAY 500 /* ms */
+
 static void
 fu_daemon_finalize(GObject *obj);
 
@@ -52,6 +59,11 @@ struct _FuDaemon {
 	gboolean pending_stop;
 	FuDaemonMachineKind machine_kind;
 	GPtrArray *system_inhibits;
+	FuDeviceChangedQueue *device_changed_queue;
+	guint changed_id;
+	gboolean changed_pending;
+	guint changed_emitted;
+	guint changed_suppressed;
 };
 
 G_DEFINE_TYPE(FuDaemon, fu_daemon, G_TYPE_OBJECT)
@@ -92,11 +104,8 @@ fu_daemon_machine_kind_from_string(const gchar *kind)
 }
 
 static void
-fu_daemon_engine_changed_cb(FuEngine *engine, FuDaemon *self)
+fu_daemon_emit_changed(FuDaemon *self)
 {
-	/* not yet connected */
-	if (self->connection == NULL)
-		return;
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
 				      FWUPD_DBUS_PATH,
@@ -104,10 +113,49 @@ fu_daemon_engine_changed_cb(FuEngine *engine, FuDaemon *self)
 				      "Changed",
 				      NULL,
 				      NULL);
+	self->changed_emitted++;
+	g_debug("emitted %u Changed signals, suppressed %u",
+		self->changed_emitted,
+		self->changed_suppressed);
+}
+
+static gboolean
+fu_daemon_changed_cb(gpointer user_data)
+{
+	FuDaemon *self = FU_DAEMON(user_data);
+
+	/* nothing changed in the window */
+	if (!self->changed_pending || self->connection == NULL) {
+		self->changed_id = 0;
+		return G_SOURCE_REMOVE;
+	}
+
+	/* emit the last change, and wait for another window */
+	fu_daemon_emit_changed(self);
+	self->changed_pending = FALSE;
+	return G_SOURCE_CONTINUE;
 }
 
 static void
-fu_daemon_engine_device_added_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+fu_daemon_engine_changed_cb(FuEngine *engine, FuDaemon *self)
+{
+	/* not yet connected */
+	if (self->connection == NULL)
+		return;
+
+	/* already emitted recently, so emit once when the window closes */
+	if (self->changed_id != 0) {
+		if (self->changed_pending)
+			self->changed_suppressed++;
+		self->changed_pending = TRUE;
+		return;
+	}
+	fu_daemon_emit_changed(self);
+	self->changed_id = g_timeout_add(FU_DAEMON_CHANGED_DELAY, fu_daemon_changed_cb, self);
+}
+
+static void
+fu_daemon_device_changed_queue_cb(FuDeviceChangedQueue *queue, FuDevice *device, FuDaemon *self)
 {
 	GVariant *val;
 
@@ -119,47 +167,117 @@ fu_daemon_engine_device_added_cb(FuEngine *engine, FuDevice *device, FuDaemon *s
 				      NULL,
 				      FWUPD_DBUS_PATH,
 				      FWUPD_DBUS_INTERFACE,
-				      "DeviceAdded",
+				      "DeviceChanged",
 				      g_variant_new_tuple(&val, 1),
 				      NULL);
 }
 
 static void
-fu_daemon_engine_device_removed_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+fu_daemon_device_changed_flush(FuDaemon *self)
+{
+	fu_device_changed_queue_flush(self->device_changed_queue);
+}
+
+/* the reply must not overtake the DeviceChanged signals for changes made by the method */
+static void
+fu_daemon_method_invocation_return_value(FuDaemon *self,
+					 GDBusMethodInvocation *invocation,
+					 GVariant *parameters)
+{
+	fu_daemon_device_changed_flush(self);
+	g_dbus_method_invocation_return_value(invocation, parameters);
+}
+
+static void
+fu_daemon_method_invocation_return_gerror(FuDaemon *self,
+					  GDBusMethodInvocation *invocation,
+					  const GError *error)
+{
+	fu_daemon_device_changed_flush(self);
+	g_dbus_method_invocation_return_gerror(invocation, error);
+}
+
+static void
+fu_daemon_method_invocation_return_error_literal(FuDaemon *self,
+						 GDBusMethodInvocation *invocation,
+						 GQuark domain,
+						 gint code,
+						 const gchar *message)
+{
+	fu_daemon_device_changed_flush(self);
+	g_dbus_method_invocation_return_error_literal(invocation, domain, code, message);
+}
+
+G_GNUC_PRINTF(5, 6)
+static void
+fu_daemon_method_invocation_return_error(FuDaemon *self,
+					 GDBusMethodInvocation *invocation,
+					 GQuark domain,
+					 gint code,
+					 const gchar *format,
+					 ...)
+{
+	va_list args;
+
+	fu_daemon_device_changed_flush(self);
+	va_start(args, format);
+	g_dbus_method_invocation_return_error_valist(invocation, domain, code, format, args);
+	va_end(args);
+}
+
+static void
+fu_daemon_engine_device_added_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
 {
 	GVariant *val;
 
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
+
+	/* clients have to see the changes in order */
+	fu_daemon_device_changed_flush(self);
 	val = fwupd_device_to_variant(FWUPD_DEVICE(device));
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
 				      FWUPD_DBUS_PATH,
 				      FWUPD_DBUS_INTERFACE,
-				      "DeviceRemoved",
+				      "DeviceAdded",
 				      g_variant_new_tuple(&val, 1),
 				      NULL);
 }
 
 static void
-fu_daemon_engine_device_changed_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+fu_daemon_engine_device_removed_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
 {
 	GVariant *val;
 
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
+
+	/* clients have to see the changes in order */
+	fu_daemon_device_changed_flush(self);
 	val = fwupd_device_to_variant(FWUPD_DEVICE(device));
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
 				      FWUPD_DBUS_PATH,
 				      FWUPD_DBUS_INTERFACE,
-				      "DeviceChanged",
+				      "DeviceRemoved",
 				      g_variant_new_tuple(&val, 1),
 				      NULL);
 }
 
+static void
+fu_daemon_engine_device_changed_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
+{
+	/* not yet connected */
+	if (self->connection == NULL)
+		return;
+
+	/* the earlier change is emitted with the latest state */
+	fu_device_changed_queue_add(self->device_changed_queue, device);
+}
+
 static void
 fu_daemon_engine_device_request_cb(FuEngine *engine, FwupdRequest *request, FuDaemon *self)
 {
@@ -168,6 +286,9 @@ fu_daemon_engine_device_request_cb(FuEngine *engine, FwupdRequest *request, FuDa
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
+
+	/* the request may refer to the changed device state */
+	fu_daemon_device_changed_flush(self);
 	val = fwupd_request_to_variant(FWUPD_REQUEST(request));
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
@@ -416,18 +537,18 @@ fu_daemon_authorize_unlock_cb(GObject *source, GAsyncResult *res, gpointer user_
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* authenticated */
 	if (!fu_engine_unlock(helper->self->engine, helper->device_id, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -441,7 +562,7 @@ fu_daemon_authorize_get_bios_settings_cb(GObject *source, GAsyncResult *res, gpo
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -449,7 +570,7 @@ fu_daemon_authorize_get_bios_settings_cb(GObject *source, GAsyncResult *res, gpo
 	ctx = fu_engine_get_context(helper->self->engine);
 	attrs = fu_context_get_bios_settings(ctx);
 	val = fu_bios_settings_to_variant(attrs, TRUE);
-	g_dbus_method_invocation_return_value(helper->invocation, val);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, val);
 }
 
 static void
@@ -460,7 +581,7 @@ fu_daemon_authorize_set_bios_settings_cb(GObject *source, GAsyncResult *res, gpo
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -469,11 +590,11 @@ fu_daemon_authorize_set_bios_settings_cb(GObject *source, GAsyncResult *res, gpo
 					    helper->bios_settings,
 					    FALSE,
 					    &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -484,7 +605,7 @@ fu_daemon_authorize_set_approved_firmware_cb(GObject *source, GAsyncResult *res,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -493,7 +614,7 @@ fu_daemon_authorize_set_approved_firmware_cb(GObject *source, GAsyncResult *res,
 		const gchar *csum = g_ptr_array_index(helper->checksums, i);
 		fu_engine_add_approved_firmware(helper->self->engine, csum);
 	}
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -504,16 +625,16 @@ fu_daemon_authorize_set_blocked_firmware_cb(GObject *source, GAsyncResult *res,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
 	if (!fu_engine_set_blocked_firmware(helper->self->engine, helper->checksums, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -525,19 +646,21 @@ fu_daemon_authorize_self_sign_cb(GObject *source, GAsyncResult *res, gpointer us
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* authenticated */
 	sig = fu_engine_self_sign(helper->self->engine, helper->value, helper->flags, &error);
 	if (sig == NULL) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, g_variant_new("(s)", sig));
+	fu_daemon_method_invocation_return_value(helper->self,
+						 helper->invocation,
+						 g_variant_new("(s)", sig));
 }
 
 static void
@@ -548,17 +671,17 @@ fu_daemon_modify_config_cb(GObject *source, GAsyncResult *res, gpointer user_dat
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	if (!fu_engine_modify_config(helper->self->engine, helper->key, helper->value, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -588,7 +711,7 @@ fu_daemon_authorize_activate_cb(GObject *source, GAsyncResult *res, gpointer use
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -605,12 +728,12 @@ fu_daemon_authorize_activate_cb(GObject *source, GAsyncResult *res, gpointer use
 
 	/* authenticated */
 	if (!fu_engine_activate(helper->self->engine, helper->device_id, progress, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -622,7 +745,7 @@ fu_daemon_authorize_verify_update_cb(GObject *source, GAsyncResult *res, gpointe
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -639,12 +762,12 @@ fu_daemon_authorize_verify_update_cb(GObject *source, GAsyncResult *res, gpointe
 
 	/* authenticated */
 	if (!fu_engine_verify_update(helper->self->engine, helper->device_id, progress, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -655,7 +778,7 @@ fu_daemon_authorize_modify_remote_cb(GObject *source, GAsyncResult *res, gpointe
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -665,12 +788,38 @@ fu_daemon_authorize_modify_remote_cb(GObject *source, GAsyncResult *res, gpointe
 				     helper->key,
 				     helper->value,
 				     &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
+		return;
+	}
+
+	/* success */
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
+}
+
+static void
+fu_daemon_authorize_touch_metadata_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	g_autoptr(FuMainAuthHelper) helper = (FuMainAuthHelper *)user_data;
+	g_autoptr(GError) error = NULL;
+
+	/* get result */
+	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
+		return;
+	}
+
+	/* authenticated */
+	if (!fu_engine_touch_metadata(helper->self->engine,
+				      helper->remote_id,
+				      helper->value,
+				      &error)) {
+		g_prefix_error(&error, "Failed to touch metadata for %s: ", helper->remote_id);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 #ifdef HAVE_GIO_UNIX
@@ -685,7 +834,7 @@ fu_daemon_authorize_install_cb(GObject *source, GAsyncResult *res, gpointer user
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -734,6 +883,7 @@ fu_daemon_authorize_install_queue(FuMainAuthHelper *helper_ref)
 
 	/* all authenticated, so install all the things */
 	self->update_in_progress = TRUE;
+	fu_device_changed_queue_set_immediate(self->device_changed_queue, TRUE);
 	ret = fu_engine_install_releases(helper->self->engine,
 					 helper->request,
 					 helper->releases,
@@ -741,16 +891,17 @@ fu_daemon_authorize_install_queue(FuMainAuthHelper *helper_ref)
 					 progress,
 					 helper->flags,
 					 &error);
+	fu_device_changed_queue_set_immediate(self->device_changed_queue, FALSE);
 	self->update_in_progress = FALSE;
 	if (self->pending_stop)
 		g_main_loop_quit(self->loop);
 	if (!ret) {
-		g_dbus_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 #endif /* HAVE_GIO_UNIX */
 
@@ -1085,7 +1236,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 	/* build request */
 	request = fu_daemon_create_request(self, sender, &error);
 	if (request == NULL) {
-		g_dbus_method_invocation_return_gerror(invocation, error);
+		fu_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
 	if (fu_engine_request_has_device_flag(request, FWUPD_DEVICE_FLAG_TRUSTED))
@@ -1099,21 +1250,21 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_debug("Called %s()", method_name);
 		devices = fu_engine_get_devices(self->engine, &error);
 		if (devices == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		val = fu_daemon_device_array_to_variant(self, request, devices, &error);
 		if (val == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
-		g_dbus_method_invocation_return_value(invocation, val);
+		fu_daemon_method_invocation_return_value(self, invocation, val);
 		return;
 	}
 	if (g_strcmp0(method_name, "GetPlugins") == 0) {
 		g_debug("Called %s()", method_name);
 		val = fu_daemon_plugin_array_to_variant(fu_engine_get_plugins(self->engine));
-		g_dbus_method_invocation_return_value(invocation, val);
+		fu_daemon_method_invocation_return_value(self, invocation, val);
 		return;
 	}
 	if (g_strcmp0(method_name, "GetReleases") == 0) {
@@ -1122,16 +1273,16 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_variant_get(parameters, "(&s)", &device_id);
 		g_debug("Called %s(%s)", method_name, device_id);
 		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		releases = fu_engine_get_releases(self->engine, request, device_id, &error);
 		if (releases == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		val = fu_daemon_release_array_to_variant(releases);
-		g_dbus_method_invocation_return_value(invocation, val);
+		fu_daemon_method_invocation_return_value(self, invocation, val);
 		return;
 	}
 	if (g_strcmp0(method_name, "GetApprovedFirmware") == 0) {
@@ -1143,7 +1294,9 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 			g_variant_builder_add_value(&builder, g_variant_new_string(checksum));
 		}
 		val = g_variant_builder_end(&builder);
-		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+		fu_daemon_method_invocation_return_value(self,
+							 invocation,
+							 g_variant_new_tuple(&val, 1));
 		return;
 	}
 	if (g_strcmp0(method_name, "GetBlockedFirmware") == 0) {
@@ -1155,7 +1308,9 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 			g_variant_builder_add_value(&builder, g_variant_new_string(checksum));
 		}
 		val = g_variant_builder_end(&builder);
-		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+		fu_daemon_method_invocation_return_value(self,
+							 invocation,
+							 g_variant_new_tuple(&val, 1));
 		return;
 	}
 	if (g_strcmp0(method_name, "GetReportMetadata") == 0) {
@@ -1167,7 +1322,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 
 		metadata = fu_engine_get_report_metadata(self->engine, &error);
 		if (metadata == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		g_variant_builder_init(&builder, G_VARIANT_TYPE("a{ss}"));
@@ -1176,7 +1331,9 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 			g_variant_builder_add_value(&builder, g_variant_new("{ss}", key, value));
 		}
 		val = g_variant_builder_end(&builder);
-		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+		fu_daemon_method_invocation_return_value(self,
+							 invocation,
+							 g_variant_new_tuple(&val, 1));
 		return;
 	}
 	if (g_strcmp0(method_name, "SetApprovedFirmware") == 0) {
@@ -1235,14 +1392,16 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 	}
 	if (g_strcmp0(method_name, "Quit") == 0) {
 		if (!fu_engine_request_has_device_flag(request, FWUPD_DEVICE_FLAG_TRUSTED)) {
-			g_dbus_method_invocation_return_error_literal(invocation,
-								      FWUPD_ERROR,
-								      FWUPD_ERROR_PERMISSION_DENIED,
-								      "Permission denied");
+			fu_daemon_method_invocation_return_error_literal(
+			    self,
+			    invocation,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_PERMISSION_DENIED,
+			    "Permission denied");
 			return;
 		}
 		fu_daemon_schedule_process_quit(self);
-		g_dbus_method_invocation_return_value(invocation, NULL);
+		fu_daemon_method_invocation_return_value(self, invocation, NULL);
 		return;
 	}
 	if (g_strcmp0(method_name, "SelfSign") == 0) {
@@ -1289,16 +1448,16 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_variant_get(parameters, "(&s)", &device_id);
 		g_debug("Called %s(%s)", method_name, device_id);
 		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		releases = fu_engine_get_downgrades(self->engine, request, device_id, &error);
 		if (releases == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		val = fu_daemon_release_array_to_variant(releases);
-		g_dbus_method_invocation_return_value(invocation, val);
+		fu_daemon_method_invocation_return_value(self, invocation, val);
 		return;
 	}
 	if (g_strcmp0(method_name, "GetUpgrades") == 0) {
@@ -1307,16 +1466,16 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_variant_get(parameters, "(&s)", &device_id);
 		g_debug("Called %s(%s)", method_name, device_id);
 		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		releases = fu_engine_get_upgrades(self->engine, request, device_id, &error);
 		if (releases == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		val = fu_daemon_release_array_to_variant(releases);
-		g_dbus_method_invocation_return_value(invocation, val);
+		fu_daemon_method_invocation_return_value(self, invocation, val);
 		return;
 	}
 	if (g_strcmp0(method_name, "GetRemotes") == 0) {
@@ -1324,11 +1483,11 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_debug("Called %s()", method_name);
 		remotes = fu_engine_get_remotes(self->engine, &error);
 		if (remotes == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		val = fu_daemon_remote_array_to_variant(remotes);
-		g_dbus_method_invocation_return_value(invocation, val);
+		fu_daemon_method_invocation_return_value(self, invocation, val);
 		return;
 	}
 	if (g_strcmp0(method_name, "GetHistory") == 0) {
@@ -1336,28 +1495,30 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_debug("Called %s()", method_name);
 		devices = fu_engine_get_history(self->engine, &error);
 		if (devices == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		val = fu_daemon_device_array_to_variant(self, request, devices, &error);
 		if (val == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
-		g_dbus_method_invocation_return_value(invocation, val);
+		fu_daemon_method_invocation_return_value(self, invocation, val);
 		return;
 	}
 	if (g_strcmp0(method_name, "GetHostSecurityAttrs") == 0) {
 		g_autoptr(FuSecurityAttrs) attrs = NULL;
 		g_debug("Called %s()", method_name);
 #ifndef HAVE_HSI
-		g_dbus_method_invocation_return_error_literal(invocation,
-							      FWUPD_ERROR,
-							      FWUPD_ERROR_NOT_SUPPORTED,
-							      "HSI support not enabled");
+		fu_daemon_method_invocation_return_error_literal(self,
+								 invocation,
+								 FWUPD_ERROR,
+								 FWUPD_ERROR_NOT_SUPPORTED,
+								 "HSI support not enabled");
 #else
 		if (self->machine_kind != FU_DAEMON_MACHINE_KIND_PHYSICAL) {
-			g_dbus_method_invocation_return_error_literal(
+			fu_daemon_method_invocation_return_error_literal(
+			    self,
 			    invocation,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_NOT_SUPPORTED,
@@ -1366,7 +1527,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		}
 		attrs = fu_engine_get_host_security_attrs(self->engine);
 		val = fu_security_attrs_to_variant(attrs);
-		g_dbus_method_invocation_return_value(invocation, val);
+		fu_daemon_method_invocation_return_value(self, invocation, val);
 #endif
 		return;
 	}
@@ -1376,18 +1537,19 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_variant_get(parameters, "(u)", &limit);
 		g_debug("Called %s(%u)", method_name, limit);
 #ifndef HAVE_HSI
-		g_dbus_method_invocation_return_error_literal(invocation,
-							      FWUPD_ERROR,
-							      FWUPD_ERROR_NOT_SUPPORTED,
-							      "HSI support not enabled");
+		fu_daemon_method_invocation_return_error_literal(self,
+								 invocation,
+								 FWUPD_ERROR,
+								 FWUPD_ERROR_NOT_SUPPORTED,
+								 "HSI support not enabled");
 #else
 		attrs = fu_engine_get_host_security_events(self->engine, limit, &error);
 		if (attrs == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		val = fu_security_attrs_to_variant(attrs);
-		g_dbus_method_invocation_return_value(invocation, val);
+		fu_daemon_method_invocation_return_value(self, invocation, val);
 #endif
 		return;
 	}
@@ -1396,10 +1558,10 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_variant_get(parameters, "(&s)", &device_id);
 		g_debug("Called %s(%s)", method_name, device_id);
 		if (!fu_engine_clear_results(self->engine, device_id, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
+		fu_daemon_method_invocation_return_value(self, invocation, NULL);
 		return;
 	}
 	if (g_strcmp0(method_name, "EmulationLoad") == 0) {
@@ -1410,16 +1572,18 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		/* load data into engine */
 		data = g_variant_get_data_as_bytes(g_variant_get_child_value(parameters, 0));
 		if (!fu_engine_emulation_load(self->engine, data, &error)) {
-			g_dbus_method_invocation_return_error(invocation,
-							      error->domain,
-							      error->code,
-							      "failed to load emulation data: %s",
-							      error->message);
+			fu_daemon_method_invocation_return_error(
+			    self,
+			    invocation,
+			    error->domain,
+			    error->code,
+			    "failed to load emulation data: %s",
+			    error->message);
 			return;
 		}
 
 		/* success */
-		g_dbus_method_invocation_return_value(invocation, NULL);
+		fu_daemon_method_invocation_return_value(self, invocation, NULL);
 		return;
 	}
 	if (g_strcmp0(method_name, "EmulationSave") == 0) {
@@ -1430,15 +1594,19 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		/* save data from engine */
 		data = fu_engine_emulation_save(self->engine, &error);
 		if (data == NULL) {
-			g_dbus_method_invocation_return_error(invocation,
-							      FWUPD_ERROR,
-							      FWUPD_ERROR_NOT_SUPPORTED,
-							      "failed to save emulation data: %s",
-							      error->message);
+			fu_daemon_method_invocation_return_error(
+			    self,
+			    invocation,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "failed to save emulation data: %s",
+			    error->message);
 			return;
 		}
 		val = g_variant_new_from_bytes(G_VARIANT_TYPE_BYTESTRING, data, FALSE);
-		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+		fu_daemon_method_invocation_return_value(self,
+							 invocation,
+							 g_variant_new_tuple(&val, 1));
 		return;
 	}
 	if (g_strcmp0(method_name, "ModifyDevice") == 0) {
@@ -1450,10 +1618,10 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_variant_get(parameters, "(&s&s&s)", &device_id, &key, &value);
 		g_debug("Called %s(%s,%s=%s)", method_name, device_id, key, value);
 		if (!fu_engine_modify_device(self->engine, device_id, key, value, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
+		fu_daemon_method_invocation_return_value(self, invocation, NULL);
 		return;
 	}
 	if (g_strcmp0(method_name, "GetResults") == 0) {
@@ -1462,16 +1630,18 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_variant_get(parameters, "(&s)", &device_id);
 		g_debug("Called %s(%s)", method_name, device_id);
 		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		result = fu_engine_get_results(self->engine, device_id, &error);
 		if (result == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		val = fwupd_device_to_variant(result);
-		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+		fu_daemon_method_invocation_return_value(self,
+							 invocation,
+							 g_variant_new_tuple(&val, 1));
 		return;
 	}
 	if (g_strcmp0(method_name, "UpdateMetadata") == 0) {
@@ -1490,33 +1660,60 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		fd_list = g_dbus_message_get_unix_fd_list(message);
 		if (fd_list == NULL || g_unix_fd_list_get_length(fd_list) != 2) {
 			g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "invalid handle");
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		fd_data = g_unix_fd_list_get(fd_list, 0, &error);
 		if (fd_data < 0) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		fd_sig = g_unix_fd_list_get(fd_list, 1, &error);
 		if (fd_sig < 0) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 
 		/* store new metadata (will close the fds when done) */
 		if (!fu_engine_update_metadata(self->engine, remote_id, fd_data, fd_sig, &error)) {
 			g_prefix_error(&error, "Failed to update metadata for %s: ", remote_id);
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
+		fu_daemon_method_invocation_return_value(self, invocation, NULL);
 #else
 		g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "unsupported feature");
-		g_dbus_method_invocation_return_gerror(invocation, error);
+		fu_daemon_method_invocation_return_gerror(self, invocation, error);
 #endif /* HAVE_GIO_UNIX */
 		return;
 	}
+	if (g_strcmp0(method_name, "TouchMetadata") == 0) {
+		const gchar *remote_id = NULL;
+		const gchar *checksum = NULL;
+		g_autoptr(FuMainAuthHelper) helper = NULL;
+
+		g_variant_get(parameters, "(&s&s)", &remote_id, &checksum);
+		g_debug("Called %s(%s,%s)", method_name, remote_id, checksum);
+
+		/* create helper object */
+		helper = g_new0(FuMainAuthHelper, 1);
+		helper->request = g_steal_pointer(&request);
+		helper->invocation = g_object_ref(invocation);
+		helper->remote_id = g_strdup(remote_id);
+		helper->value = g_strdup(checksum);
+		helper->self = self;
+
+		/* authenticate, as the age of the metadata changes when it is refreshed */
+		fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
+		fu_polkit_authority_check(self->authority,
+					  sender,
+					  "org.freedesktop.fwupd.modify-remote",
+					  auth_flags,
+					  NULL,
+					  fu_daemon_authorize_touch_metadata_cb,
+					  g_steal_pointer(&helper));
+		return;
+	}
 	if (g_strcmp0(method_name, "Unlock") == 0) {
 		const gchar *device_id = NULL;
 		g_autoptr(FuMainAuthHelper) helper = NULL;
@@ -1524,7 +1721,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_variant_get(parameters, "(&s)", &device_id);
 		g_debug("Called %s(%s)", method_name, device_id);
 		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 
@@ -1551,7 +1748,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 
 		g_debug("Called %s(%s)", method_name, device_id);
 		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 
@@ -1633,7 +1830,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_variant_get(parameters, "(&s)", &device_id);
 		g_debug("Called %s(%s)", method_name, device_id);
 		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 
@@ -1662,7 +1859,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_variant_get(parameters, "(&s)", &device_id);
 		g_debug("Called %s(%s)", method_name, device_id);
 		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 
@@ -1678,10 +1875,10 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 				 self);
 
 		if (!fu_engine_verify(self->engine, device_id, progress, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
+		fu_daemon_method_invocation_return_value(self, invocation, NULL);
 		return;
 	}
 	if (g_strcmp0(method_name, "SetFeatureFlags") == 0) {
@@ -1694,7 +1891,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		/* old flags for the same sender will be automatically destroyed */
 		sender_item = fu_daemon_ensure_sender_item(self, sender);
 		sender_item->feature_flags = feature_flags_u64;
-		g_dbus_method_invocation_return_value(invocation, NULL);
+		fu_daemon_method_invocation_return_value(self, invocation, NULL);
 		return;
 	}
 	if (g_strcmp0(method_name, "SetHints") == 0) {
@@ -1712,7 +1909,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 					    g_strdup(prop_key),
 					    g_strdup(prop_value));
 		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
+		fu_daemon_method_invocation_return_value(self, invocation, NULL);
 		return;
 	}
 	if (g_strcmp0(method_name, "Inhibit") == 0) {
@@ -1736,8 +1933,9 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 						   NULL);
 		g_ptr_array_add(self->system_inhibits, inhibit);
 		fu_daemon_ensure_system_inhibit(self);
-		g_dbus_method_invocation_return_value(invocation,
-						      g_variant_new("(s)", inhibit->id));
+		fu_daemon_method_invocation_return_value(self,
+							 invocation,
+							 g_variant_new("(s)", inhibit->id));
 		return;
 	}
 	if (g_strcmp0(method_name, "Uninhibit") == 0) {
@@ -1759,13 +1957,14 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 			}
 		}
 		if (!found) {
-			g_dbus_method_invocation_return_error_literal(invocation,
-								      FWUPD_ERROR,
-								      FWUPD_ERROR_NOT_FOUND,
-								      "Cannot find inhibit ID");
+			fu_daemon_method_invocation_return_error_literal(self,
+									 invocation,
+									 FWUPD_ERROR,
+									 FWUPD_ERROR_NOT_FOUND,
+									 "Cannot find inhibit ID");
 			return;
 		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
+		fu_daemon_method_invocation_return_value(self, invocation, NULL);
 		return;
 	}
 
@@ -1780,13 +1979,14 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		GDBusMessage *message;
 		GUnixFDList *fd_list;
 		g_autoptr(FuMainAuthHelper) helper = NULL;
+		g_autoptr(GBytes) blob_cab = NULL;
 		g_autoptr(GVariantIter) iter = NULL;
 
 		/* check the id exists */
 		g_variant_get(parameters, "(&sha{sv})", &device_id, &fd_handle, &iter);
 		g_debug("Called %s(%s,%i)", method_name, device_id, fd_handle);
 		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 
@@ -1829,12 +2029,12 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		fd_list = g_dbus_message_get_unix_fd_list(message);
 		if (fd_list == NULL || g_unix_fd_list_get_length(fd_list) != 1) {
 			g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "invalid handle");
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		fd = g_unix_fd_list_get(fd_list, 0, &error);
 		if (fd < 0) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 
@@ -1843,21 +2043,24 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		 * this will also close the fd when done */
 		archive_size_max =
 		    fu_config_get_archive_size_max(fu_engine_get_config(self->engine));
-		helper->blob_cab = fu_bytes_get_contents_fd(fd, archive_size_max, &error);
-		if (helper->blob_cab == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+		blob_cab = fu_bytes_get_contents_fd(fd, archive_size_max, &error);
+		if (blob_cab == NULL) {
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 
+		/* the archive is hashed several times during the install, so do it just once */
+		helper->blob_cab = fu_bytes_new_with_checksums(blob_cab);
+
 		/* install all the things in the store */
 		helper->sender = g_strdup(sender);
 		if (!fu_daemon_install_with_helper(g_steal_pointer(&helper), &error)) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 #else
 		g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "unsupported feature");
-		g_dbus_method_invocation_return_gerror(invocation, error);
+		fu_daemon_method_invocation_return_gerror(self, invocation, error);
 #endif /* HAVE_GIO_UNIX */
 
 		/* async return */
@@ -1880,26 +2083,26 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		fd_list = g_dbus_message_get_unix_fd_list(message);
 		if (fd_list == NULL || g_unix_fd_list_get_length(fd_list) != 1) {
 			g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "invalid handle");
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		fd = g_unix_fd_list_get(fd_list, 0, &error);
 		if (fd < 0) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 
 		/* get details about the file (will close the fd when done) */
 		results = fu_engine_get_details(self->engine, request, fd, &error);
 		if (results == NULL) {
-			g_dbus_method_invocation_return_gerror(invocation, error);
+			fu_daemon_method_invocation_return_gerror(self, invocation, error);
 			return;
 		}
 		val = fu_daemon_result_array_to_variant(results);
-		g_dbus_method_invocation_return_value(invocation, val);
+		fu_daemon_method_invocation_return_value(self, invocation, val);
 #else
 		g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "unsupported feature");
-		g_dbus_method_invocation_return_gerror(invocation, error);
+		fu_daemon_method_invocation_return_gerror(self, invocation, error);
 #endif /* HAVE_GIO_UNIX */
 		return;
 	}
@@ -1918,7 +2121,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 			    attrs,
 			    fu_engine_request_get_device_flags(request) &
 				FWUPD_DEVICE_FLAG_TRUSTED);
-			g_dbus_method_invocation_return_value(invocation, val);
+			fu_daemon_method_invocation_return_value(self, invocation, val);
 		} else {
 			g_autoptr(FuMainAuthHelper) helper = NULL;
 
@@ -1973,7 +2176,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		    G_DBUS_ERROR_UNKNOWN_METHOD,
 		    "no such method %s",
 		    method_name);
-	g_dbus_method_invocation_return_gerror(invocation, error);
+	fu_daemon_method_invocation_return_gerror(self, invocation, error);
 }
 
 static GVariant *
@@ -2186,7 +2389,9 @@ fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
+	fu_progress_set_profile(progress,
+				g_getenv("FWUPD_VERBOSE") != NULL ||
+				    g_getenv("FWUPD_PROFILE_TRACE") != NULL);
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 99, "load-engine");
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 1, "load-introspection");
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 1, "load-authority");
@@ -2292,9 +2497,16 @@ fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 
 	/* a good place to do the traceback */
 	if (fu_progress_get_profile(progress)) {
+		const gchar *trace_fn = g_getenv("FWUPD_PROFILE_TRACE");
 		g_autofree gchar *str = fu_progress_traceback(progress);
 		if (str != NULL)
 			g_print("\n%s\n", str);
+		if (trace_fn != NULL) {
+			g_autofree gchar *trace = fu_progress_to_trace(progress);
+			g_autoptr(GError) error_local = NULL;
+			if (!g_file_set_contents(trace_fn, trace, -1, &error_local))
+				g_warning("failed to save trace: %s", error_local->message);
+		}
 	}
 
 	/* success */
@@ -2319,6 +2531,11 @@ fu_daemon_init(FuDaemon *self)
 	self->loop = g_main_loop_new(NULL, FALSE);
 	self->system_inhibits =
 	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_daemon_system_inhibit_free);
+	self->device_changed_queue = fu_device_changed_queue_new(FU_DAEMON_DEVICE_CHANGED_DELAY);
+	g_signal_connect(FU_DEVICE_CHANGED_QUEUE(self->device_changed_queue),
+			 "device-changed",
+			 G_CALLBACK(fu_daemon_device_changed_queue_cb),
+			 self);
 }
 
 static void
@@ -2330,6 +2547,9 @@ fu_daemon_finalize(GObject *obj)
 	g_hash_table_unref(self->sender_items);
 	if (self->process_quit_id != 0)
 		g_source_remove(self->process_quit_id);
+	if (self->changed_id != 0)
+		g_source_remove(self->changed_id);
+	g_object_unref(self->device_changed_queue);
 	if (self->loop != NULL)
 		g_main_loop_unref(self->loop);
 	if (self->owner_id > 0)
@@ -2344,6 +2564,7 @@ fu_daemon_finalize(GObject *obj)
 		g_object_unref(self->authority);
 	if (self->introspection_daemon != NULL)
 		g_dbus_node_info_unref(self->introspection_daemon);
+	fu_common_guid_clear_cache();
 
 	G_OBJECT_CLASS(fu_daemon_parent_class)->finalize(obj);
 }
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2023 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#define G_LOG_DOMAIN "FuDeviceChangedQueue"
+
+#include "config.h"
+
+#include "fu-device-changed-queue.h"
+
+struct _FuDeviceChangedQueue {
+	GObject parent_instance;
+	GPtrArray *devices; /* (element-type FuDevice) in the order first changed */
+	GHashTable *ids;    /* device-id */
+	guint delay;	    /* ms */
+	guint timeout_id;
+	gboolean immediate;
+	guint emitted;
+	guint suppressed;
+};
+
+enum { SIGNAL_DEVICE_CHANGED, SIGNAL_LAST };
+
+static guint signals[SIGNAL_LAST] = {0};
+
+G_DEFINE_TYPE(FuDeviceChangedQueue, fu_device_changed_queue, G_TYPE_OBJECT)
+
+/**
+ * fu_device_changed_queue_flush:
+ * @self: a #FuDeviceChangedQueue
+ *
+ * Emits ::device-changed for every pending device using the device state now, not when the
+ * change was added.
+ **/
+void
+fu_device_changed_queue_flush(FuDeviceChangedQueue *self)
+{
+	g_autoptr(GPtrArray) devices = NULL;
+
+	g_return_if_fail(FU_IS_DEVICE_CHANGED_QUEUE(self));
+
+	if (self->timeout_id != 0) {
+		g_source_remove(self->timeout_id);
+		self->timeout_id = 0;
+	}
+	if (self->devices->len == 0)
+		return;
+
+	/* a handler might add more changes */
+	devices = g_steal_pointer(&self->devices);
+	self->devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_hash_table_remove_all(self->ids);
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		g_signal_emit(self, signals[SIGNAL_DEVICE_CHANGED], 0, device);
+		self->emitted++;
+	}
+	g_debug("emitted %u signals, suppressed %u", self->emitted, self->suppressed);
+}
+
+static gboolean
+fu_device_changed_queue_timeout_cb(gpointer user_data)
+{
+	FuDeviceChangedQueue *self = FU_DEVICE_CHANGED_QUEUE(user_data);
+	self->timeout_id = 0;
+	fu_device_changed_queue_flush(self);
+	return G_SOURCE_REMOVE;
+}
+
+/**
+ * fu_device_changed_queue_add:
+ * @self: a #FuDeviceChangedQueue
+ * @device: a #FuDevice
+ *
+ * Adds a changed device, merging it with any change for the same device ID that has not
+ * yet been emitted.
+ **/
+void
+fu_device_changed_queue_add(FuDeviceChangedQueue *self, FuDevice *device)
+{
+	const gchar *device_id;
+
+	g_return_if_fail(FU_IS_DEVICE_CHANGED_QUEUE(self));
+	g_return_if_fail(FU_IS_DEVICE(device));
+
+	device_id = fu_device_get_id(device);
+	if (g_hash_table_contains(self->ids, device_id)) {
+		self->suppressed++;
+	} else {
+		g_hash_table_add(self->ids, g_strdup(device_id));
+		g_ptr_array_add(self->devices, g_object_ref(device));
+	}
+
+	/* the main loop is not running, so the timeout would fire too late */
+	if (self->immediate) {
+		fu_device_changed_queue_flush(self);
+		return;
+	}
+	if (self->timeout_id == 0) {
+		self->timeout_id =
+		    g_timeout_add(self->delay, fu_device_changed_queue_timeout_cb, self);
+	}
+}
+
+/**
+ * fu_device_changed_queue_set_immediate:
+ * @self: a #FuDeviceChangedQueue
+ * @immediate: %TRUE to emit changes as they are added
+ *
+ * Sets if changes should be emitted straight away, e.g. while an update is blocking the
+ * main loop. Any pending changes are emitted first.
+ **/
+void
+fu_device_changed_queue_set_immediate(FuDeviceChangedQueue *self, gboolean immediate)
+{
+	g_return_if_fail(FU_IS_DEVICE_CHANGED_QUEUE(self));
+	if (immediate)
+		fu_device_changed_queue_flush(self);
+	self->immediate = immediate;
+}
+
+/**
+ * fu_device_changed_queue_get_emitted:
+ * @self: a #FuDeviceChangedQueue
+ *
+ * Gets the number of ::device-changed signals emitted.
+ *
+ * Returns: integer
+ **/
+guint
+fu_device_changed_queue_get_emitted(FuDeviceChangedQueue *self)
+{
+	g_return_val_if_fail(FU_IS_DEVICE_CHANGED_QUEUE(self), G_MAXUINT);
+	return self->emitted;
+}
+
+/**
+ * fu_device_changed_queue_get_suppressed:
+ * @self: a #FuDeviceChangedQueue
+ *
+ * Gets the number of changes that were merged into an earlier pending change.
+ *
+ * Returns: integer
+ **/
+guint
+fu_device_changed_queue_get_suppressed(FuDeviceChangedQueue *self)
+{
+	g_return_val_if_fail(FU_IS_DEVICE_CHANGED_QUEUE(self), G_MAXUINT);
+	return self->suppressed;
+}
+
+static void
+fu_device_changed_queue_init(FuDeviceChangedQueue *self)
+{
+	self->devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	self->ids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+}
+
+static void
+fu_device_changed_queue_finalize(GObject *obj)
+{
+	FuDeviceChangedQueue *self = FU_DEVICE_CHANGED_QUEUE(obj);
+
+	if (self->timeout_id != 0)
+		g_source_remove(self->timeout_id);
+	g_ptr_array_unref(self->devices);
+	g_hash_table_unref(self->ids);
+
+	G_OBJECT_CLASS(fu_device_changed_queue_parent_class)->finalize(obj);
+}
+
+static void
+fu_device_changed_queue_class_init(FuDeviceChangedQueueClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_device_changed_queue_finalize;
+
+	/**
+	 * FuDeviceChangedQueue::device-changed:
+	 * @self: the #FuDeviceChangedQueue instance that emitted the signal
+	 * @device: the #FuDevice
+	 *
+	 * The ::device-changed signal is emitted when a pending change is flushed.
+	 **/
+	signals[SIGNAL_DEVICE_CHANGED] = g_signal_new("device-changed",
+						      G_TYPE_FROM_CLASS(object_class),
+						      G_SIGNAL_RUN_LAST,
+						      0,
+						      NULL,
+						      NULL,
+						      g_cclosure_marshal_VOID__OBJECT,
+						      G_TYPE_NONE,
+						      1,
+						      FU_TYPE_DEVICE);
+}
+
+/**
+ * fu_device_changed_queue_new:
+ * @delay: the time in ms to wait for more changes before emitting
+ *
+ * Creates a queue that merges repeated changes to the same device.
+ *
+ * Returns: a #FuDeviceChangedQueue
+ **/
+FuDeviceChangedQueue *
+fu_device_changed_queue_new(guint delay)
+{
+	FuDeviceChangedQueue *self = g_object_new(FU_TYPE_DEVICE_CHANGED_QUEUE, NULL);
+	self->delay = delay;
+	return self;
+}
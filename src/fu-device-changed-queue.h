@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2023 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+#include <fwupdplugin.h>
+
+#define FU_TYPE_DEVICE_CHANGED_QUEUE (fu_device_changed_queue_get_type())
+G_DECLARE_FINAL_TYPE(FuDeviceChangedQueue,
+		     fu_device_changed_queue,
+		     FU,
+		     DEVICE_CHANGED_QUEUE,
+		     GObject)
+
+FuDeviceChangedQueue *
+fu_device_changed_queue_new(guint delay);
+void
+fu_device_changed_queue_add(FuDeviceChangedQueue *self, FuDevice *device);
+void
+fu_device_changed_queue_flush(FuDeviceChangedQueue *self);
+void
+fu_device_changed_queue_set_immediate(FuDeviceChangedQueue *self, gboolean immediate);
+guint
+fu_device_changed_queue_get_emitted(FuDeviceChangedQueue *self);
+guint
+fu_device_changed_queue_get_suppressed(FuDeviceChangedQueue *self);
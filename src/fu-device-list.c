@@ -35,19 +35,54 @@ struct _FuDeviceList {
 	GObject parent_instance;
 	GPtrArray *devices; /* of FuDeviceItem */
 	GRWLock devices_mutex;
+	GHashTable *guid_index;	      /* (element-type utf8 GPtrArray) of FuDeviceKeys */
+	GHashTable *connection_index; /* (element-type utf8 GPtrArray) of FuDeviceKeys */
+	GPtrArray *id_index;	      /* (element-type FuDeviceIdEntry), sorted by ID */
+	gint identity_generation; /* atomic, changed when any listed device changes */
+	gint index_generation;	  /* value of identity_generation when last indexed */
+	guint index_rescan_cnt;
+	guint64 item_seq;
 };
 
 enum { SIGNAL_ADDED, SIGNAL_REMOVED, SIGNAL_CHANGED, SIGNAL_LAST };
 
 static guint signals[SIGNAL_LAST] = {0};
 
+typedef enum {
+	FU_DEVICE_KEYS_KIND_ACTIVE,
+	FU_DEVICE_KEYS_KIND_OLD,
+	FU_DEVICE_KEYS_KIND_LAST
+} FuDeviceKeysKind;
+
+typedef struct _FuDeviceKeys FuDeviceKeys;
+
 typedef struct {
 	FuDevice *device;
 	FuDevice *device_old;
 	FuDeviceList *self; /* no ref */
 	guint remove_id;
+	guint64 seq; /* order the item was added */
+	FuDeviceKeys *keys[FU_DEVICE_KEYS_KIND_LAST];
+	gulong identity_changed_ids[FU_DEVICE_KEYS_KIND_LAST];
 } FuDeviceItem;
 
+/* the identifiers used when indexing one device of an item */
+struct _FuDeviceKeys {
+	FuDeviceItem *item; /* no ref */
+	FuDeviceKeysKind kind;
+	FuDevice *device; /* no ref, only used for comparison */
+	guint generation;
+	GPtrArray *guids; /* (element-type utf8) */
+	gchar *connection;
+	gchar *ids[2];
+};
+
+typedef struct {
+	const gchar *id;    /* owned by FuDeviceKeys */
+	FuDeviceKeys *keys; /* no ref */
+	guint idx;	    /* index into FuDeviceKeys->ids */
+} FuDeviceIdEntry;
+
 G_DEFINE_TYPE(FuDeviceList, fu_device_list, G_TYPE_OBJECT)
 
 static void
@@ -71,6 +106,244 @@ fu_device_list_emit_device_changed(FuDeviceList *self, FuDevice *device)
 	g_signal_emit(self, signals[SIGNAL_CHANGED], 0, device);
 }
 
+static gchar *
+fu_device_list_build_connection_key(const gchar *physical_id, const gchar *logical_id)
+{
+	if (logical_id == NULL)
+		return g_strdup(physical_id);
+	return g_strdup_printf("%s\n%s", physical_id, logical_id);
+}
+
+/* returns the first position in the ID index that is >= @id */
+static guint
+fu_device_list_id_index_lower_bound(FuDeviceList *self, const gchar *id)
+{
+	guint lo = 0;
+	guint hi = self->id_index->len;
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+		FuDeviceIdEntry *entry = g_ptr_array_index(self->id_index, mid);
+		if (g_strcmp0(entry->id, id) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static void
+fu_device_list_index_array_add(GHashTable *index, const gchar *key, FuDeviceKeys *keys)
+{
+	GPtrArray *array = g_hash_table_lookup(index, key);
+	if (array == NULL) {
+		array = g_ptr_array_new();
+		g_hash_table_insert(index, g_strdup(key), array);
+	}
+	g_ptr_array_add(array, keys);
+}
+
+static void
+fu_device_list_index_array_remove(GHashTable *index, const gchar *key, FuDeviceKeys *keys)
+{
+	GPtrArray *array = g_hash_table_lookup(index, key);
+	if (array == NULL)
+		return;
+	g_ptr_array_remove_fast(array, keys);
+	if (array->len == 0)
+		g_hash_table_remove(index, key);
+}
+
+/* must be called with the writer lock held */
+static void
+fu_device_list_index_remove(FuDeviceList *self, FuDeviceKeys *keys)
+{
+	for (guint i = 0; i < keys->guids->len; i++) {
+		const gchar *guid = g_ptr_array_index(keys->guids, i);
+		fu_device_list_index_array_remove(self->guid_index, guid, keys);
+	}
+	if (keys->connection != NULL)
+		fu_device_list_index_array_remove(self->connection_index, keys->connection, keys);
+	for (guint j = 0; j < G_N_ELEMENTS(keys->ids); j++) {
+		if (keys->ids[j] == NULL)
+			continue;
+		for (guint i = fu_device_list_id_index_lower_bound(self, keys->ids[j]);
+		     i < self->id_index->len;
+		     i++) {
+			FuDeviceIdEntry *entry = g_ptr_array_index(self->id_index, i);
+			if (g_strcmp0(entry->id, keys->ids[j]) != 0)
+				break;
+			if (entry->keys == keys && entry->idx == j) {
+				g_ptr_array_remove_index(self->id_index, i);
+				break;
+			}
+		}
+	}
+	g_ptr_array_unref(keys->guids);
+	g_free(keys->connection);
+	for (guint j = 0; j < G_N_ELEMENTS(keys->ids); j++)
+		g_free(keys->ids[j]);
+	g_free(keys);
+}
+
+/* must be called with the writer lock held */
+static FuDeviceKeys *
+fu_device_list_index_add(FuDeviceList *self,
+			 FuDeviceItem *item,
+			 FuDeviceKeysKind kind,
+			 FuDevice *device)
+{
+	FuDeviceKeys *keys = g_new0(FuDeviceKeys, 1);
+	GPtrArray *guids = fu_device_get_guids(device);
+
+	keys->item = item;
+	keys->kind = kind;
+	keys->device = device;
+	keys->generation = fu_device_get_identity_generation(device);
+
+	/* GUIDs */
+	keys->guids = g_ptr_array_new_with_free_func(g_free);
+	for (guint i = 0; i < guids->len; i++) {
+		const gchar *guid = g_ptr_array_index(guids, i);
+		g_ptr_array_add(keys->guids, g_strdup(guid));
+		fu_device_list_index_array_add(self->guid_index, guid, keys);
+	}
+
+	/* physical and logical ID */
+	if (fu_device_get_physical_id(device) != NULL) {
+		keys->connection =
+		    fu_device_list_build_connection_key(fu_device_get_physical_id(device),
+							fu_device_get_logical_id(device));
+		fu_device_list_index_array_add(self->connection_index, keys->connection, keys);
+	}
+
+	/* device ID and equivalent ID, kept sorted to allow abbreviated hashes */
+	keys->ids[0] = g_strdup(fu_device_get_id(device));
+	keys->ids[1] = g_strdup(fu_device_get_equivalent_id(device));
+	for (guint j = 0; j < G_N_ELEMENTS(keys->ids); j++) {
+		FuDeviceIdEntry *entry;
+		if (keys->ids[j] == NULL)
+			continue;
+		entry = g_new0(FuDeviceIdEntry, 1);
+		entry->id = keys->ids[j];
+		entry->keys = keys;
+		entry->idx = j;
+		g_ptr_array_insert(self->id_index,
+				   (gint)fu_device_list_id_index_lower_bound(self, entry->id),
+				   entry);
+	}
+	return keys;
+}
+
+/* must be called with the writer lock held */
+static void
+fu_device_list_index_ensure_item(FuDeviceList *self, FuDeviceItem *item)
+{
+	for (guint kind = 0; kind < FU_DEVICE_KEYS_KIND_LAST; kind++) {
+		FuDevice *device = kind == FU_DEVICE_KEYS_KIND_ACTIVE ? item->device
+								      : item->device_old;
+		FuDeviceKeys *keys = item->keys[kind];
+
+		/* the generation is unique across all devices */
+		if (keys != NULL && device != NULL && keys->device == device &&
+		    keys->generation == fu_device_get_identity_generation(device))
+			continue;
+		if (keys == NULL && device == NULL)
+			continue;
+		if (keys != NULL) {
+			fu_device_list_index_remove(self, keys);
+			item->keys[kind] = NULL;
+		}
+		if (device != NULL)
+			item->keys[kind] = fu_device_list_index_add(self, item, kind, device);
+	}
+}
+
+/* must be called with the writer lock held */
+static void
+fu_device_list_index_remove_item(FuDeviceList *self, FuDeviceItem *item)
+{
+	for (guint kind = 0; kind < FU_DEVICE_KEYS_KIND_LAST; kind++) {
+		if (item->keys[kind] == NULL)
+			continue;
+		fu_device_list_index_remove(self, item->keys[kind]);
+		item->keys[kind] = NULL;
+	}
+}
+
+/* this may be called from any thread, and with the list lock held */
+static void
+fu_device_list_index_invalidate(FuDeviceList *self)
+{
+	g_atomic_int_inc(&self->identity_generation);
+}
+
+static void
+fu_device_list_device_identity_changed_cb(FuDevice *device, gpointer user_data)
+{
+	FuDeviceList *self = FU_DEVICE_LIST(user_data);
+	fu_device_list_index_invalidate(self);
+}
+
+/* update the indexes for any devices in the list that have changed ID, GUID or connection
+ * since the last lookup -- this is only a single integer compare when nothing has changed */
+static void
+fu_device_list_index_ensure(FuDeviceList *self)
+{
+	gint generation;
+	gboolean up_to_date;
+
+	g_rw_lock_reader_lock(&self->devices_mutex);
+	up_to_date = self->index_generation == g_atomic_int_get(&self->identity_generation);
+	g_rw_lock_reader_unlock(&self->devices_mutex);
+	if (up_to_date)
+		return;
+
+	/* another thread may have updated the indexes while the lock was dropped; a change
+	 * made during the rescan moves the generation again and is picked up next time */
+	g_rw_lock_writer_lock(&self->devices_mutex);
+	generation = g_atomic_int_get(&self->identity_generation);
+	if (self->index_generation != generation) {
+		for (guint i = 0; i < self->devices->len; i++) {
+			FuDeviceItem *item = g_ptr_array_index(self->devices, i);
+			fu_device_list_index_ensure_item(self, item);
+		}
+		self->index_generation = generation;
+		self->index_rescan_cnt++;
+	}
+	g_rw_lock_writer_unlock(&self->devices_mutex);
+}
+
+/**
+ * fu_device_list_get_index_rescan_cnt:
+ * @self: a device list
+ *
+ * Gets the number of times every device in the list has been rescanned to update the
+ * lookup indexes.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.14
+ **/
+guint
+fu_device_list_get_index_rescan_cnt(FuDeviceList *self)
+{
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
+	g_return_val_if_fail(FU_IS_DEVICE_LIST(self), G_MAXUINT);
+	locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
+	return self->index_rescan_cnt;
+}
+
+/* active devices are preferred over old devices, then the order they were added */
+static gboolean
+fu_device_list_keys_is_before(FuDeviceKeys *keys1, FuDeviceKeys *keys2)
+{
+	if (keys2 == NULL)
+		return TRUE;
+	if (keys1->kind != keys2->kind)
+		return keys1->kind < keys2->kind;
+	return keys1->item->seq < keys2->item->seq;
+}
+
 static gchar *
 fu_device_list_to_string(FuDeviceList *self)
 {
@@ -245,21 +518,29 @@ fu_device_list_find_by_device(FuDeviceList *self, FuDevice *device)
 static FuDeviceItem *
 fu_device_list_find_by_guid(FuDeviceList *self, const gchar *guid)
 {
-	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
-	g_return_val_if_fail(locker != NULL, NULL);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item = g_ptr_array_index(self->devices, i);
-		if (fu_device_has_guid(item->device, guid))
-			return item;
+	GPtrArray *array;
+	FuDeviceKeys *keys_best = NULL;
+	g_autofree gchar *guid_tmp = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
+
+	/* make valid */
+	if (!fwupd_guid_is_valid(guid)) {
+		guid_tmp = fu_common_guid_hash_string(guid);
+		guid = guid_tmp;
 	}
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item = g_ptr_array_index(self->devices, i);
-		if (item->device_old == NULL)
-			continue;
-		if (fu_device_has_guid(item->device_old, guid))
-			return item;
+
+	fu_device_list_index_ensure(self);
+	locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
+	g_return_val_if_fail(locker != NULL, NULL);
+	array = g_hash_table_lookup(self->guid_index, guid);
+	if (array == NULL)
+		return NULL;
+	for (guint i = 0; i < array->len; i++) {
+		FuDeviceKeys *keys = g_ptr_array_index(array, i);
+		if (fu_device_list_keys_is_before(keys, keys_best))
+			keys_best = keys;
 	}
-	return NULL;
+	return keys_best != NULL ? keys_best->item : NULL;
 }
 
 static FuDeviceItem *
@@ -267,35 +548,34 @@ fu_device_list_find_by_connection(FuDeviceList *self,
 				  const gchar *physical_id,
 				  const gchar *logical_id)
 {
+	GPtrArray *array;
+	FuDeviceKeys *keys_best = NULL;
+	g_autofree gchar *key = NULL;
 	g_autoptr(GRWLockReaderLocker) locker = NULL;
 	if (physical_id == NULL)
 		return NULL;
+	key = fu_device_list_build_connection_key(physical_id, logical_id);
+	fu_device_list_index_ensure(self);
 	locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		FuDevice *device = item_tmp->device;
-		if (device != NULL &&
-		    g_strcmp0(fu_device_get_physical_id(device), physical_id) == 0 &&
-		    g_strcmp0(fu_device_get_logical_id(device), logical_id) == 0)
-			return item_tmp;
-	}
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		FuDevice *device = item_tmp->device_old;
-		if (device != NULL &&
-		    g_strcmp0(fu_device_get_physical_id(device), physical_id) == 0 &&
-		    g_strcmp0(fu_device_get_logical_id(device), logical_id) == 0)
-			return item_tmp;
+	array = g_hash_table_lookup(self->connection_index, key);
+	if (array == NULL)
+		return NULL;
+	for (guint i = 0; i < array->len; i++) {
+		FuDeviceKeys *keys = g_ptr_array_index(array, i);
+		if (fu_device_list_keys_is_before(keys, keys_best))
+			keys_best = keys;
 	}
-	return NULL;
+	return keys_best != NULL ? keys_best->item : NULL;
 }
 
 static FuDeviceItem *
 fu_device_list_find_by_id(FuDeviceList *self, const gchar *device_id, gboolean *multiple_matches)
 {
-	FuDeviceItem *item = NULL;
+	FuDeviceIdEntry *entries_best[FU_DEVICE_KEYS_KIND_LAST] = {NULL};
+	guint matches[FU_DEVICE_KEYS_KIND_LAST] = {0};
 	gsize device_id_len;
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
 
 	/* sanity check */
 	if (device_id == NULL) {
@@ -303,45 +583,35 @@ fu_device_list_find_by_id(FuDeviceList *self, const gchar *device_id, gboolean *
 		return NULL;
 	}
 
-	/* support abbreviated hashes */
+	/* support abbreviated hashes: all the IDs with this prefix are adjacent in the index */
 	device_id_len = strlen(device_id);
-	g_rw_lock_reader_lock(&self->devices_mutex);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		const gchar *ids[] = {fu_device_get_id(item_tmp->device),
-				      fu_device_get_equivalent_id(item_tmp->device),
-				      NULL};
-		for (guint j = 0; ids[j] != NULL; j++) {
-			if (strncmp(ids[j], device_id, device_id_len) == 0) {
-				if (item != NULL && multiple_matches != NULL)
-					*multiple_matches = TRUE;
-				item = item_tmp;
-			}
-		}
+	fu_device_list_index_ensure(self);
+	locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
+	g_return_val_if_fail(locker != NULL, NULL);
+	for (guint i = fu_device_list_id_index_lower_bound(self, device_id);
+	     i < self->id_index->len;
+	     i++) {
+		FuDeviceIdEntry *entry = g_ptr_array_index(self->id_index, i);
+		FuDeviceIdEntry *entry_best = entries_best[entry->keys->kind];
+		if (strncmp(entry->id, device_id, device_id_len) != 0)
+			break;
+
+		/* use the last match in the list order, for compatibility */
+		matches[entry->keys->kind]++;
+		if (entry_best == NULL || entry->keys->item->seq > entry_best->keys->item->seq ||
+		    (entry->keys->item == entry_best->keys->item && entry->idx > entry_best->idx))
+			entries_best[entry->keys->kind] = entry;
 	}
-	g_rw_lock_reader_unlock(&self->devices_mutex);
-	if (item != NULL)
-		return item;
 
-	/* only search old devices if we didn't find the active device */
-	g_rw_lock_reader_lock(&self->devices_mutex);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		const gchar *ids[3] = {NULL};
-		if (item_tmp->device_old == NULL)
+	/* only use old devices if we didn't find the active device */
+	for (guint kind = 0; kind < FU_DEVICE_KEYS_KIND_LAST; kind++) {
+		if (entries_best[kind] == NULL)
 			continue;
-		ids[0] = fu_device_get_id(item_tmp->device_old);
-		ids[1] = fu_device_get_equivalent_id(item_tmp->device_old);
-		for (guint j = 0; ids[j] != NULL; j++) {
-			if (strncmp(ids[j], device_id, device_id_len) == 0) {
-				if (item != NULL && multiple_matches != NULL)
-					*multiple_matches = TRUE;
-				item = item_tmp;
-			}
-		}
+		if (matches[kind] > 1 && multiple_matches != NULL)
+			*multiple_matches = TRUE;
+		return entries_best[kind]->keys->item;
 	}
-	g_rw_lock_reader_unlock(&self->devices_mutex);
-	return item;
+	return NULL;
 }
 
 /**
@@ -369,31 +639,26 @@ fu_device_list_get_old(FuDeviceList *self, FuDevice *device)
 static FuDeviceItem *
 fu_device_list_get_by_guids_removed(FuDeviceList *self, GPtrArray *guids)
 {
-	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
+	FuDeviceKeys *keys_best = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
+
+	fu_device_list_index_ensure(self);
+	locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item = g_ptr_array_index(self->devices, i);
-		if (item->remove_id == 0)
+	for (guint j = 0; j < guids->len; j++) {
+		const gchar *guid = g_ptr_array_index(guids, j);
+		GPtrArray *array = g_hash_table_lookup(self->guid_index, guid);
+		if (array == NULL)
 			continue;
-		for (guint j = 0; j < guids->len; j++) {
-			const gchar *guid = g_ptr_array_index(guids, j);
-			if (fu_device_has_guid(item->device, guid))
-				return item;
-		}
-	}
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item = g_ptr_array_index(self->devices, i);
-		if (item->device_old == NULL)
-			continue;
-		if (item->remove_id == 0)
-			continue;
-		for (guint j = 0; j < guids->len; j++) {
-			const gchar *guid = g_ptr_array_index(guids, j);
-			if (fu_device_has_guid(item->device_old, guid))
-				return item;
+		for (guint i = 0; i < array->len; i++) {
+			FuDeviceKeys *keys = g_ptr_array_index(array, i);
+			if (keys->item->remove_id == 0)
+				continue;
+			if (fu_device_list_keys_is_before(keys, keys_best))
+				keys_best = keys;
 		}
 	}
-	return NULL;
+	return keys_best != NULL ? keys_best->item : NULL;
 }
 
 static gboolean
@@ -563,6 +828,28 @@ fu_device_list_item_finalized_cb(gpointer data, GObject *where_the_object_was)
 	g_rw_lock_writer_unlock(&self->devices_mutex);
 }
 
+/* watch for changes to anything used in the indexes */
+static void
+fu_device_list_item_watch_device(FuDeviceItem *item,
+				 FuDeviceKeysKind kind,
+				 FuDevice *device_prev,
+				 FuDevice *device)
+{
+	/* the handler has already gone if called from the weak ref */
+	if (item->identity_changed_ids[kind] != 0) {
+		if (g_signal_handler_is_connected(device_prev, item->identity_changed_ids[kind]))
+			g_signal_handler_disconnect(device_prev, item->identity_changed_ids[kind]);
+		item->identity_changed_ids[kind] = 0;
+	}
+	if (device != NULL) {
+		item->identity_changed_ids[kind] =
+		    g_signal_connect(FU_DEVICE(device),
+				     "identity-changed",
+				     G_CALLBACK(fu_device_list_device_identity_changed_cb),
+				     item->self);
+	}
+}
+
 /* this should never be required, and yet here we are */
 static void
 fu_device_list_item_set_device(FuDeviceItem *item, FuDevice *device)
@@ -573,9 +860,17 @@ fu_device_list_item_set_device(FuDeviceItem *item, FuDevice *device)
 	if (device != NULL) {
 		g_object_weak_ref(G_OBJECT(device), fu_device_list_item_finalized_cb, item);
 	}
+	fu_device_list_item_watch_device(item, FU_DEVICE_KEYS_KIND_ACTIVE, item->device, device);
 	g_set_object(&item->device, device);
 }
 
+static void
+fu_device_list_item_set_device_old(FuDeviceItem *item, FuDevice *device)
+{
+	fu_device_list_item_watch_device(item, FU_DEVICE_KEYS_KIND_OLD, item->device_old, device);
+	g_set_object(&item->device_old, device);
+}
+
 static void
 fu_device_list_clear_wait_for_replug(FuDeviceList *self, FuDeviceItem *item)
 {
@@ -711,7 +1006,8 @@ fu_device_list_replace(FuDeviceList *self, FuDeviceItem *item, FuDevice *device)
 	fu_device_incorporate_update_state(item->device, device);
 
 	/* assign the new device */
-	g_set_object(&item->device_old, item->device);
+	fu_device_list_item_set_device_old(item, item->device);
+	fu_device_list_index_invalidate(self);
 	fu_device_list_item_set_device(item, device);
 	fu_device_list_emit_device_changed(self, device);
 
@@ -765,6 +1061,7 @@ fu_device_list_add(FuDeviceList *self, FuDevice *device)
 										 item->device);
 				fu_device_incorporate_update_state(device, item->device);
 				fu_device_list_item_set_device(item, device);
+				fu_device_list_index_invalidate(self);
 			}
 			fu_device_list_clear_wait_for_replug(self, item);
 			fu_device_list_emit_device_changed(self, device);
@@ -778,7 +1075,8 @@ fu_device_list_add(FuDeviceList *self, FuDevice *device)
 			fu_device_uninhibit(item->device, "unconnected");
 			fu_device_incorporate_problem_update_in_progress(device, item->device);
 			fu_device_incorporate_update_state(device, item->device);
-			g_set_object(&item->device_old, item->device);
+			fu_device_list_item_set_device_old(item, item->device);
+			fu_device_list_index_invalidate(self);
 			fu_device_list_item_set_device(item, device);
 			fu_device_list_clear_wait_for_replug(self, item);
 			fu_device_list_emit_device_changed(self, device);
@@ -831,7 +1129,9 @@ fu_device_list_add(FuDeviceList *self, FuDevice *device)
 	item->self = self; /* no ref */
 	fu_device_list_item_set_device(item, device);
 	g_rw_lock_writer_lock(&self->devices_mutex);
+	item->seq = self->item_seq++;
 	g_ptr_array_add(self->devices, item);
+	fu_device_list_index_ensure_item(self, item);
 	g_rw_lock_writer_unlock(&self->devices_mutex);
 	fu_device_list_emit_device_added(self, device);
 }
@@ -1012,13 +1312,14 @@ fu_device_list_get_by_id(FuDeviceList *self, const gchar *device_id, GError **er
 	return g_object_ref(item->device);
 }
 
+/* must be called with the writer lock held */
 static void
 fu_device_list_item_free(FuDeviceItem *item)
 {
+	fu_device_list_index_remove_item(item->self, item);
 	if (item->remove_id != 0)
 		g_source_remove(item->remove_id);
-	if (item->device_old != NULL)
-		g_object_unref(item->device_old);
+	fu_device_list_item_set_device_old(item, NULL);
 	fu_device_list_item_set_device(item, NULL);
 	g_free(item);
 }
@@ -1086,6 +1387,15 @@ static void
 fu_device_list_init(FuDeviceList *self)
 {
 	self->devices = g_ptr_array_new_with_free_func((GDestroyNotify)fu_device_list_item_free);
+	self->guid_index = g_hash_table_new_full(g_str_hash,
+						 g_str_equal,
+						 g_free,
+						 (GDestroyNotify)g_ptr_array_unref);
+	self->connection_index = g_hash_table_new_full(g_str_hash,
+						       g_str_equal,
+						       g_free,
+						       (GDestroyNotify)g_ptr_array_unref);
+	self->id_index = g_ptr_array_new_with_free_func(g_free);
 	g_rw_lock_init(&self->devices_mutex);
 }
 
@@ -1096,6 +1406,9 @@ fu_device_list_finalize(GObject *obj)
 
 	g_rw_lock_clear(&self->devices_mutex);
 	g_ptr_array_unref(self->devices);
+	g_hash_table_unref(self->guid_index);
+	g_hash_table_unref(self->connection_index);
+	g_ptr_array_unref(self->id_index);
 
 	G_OBJECT_CLASS(fu_device_list_parent_class)->finalize(obj);
 }
@@ -31,3 +31,5 @@ gboolean
 fu_device_list_wait_for_replug(FuDeviceList *self, GError **error);
 void
 fu_device_list_depsolve_order(FuDeviceList *self, FuDevice *device);
+guint
+fu_device_list_get_index_rescan_cnt(FuDeviceList *self);
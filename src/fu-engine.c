@@ -120,7 +120,7 @@ struct _FuEngine {
 	FuHistory *history;
 	FuIdle *idle;
 	XbSilo *silo;
-	XbQuery *query_component_by_guid;
+	GHashTable *components_by_guid; /* (element-type utf8 GPtrArray) */
 	XbQuery *query_container_checksum1;
 	XbQuery *query_container_checksum2;
 	XbQuery *query_tag_by_guid_version;
@@ -144,9 +144,61 @@ struct _FuEngine {
 	guint acquiesce_id;
 	guint acquiesce_delay;
 	guint update_motd_id;
+	guint coldplug_threads;
 	FuEngineInstallPhase install_phase;
 };
 
+/* shared by all the coldplug worker threads */
+typedef struct {
+	FuEngine *self;
+	GHashTable *plugin_locks; /* (element-type utf8 GMutex) */
+	GAsyncQueue *requests;	  /* (element-type FuEngineColdplugRequest) */
+	GMutex mutex;		  /* for FuEngineColdplugRequest->done */
+	GCond cond;
+} FuEngineColdplugHelper;
+
+/* a backend device being probed by a coldplug worker thread */
+typedef struct {
+	FuDevice *device;
+	FuProgress *progress;
+	GPtrArray *events; /* (element-type FuEngineColdplugEvent) */
+	FuEngineColdplugHelper *helper;
+} FuEngineColdplugItem;
+
+/* a plugin signal from a coldplug worker thread, replayed in the main thread in order */
+typedef enum {
+	FU_ENGINE_COLDPLUG_EVENT_KIND_DEVICE_ADDED,
+	FU_ENGINE_COLDPLUG_EVENT_KIND_DEVICE_REMOVED,
+	FU_ENGINE_COLDPLUG_EVENT_KIND_DEVICE_REGISTER,
+	FU_ENGINE_COLDPLUG_EVENT_KIND_RULES_CHANGED,
+	FU_ENGINE_COLDPLUG_EVENT_KIND_CONFIG_CHANGED,
+} FuEngineColdplugEventKind;
+
+typedef struct {
+	FuEngineColdplugEventKind kind;
+	FuPlugin *plugin;
+	FuDevice *device; /* nullable */
+} FuEngineColdplugEvent;
+
+/* work that a coldplug worker thread has to wait for the main thread to do */
+typedef enum {
+	FU_ENGINE_COLDPLUG_REQUEST_KIND_GROUP_DONE,
+	FU_ENGINE_COLDPLUG_REQUEST_KIND_DEVICE_PROBED,
+	FU_ENGINE_COLDPLUG_REQUEST_KIND_CHECK_SUPPORTED,
+} FuEngineColdplugRequestKind;
+
+typedef struct {
+	FuEngineColdplugRequestKind kind;
+	FuPlugin *plugin;
+	FuDevice *device;
+	const gchar *guid;
+	gboolean result;
+	gboolean done;
+} FuEngineColdplugRequest;
+
+/* set when the plugin ->backend_device_added vfunc is running in a worker thread */
+static GPrivate fu_engine_coldplug_item = G_PRIVATE_INIT(NULL);
+
 enum {
 	SIGNAL_CHANGED,
 	SIGNAL_DEVICE_ADDED,
@@ -752,7 +804,7 @@ fu_engine_get_remote_id_for_blob(FuEngine *self, GBytes *blob)
 	g_return_val_if_fail(blob != NULL, NULL);
 
 	for (guint i = 0; checksum_types[i] != 0; i++) {
-		g_autofree gchar *csum = g_compute_checksum_for_bytes(checksum_types[i], blob);
+		g_autofree gchar *csum = fu_bytes_get_checksum(blob, checksum_types[i]);
 		const gchar *remote_id = fu_engine_get_remote_id_for_checksum(self, csum);
 		if (remote_id != NULL)
 			return g_strdup(remote_id);
@@ -1386,38 +1438,15 @@ fu_engine_verify_update(FuEngine *self,
 static XbNode *
 fu_engine_get_component_by_guid(FuEngine *self, const gchar *guid)
 {
-	g_autoptr(GError) error_local = NULL;
-	g_autoptr(XbNode) component = NULL;
-#if LIBXMLB_CHECK_VERSION(0, 3, 0)
-	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
-#endif
+	GPtrArray *components;
 
 	/* no components in silo */
-	if (self->query_component_by_guid == NULL)
-		return NULL;
-
-#if LIBXMLB_CHECK_VERSION(0, 3, 0)
-	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-	component = xb_silo_query_first_with_context(self->silo,
-						     self->query_component_by_guid,
-						     &context,
-						     &error_local);
-#else
-	if (!xb_query_bind_str(self->query_component_by_guid, 0, guid, &error_local)) {
-		g_warning("failed to bind 0: %s", error_local->message);
+	if (self->components_by_guid == NULL)
 		return NULL;
-	}
-	component =
-	    xb_silo_query_first_full(self->silo, self->query_component_by_guid, &error_local);
-#endif
-	if (component == NULL) {
-		if (!g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) &&
-		    !g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
-			g_warning("ignoring: %s", error_local->message);
+	components = g_hash_table_lookup(self->components_by_guid, guid);
+	if (components == NULL)
 		return NULL;
-	}
-	return g_object_ref(component);
+	return g_object_ref(g_ptr_array_index(components, 0));
 }
 
 XbNode *
@@ -1816,12 +1845,12 @@ fu_engine_check_requirement_vendor_id(FuEngine *self, XbNode *req, FuDevice *dev
 }
 
 static gboolean
-fu_device_has_guids_any(FuDevice *self, gchar **guids)
+fu_device_has_guids_any(FuDevice *self, const fwupd_guid_t *guids, guint guidsz)
 {
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
-	g_return_val_if_fail(guids != NULL, FALSE);
-	for (guint i = 0; guids[i] != NULL; i++) {
-		if (fu_device_has_guid(self, guids[i]))
+	g_return_val_if_fail(guids != NULL || guidsz == 0, FALSE);
+	for (guint i = 0; i < guidsz; i++) {
+		if (fwupd_device_has_guid_raw(FWUPD_DEVICE(self), &guids[i]))
 			return TRUE;
 	}
 	return FALSE;
@@ -1839,6 +1868,8 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 	g_autoptr(FuDevice) device_actual = g_object_ref(device);
 	g_autoptr(GError) error_local = NULL;
 	g_auto(GStrv) guids = NULL;
+	g_autofree fwupd_guid_t *guids_raw = NULL;
+	guint guids_rawsz;
 
 	/* look at the parent device */
 	depth = xb_node_get_attr_as_uint(req, "depth");
@@ -1928,8 +1959,11 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 
 	/* another device, specified by GUID|GUID|GUID */
 	guids = g_strsplit(xb_node_get_text(req), "|", -1);
+	guids_rawsz = g_strv_length(guids);
+	guids_raw = g_new0(fwupd_guid_t, guids_rawsz);
 	for (guint i = 0; guids[i] != NULL; i++) {
-		if (!fwupd_guid_is_valid(guids[i])) {
+		if (!fwupd_guid_is_valid(guids[i]) ||
+		    !fwupd_guid_from_string(guids[i], &guids_raw[i], FWUPD_GUID_FLAG_NONE, NULL)) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
@@ -1965,7 +1999,7 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 
 		/* no parent, so look for GUIDs on this device */
 		if (parent == NULL) {
-			if (!fu_device_has_guids_any(device_actual, guids)) {
+			if (!fu_device_has_guids_any(device_actual, guids_raw, guids_rawsz)) {
 				g_set_error(error,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_NOT_SUPPORTED,
@@ -1979,7 +2013,7 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 		children = fu_device_get_children(parent);
 		for (guint i = 0; i < children->len; i++) {
 			child = g_ptr_array_index(children, i);
-			if (fu_device_has_guids_any(child, guids))
+			if (fu_device_has_guids_any(child, guids_raw, guids_rawsz))
 				break;
 			child = NULL;
 		}
@@ -1995,7 +2029,7 @@ fu_engine_check_requirement_firmware(FuEngine *self,
 
 		/* verify the parent device has the GUID */
 	} else {
-		if (!fu_device_has_guids_any(device_actual, guids)) {
+		if (!fu_device_has_guids_any(device_actual, guids_raw, guids_rawsz)) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
@@ -3037,7 +3071,7 @@ fu_engine_save_into_backup_remote(FuEngine *self, GBytes *fw, GError **error)
 	g_autofree gchar *backupdir_uri = g_strdup_printf("file://%s", backupdir);
 	g_autofree gchar *remotes_path = fu_path_from_kind(FU_PATH_KIND_LOCALSTATEDIR_REMOTES);
 	g_autofree gchar *remotes_fn = g_build_filename(remotes_path, "backup.conf", NULL);
-	g_autofree gchar *archive_checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, fw);
+	g_autofree gchar *archive_checksum = fu_bytes_get_checksum(fw, G_CHECKSUM_SHA256);
 	g_autofree gchar *archive_basename = g_strdup_printf("%s.cab", archive_checksum);
 	g_autofree gchar *archive_fn = g_build_filename(backupdir, archive_basename, NULL);
 	g_autoptr(FwupdRemote) remote = fwupd_remote_new();
@@ -3122,7 +3156,7 @@ fu_engine_install_release(FuEngine *self,
 		GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1, 0};
 		for (guint i = 0; checksum_types[i] != 0; i++) {
 			g_autofree gchar *checksum =
-			    g_compute_checksum_for_bytes(checksum_types[i], blob_cab);
+			    fu_bytes_get_checksum(blob_cab, checksum_types[i]);
 			fwupd_release_add_checksum(FWUPD_RELEASE(release), checksum);
 		}
 	}
@@ -4234,6 +4268,36 @@ fu_engine_get_item_by_id_fallback_history(FuEngine *self, const gchar *id, GErro
 	return NULL;
 }
 
+static void
+fu_engine_create_silo_index_provides(FuEngine *self, XbNode *component, XbNode *provides)
+{
+	g_autoptr(XbNode) firmware = xb_node_get_child(provides);
+
+	while (firmware != NULL) {
+		const gchar *guid = xb_node_get_text(firmware);
+		XbNode *next;
+
+		if (guid != NULL && g_strcmp0(xb_node_get_element(firmware), "firmware") == 0 &&
+		    g_strcmp0(xb_node_get_attr(firmware, "type"), "flashed") == 0) {
+			GPtrArray *components = g_hash_table_lookup(self->components_by_guid, guid);
+			if (components == NULL) {
+				components = g_ptr_array_new_with_free_func(g_object_unref);
+				g_hash_table_insert(self->components_by_guid,
+						    g_strdup(guid),
+						    components);
+			}
+
+			/* the same GUID listed twice in one component */
+			if (components->len == 0 ||
+			    g_ptr_array_index(components, components->len - 1) != component)
+				g_ptr_array_add(components, g_object_ref(component));
+		}
+		next = xb_node_get_next(firmware);
+		g_object_unref(firmware);
+		firmware = next;
+	}
+}
+
 static gboolean
 fu_engine_create_silo_index(FuEngine *self, GError **error)
 {
@@ -4242,18 +4306,18 @@ fu_engine_create_silo_index(FuEngine *self, GError **error)
 	g_autoptr(GError) error_container_checksum2 = NULL;
 	g_autoptr(GError) error_tag_by_guid_version = NULL;
 
+	/* clear old prepared queries, which point into the old silo */
+	g_clear_pointer(&self->components_by_guid, g_hash_table_unref);
+	g_clear_object(&self->query_container_checksum1);
+	g_clear_object(&self->query_container_checksum2);
+	g_clear_object(&self->query_tag_by_guid_version);
+
 	/* print what we've got */
 	components = xb_silo_query(self->silo, "components/component[@type='firmware']", 0, NULL);
 	if (components == NULL)
 		return TRUE;
 	g_info("%u components now in silo", components->len);
 
-	/* clear old prepared queries */
-	g_clear_object(&self->query_component_by_guid);
-	g_clear_object(&self->query_container_checksum1);
-	g_clear_object(&self->query_container_checksum2);
-	g_clear_object(&self->query_tag_by_guid_version);
-
 	/* build the index */
 	if (!xb_silo_query_build_index(self->silo, "components/component", "type", error))
 		return FALSE;
@@ -4273,19 +4337,29 @@ fu_engine_create_silo_index(FuEngine *self, GError **error)
 				       error))
 		return FALSE;
 
-	/* create prepared queries to save time later */
-	self->query_component_by_guid =
-	    xb_query_new_full(self->silo,
-			      "components/component[@type='firmware']/"
-			      "provides/firmware[@type=$'flashed'][text()=?]/"
-			      "../..",
-			      XB_QUERY_FLAG_OPTIMIZE,
-			      error);
-	if (self->query_component_by_guid == NULL) {
-		g_prefix_error(error, "failed to prepare query: ");
-		return FALSE;
+	/* map each flashed GUID to the components that provide it, in silo order */
+	self->components_by_guid = g_hash_table_new_full(g_str_hash,
+							 g_str_equal,
+							 g_free,
+							 (GDestroyNotify)g_ptr_array_unref);
+	for (guint i = 0; i < components->len; i++) {
+		XbNode *component = g_ptr_array_index(components, i);
+		g_autoptr(XbNode) provides = xb_node_get_child(component);
+
+		/* find <provides> */
+		while (provides != NULL &&
+		       g_strcmp0(xb_node_get_element(provides), "provides") != 0) {
+			XbNode *next = xb_node_get_next(provides);
+			g_object_unref(provides);
+			provides = next;
+		}
+		if (provides == NULL)
+			continue;
+		fu_engine_create_silo_index_provides(self, component, provides);
 	}
 
+	/* create prepared queries to save time later */
+
 	/* old-style <checksum target="container"> and new-style <artifact> */
 	self->query_container_checksum1 =
 	    xb_query_new_full(self->silo,
@@ -4545,6 +4619,164 @@ fu_engine_load_metadata_store_local(FuEngine *self,
 	return TRUE;
 }
 
+static gboolean
+fu_engine_load_metadata_remote_sources(FuEngine *self,
+				       XbBuilder *builder,
+				       FwupdRemote *remote,
+				       GError **error)
+{
+	const gchar *path = fwupd_remote_get_filename_cache(remote);
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(XbBuilderFixup) fixup = NULL;
+	g_autoptr(XbBuilderNode) custom = NULL;
+	g_autoptr(XbBuilderSource) source = xb_builder_source_new();
+
+	/* generate all metadata on demand */
+	if (fwupd_remote_get_kind(remote) == FWUPD_REMOTE_KIND_DIRECTORY) {
+		g_info("loading metadata for remote '%s'", fwupd_remote_get_id(remote));
+		return fu_engine_create_metadata(self, builder, remote, error);
+	}
+
+	/* save the remote-id in the custom metadata space */
+	file = g_file_new_for_path(path);
+	if (!xb_builder_source_load_file(source, file, XB_BUILDER_SOURCE_FLAG_NONE, NULL, error))
+		return FALSE;
+
+	/* fix up any legacy installed files */
+	fixup =
+	    xb_builder_fixup_new("AppStreamUpgrade", fu_engine_appstream_upgrade_cb, self, NULL);
+	xb_builder_fixup_set_max_depth(fixup, 3);
+	xb_builder_source_add_fixup(source, fixup);
+
+	/* add metadata */
+	custom = xb_builder_node_new("custom");
+	xb_builder_node_insert_text(custom, "value", path, "key", "fwupd::FilenameCache", NULL);
+	xb_builder_node_insert_text(custom,
+				    "value",
+				    fwupd_remote_get_id(remote),
+				    "key",
+				    "fwupd::RemoteId",
+				    NULL);
+	xb_builder_source_set_info(source, custom);
+	xb_builder_import_source(builder, source);
+	return TRUE;
+}
+
+#if LIBXMLB_CHECK_VERSION(0, 3, 4)
+static XbBuilderNode *
+fu_engine_builder_node_from_node(XbNode *n)
+{
+	const gchar *attr_name = NULL;
+	const gchar *attr_value = NULL;
+	XbBuilderNode *bn = xb_builder_node_new(xb_node_get_element(n));
+	XbNodeAttrIter iter;
+	g_autoptr(XbNode) c = NULL;
+
+	if (xb_node_get_text(n) != NULL)
+		xb_builder_node_set_text(bn, xb_node_get_text(n), -1);
+	if (xb_node_get_tail(n) != NULL)
+		xb_builder_node_set_tail(bn, xb_node_get_tail(n), -1);
+	xb_node_attr_iter_init(&iter, n);
+	while (xb_node_attr_iter_next(&iter, &attr_name, &attr_value))
+		xb_builder_node_set_attr(bn, attr_name, attr_value);
+	c = xb_node_get_child(n);
+	while (c != NULL) {
+		g_autoptr(XbBuilderNode) bc = fu_engine_builder_node_from_node(c);
+		g_autoptr(XbNode) c_next = xb_node_get_next(c);
+		xb_builder_node_add_child(bn, bc);
+		g_set_object(&c, c_next);
+	}
+	return bn;
+}
+#endif
+
+static gboolean
+fu_engine_load_metadata_store_silo(XbBuilder *builder, XbSilo *silo, GError **error)
+{
+	g_autoptr(XbNode) root = xb_silo_get_root(silo);
+
+	/* imported nodes do not affect the builder GUID, so use the GUID of the remote silo */
+	xb_builder_append_guid(builder, xb_silo_get_guid(silo));
+	while (root != NULL) {
+		g_autoptr(XbNode) root_next = NULL;
+#if LIBXMLB_CHECK_VERSION(0, 3, 4)
+		g_autoptr(XbBuilderNode) bn = fu_engine_builder_node_from_node(root);
+		xb_builder_import_node(builder, bn);
+#else
+		g_autofree gchar *xml = NULL;
+		g_autoptr(XbBuilderSource) source = xb_builder_source_new();
+		xml = xb_node_export(root, XB_NODE_EXPORT_FLAG_NONE, error);
+		if (xml == NULL)
+			return FALSE;
+		if (!xb_builder_source_load_xml(source, xml, XB_BUILDER_SOURCE_FLAG_NONE, error))
+			return FALSE;
+		xb_builder_import_source(builder, source);
+#endif
+		root_next = xb_node_get_next(root);
+		g_set_object(&root, root_next);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+/*
+ * Each remote is compiled into its own silo so that refreshing one remote does not need the
+ * other remotes to be decompressed, fixed up or extracted from cabinet archives again.
+ * The nodes of the per-remote silo are then copied into the combined silo in memory.
+ */
+static gboolean
+fu_engine_load_metadata_store_remote(FuEngine *self,
+				     XbBuilder *builder,
+				     FwupdRemote *remote,
+				     FuEngineLoadFlags flags,
+				     XbBuilderCompileFlags compile_flags,
+				     GError **error)
+{
+	g_autofree gchar *cachedir = NULL;
+	g_autofree gchar *xmlb_basename = NULL;
+	g_autofree gchar *xmlbfn = NULL;
+	g_autoptr(GFile) xmlb = NULL;
+	g_autoptr(XbBuilder) builder_remote = xb_builder_new();
+	g_autoptr(XbSilo) silo = NULL;
+
+	if (!fu_engine_load_metadata_remote_sources(self, builder_remote, remote, error))
+		return FALSE;
+
+	/* nothing is persisted */
+	if (flags & FU_ENGINE_LOAD_FLAG_NO_CACHE) {
+		silo = xb_builder_compile(builder_remote, compile_flags, NULL, error);
+		if (silo == NULL)
+			return FALSE;
+		return fu_engine_load_metadata_store_silo(builder, silo, error);
+	}
+
+	/* only recompiled if the remote metadata has changed */
+	cachedir = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	xmlb_basename = g_strdup_printf("%s.xmlb", fwupd_remote_get_id(remote));
+	xmlbfn = g_build_filename(cachedir, "metadata", xmlb_basename, NULL);
+	xmlb = g_file_new_for_path(xmlbfn);
+	if (flags & FU_ENGINE_LOAD_FLAG_READONLY) {
+		/* use whatever was compiled last time, and do not write anything */
+		if (g_file_query_exists(xmlb, NULL)) {
+			silo = xb_silo_new();
+			if (!xb_silo_load_from_file(silo, xmlb, XB_SILO_LOAD_FLAG_NONE, NULL, error))
+				return FALSE;
+		} else {
+			silo = xb_builder_compile(builder_remote, compile_flags, NULL, error);
+			if (silo == NULL)
+				return FALSE;
+		}
+	} else {
+		if (!fu_path_mkdir_parent(xmlbfn, error))
+			return FALSE;
+		silo = xb_builder_ensure(builder_remote, xmlb, compile_flags, NULL, error);
+		if (silo == NULL)
+			return FALSE;
+	}
+	return fu_engine_load_metadata_store_silo(builder, silo, error);
+}
+
 static gboolean
 fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 {
@@ -4554,6 +4786,7 @@ fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **
 	g_autoptr(XbBuilder) builder = xb_builder_new();
 
 	/* clear existing silo */
+	g_clear_pointer(&self->components_by_guid, g_hash_table_unref);
 	g_clear_object(&self->silo);
 
 	/* verbose profiling */
@@ -4563,73 +4796,30 @@ fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **
 						 XB_SILO_PROFILE_FLAG_DEBUG);
 	}
 
+	/* on a read-only filesystem don't care about the cache GUID */
+	if (flags & FU_ENGINE_LOAD_FLAG_READONLY)
+		compile_flags |= XB_BUILDER_COMPILE_FLAG_IGNORE_GUID;
+
 	/* load each enabled metadata file */
 	remotes = fu_remote_list_get_all(self->remote_list);
 	for (guint i = 0; i < remotes->len; i++) {
-		const gchar *path = NULL;
+		FwupdRemote *remote = g_ptr_array_index(remotes, i);
 		g_autoptr(GError) error_local = NULL;
-		g_autoptr(GFile) file = NULL;
-		g_autoptr(XbBuilderFixup) fixup = NULL;
-		g_autoptr(XbBuilderNode) custom = NULL;
-		g_autoptr(XbBuilderSource) source = xb_builder_source_new();
 
-		FwupdRemote *remote = g_ptr_array_index(remotes, i);
 		if (!fwupd_remote_get_enabled(remote))
 			continue;
-		path = fwupd_remote_get_filename_cache(remote);
-		if (!g_file_test(path, G_FILE_TEST_EXISTS))
+		if (!g_file_test(fwupd_remote_get_filename_cache(remote), G_FILE_TEST_EXISTS))
 			continue;
-
-		/* generate all metadata on demand */
-		if (fwupd_remote_get_kind(remote) == FWUPD_REMOTE_KIND_DIRECTORY) {
-			g_info("loading metadata for remote '%s'", fwupd_remote_get_id(remote));
-			if (!fu_engine_create_metadata(self, builder, remote, &error_local)) {
-				g_warning("failed to generate remote %s: %s",
-					  fwupd_remote_get_id(remote),
-					  error_local->message);
-			}
-			continue;
-		}
-
-		/* save the remote-id in the custom metadata space */
-		file = g_file_new_for_path(path);
-		if (!xb_builder_source_load_file(source,
-						 file,
-						 XB_BUILDER_SOURCE_FLAG_NONE,
-						 NULL,
-						 &error_local)) {
+		if (!fu_engine_load_metadata_store_remote(self,
+							  builder,
+							  remote,
+							  flags,
+							  compile_flags,
+							  &error_local)) {
 			g_warning("failed to load remote %s: %s",
 				  fwupd_remote_get_id(remote),
 				  error_local->message);
-			continue;
 		}
-
-		/* fix up any legacy installed files */
-		fixup = xb_builder_fixup_new("AppStreamUpgrade",
-					     fu_engine_appstream_upgrade_cb,
-					     self,
-					     NULL);
-		xb_builder_fixup_set_max_depth(fixup, 3);
-		xb_builder_source_add_fixup(source, fixup);
-
-		/* add metadata */
-		custom = xb_builder_node_new("custom");
-		xb_builder_node_insert_text(custom,
-					    "value",
-					    path,
-					    "key",
-					    "fwupd::FilenameCache",
-					    NULL);
-		xb_builder_node_insert_text(custom,
-					    "value",
-					    fwupd_remote_get_id(remote),
-					    "key",
-					    "fwupd::RemoteId",
-					    NULL);
-		xb_builder_source_set_info(source, custom);
-
-		/* we need to watch for changes? */
-		xb_builder_import_source(builder, source);
 	}
 
 	/* add any client-side data, e.g. BKC tags */
@@ -4641,10 +4831,6 @@ fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **
 	if (!fu_engine_load_metadata_store_local(self, builder, FU_PATH_KIND_DATADIR_PKG, error))
 		return FALSE;
 
-	/* on a read-only filesystem don't care about the cache GUID */
-	if (flags & FU_ENGINE_LOAD_FLAG_READONLY)
-		compile_flags |= XB_BUILDER_COMPILE_FLAG_IGNORE_GUID;
-
 	/* ensure silo is up to date */
 	if (flags & FU_ENGINE_LOAD_FLAG_NO_CACHE) {
 		g_autoptr(GFileIOStream) iostr = NULL;
@@ -4740,28 +4926,117 @@ fu_engine_get_newest_signature_jcat_result(GPtrArray *results, GError **error)
 	return NULL;
 }
 
-static JcatResult *
-fu_engine_get_system_jcat_result(FuEngine *self, FwupdRemote *remote, GError **error)
+static gchar *
+fu_engine_get_system_jcat_verified_filename(FwupdRemote *remote)
+{
+	return g_strdup_printf("%s.verified", fwupd_remote_get_filename_cache_sig(remote));
+}
+
+/* the signing timestamp is only trusted for the exact signature it was verified from */
+static gboolean
+fu_engine_load_system_jcat_timestamp(FwupdRemote *remote, GBytes *blob_sig, gint64 *timestamp)
+{
+	const gchar *group = "fwupd Signature";
+	g_autofree gchar *checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, blob_sig);
+	g_autofree gchar *checksum_old = NULL;
+	g_autofree gchar *filename = fu_engine_get_system_jcat_verified_filename(remote);
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GKeyFile) kf = g_key_file_new();
+
+	if (!g_key_file_load_from_file(kf, filename, G_KEY_FILE_NONE, NULL))
+		return FALSE;
+	checksum_old = g_key_file_get_string(kf, group, "Checksum", NULL);
+	if (g_strcmp0(checksum, checksum_old) != 0) {
+		g_debug("signature for %s changed since it was verified",
+			fwupd_remote_get_id(remote));
+		return FALSE;
+	}
+	*timestamp = g_key_file_get_int64(kf, group, "Timestamp", &error_local);
+	if (error_local != NULL) {
+		g_debug("no verified timestamp: %s", error_local->message);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_engine_save_system_jcat_timestamp(FwupdRemote *remote,
+				     GBytes *blob_sig,
+				     gint64 timestamp,
+				     GError **error)
+{
+	const gchar *group = "fwupd Signature";
+	g_autofree gchar *checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, blob_sig);
+	g_autofree gchar *filename = fu_engine_get_system_jcat_verified_filename(remote);
+	g_autoptr(GKeyFile) kf = g_key_file_new();
+
+	g_key_file_set_string(kf, group, "Checksum", checksum);
+	g_key_file_set_int64(kf, group, "Timestamp", timestamp);
+	return g_key_file_save_to_file(kf, filename, error);
+}
+
+/* the cached metadata was removed, so the verified timestamp no longer applies */
+static void
+fu_engine_remove_system_jcat_timestamp(FwupdRemote *remote)
+{
+	g_autofree gchar *filename = fu_engine_get_system_jcat_verified_filename(remote);
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GFile) file = g_file_new_for_path(filename);
+
+	if (!g_file_delete(file, NULL, &error_local) &&
+	    !g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+		g_warning("failed to delete %s: %s", filename, error_local->message);
+}
+
+gboolean
+fu_engine_get_system_jcat_timestamp(FuEngine *self,
+				    FwupdRemote *remote,
+				    gint64 *timestamp,
+				    GError **error)
 {
 	g_autoptr(GBytes) blob = NULL;
 	g_autoptr(GBytes) blob_sig = NULL;
+	g_autoptr(GError) error_local = NULL;
 	g_autoptr(GInputStream) istream = NULL;
 	g_autoptr(GPtrArray) results = NULL;
 	g_autoptr(JcatItem) jcat_item = NULL;
 	g_autoptr(JcatFile) jcat_file = jcat_file_new();
+	g_autoptr(JcatResult) jcat_result = NULL;
 
+	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
+	g_return_val_if_fail(FWUPD_IS_REMOTE(remote), FALSE);
+	g_return_val_if_fail(timestamp != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (!g_file_test(fwupd_remote_get_filename_cache(remote), G_FILE_TEST_EXISTS)) {
+		fu_engine_remove_system_jcat_timestamp(remote);
+		g_set_error(error,
+			    G_FILE_ERROR,
+			    G_FILE_ERROR_NOENT,
+			    "%s does not exist",
+			    fwupd_remote_get_filename_cache(remote));
+		return FALSE;
+	}
+	blob_sig = fu_bytes_get_contents(fwupd_remote_get_filename_cache_sig(remote), error);
+	if (blob_sig == NULL) {
+		fu_engine_remove_system_jcat_timestamp(remote);
+		return FALSE;
+	}
+
+	/* already verified when it was saved */
+	if (fu_engine_load_system_jcat_timestamp(remote, blob_sig, timestamp))
+		return TRUE;
+
+	/* verify the old metadata again, e.g. when upgrading from an older version */
 	blob = fu_bytes_get_contents(fwupd_remote_get_filename_cache(remote), error);
 	if (blob == NULL)
-		return NULL;
-	blob_sig = fu_bytes_get_contents(fwupd_remote_get_filename_cache_sig(remote), error);
-	if (blob_sig == NULL)
-		return NULL;
+		return FALSE;
 	istream = g_memory_input_stream_new_from_bytes(blob_sig);
 	if (!jcat_file_import_stream(jcat_file, istream, JCAT_IMPORT_FLAG_NONE, NULL, error))
-		return NULL;
+		return FALSE;
 	jcat_item = jcat_file_get_item_default(jcat_file, error);
 	if (jcat_item == NULL)
-		return NULL;
+		return FALSE;
 	results = jcat_context_verify_item(self->jcat_context,
 					   blob,
 					   jcat_item,
@@ -4769,30 +5044,51 @@ fu_engine_get_system_jcat_result(FuEngine *self, FwupdRemote *remote, GError **e
 					       JCAT_VERIFY_FLAG_REQUIRE_SIGNATURE,
 					   error);
 	if (results == NULL)
-		return NULL;
+		return FALSE;
 
-	/* return the newest signature */
-	return fu_engine_get_newest_signature_jcat_result(results, error);
+	/* use the newest signature */
+	jcat_result = fu_engine_get_newest_signature_jcat_result(results, error);
+	if (jcat_result == NULL)
+		return FALSE;
+	*timestamp = jcat_result_get_timestamp(jcat_result);
+	if (!fu_engine_save_system_jcat_timestamp(remote, blob_sig, *timestamp, &error_local))
+		g_warning("failed to save verified timestamp: %s", error_local->message);
+	return TRUE;
 }
 
-static gboolean
-fu_engine_validate_result_timestamp(JcatResult *jcat_result,
-				    JcatResult *jcat_result_old,
+gboolean
+fu_engine_validate_result_timestamp(FuEngine *self,
+				    FwupdRemote *remote,
+				    JcatResult *jcat_result,
 				    GError **error)
 {
 	gint64 delta = 0;
+	gint64 timestamp_old = 0;
+	g_autoptr(GError) error_local = NULL;
 
+	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
+	g_return_val_if_fail(FWUPD_IS_REMOTE(remote), FALSE);
 	g_return_val_if_fail(JCAT_IS_RESULT(jcat_result), FALSE);
-	g_return_val_if_fail(JCAT_IS_RESULT(jcat_result_old), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* verify the metadata was signed later than the existing
+	 * metadata for this remote to mitigate a rollback attack */
+	if (!fu_engine_get_system_jcat_timestamp(self, remote, &timestamp_old, &error_local)) {
+		if (g_error_matches(error_local, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+			g_info("no existing valid keyrings: %s", error_local->message);
+		} else {
+			g_warning("could not get existing keyring result: %s",
+				  error_local->message);
+		}
+		return TRUE;
+	}
 
 	if (jcat_result_get_timestamp(jcat_result) == 0) {
 		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE, "no signing timestamp");
 		return FALSE;
 	}
-	if (jcat_result_get_timestamp(jcat_result_old) > 0) {
-		delta = jcat_result_get_timestamp(jcat_result) -
-			jcat_result_get_timestamp(jcat_result_old);
-	}
+	if (timestamp_old > 0)
+		delta = jcat_result_get_timestamp(jcat_result) - timestamp_old;
 	if (delta < 0) {
 		g_set_error(error,
 			    FWUPD_ERROR,
@@ -4828,6 +5124,7 @@ fu_engine_update_metadata_bytes(FuEngine *self,
 	FwupdKeyringKind keyring_kind;
 	FwupdRemote *remote;
 	JcatVerifyFlags jcat_flags = JCAT_VERIFY_FLAG_REQUIRE_SIGNATURE;
+	gint64 jcat_timestamp = 0;
 	g_autoptr(JcatFile) jcat_file = jcat_file_new();
 
 	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
@@ -4883,11 +5180,9 @@ fu_engine_update_metadata_bytes(FuEngine *self,
 
 	/* verify file */
 	if (keyring_kind != FWUPD_KEYRING_KIND_NONE) {
-		g_autoptr(GError) error_local = NULL;
 		g_autoptr(GPtrArray) results = NULL;
 		g_autoptr(JcatItem) jcat_item = NULL;
 		g_autoptr(JcatResult) jcat_result = NULL;
-		g_autoptr(JcatResult) jcat_result_old = NULL;
 
 		/* this should only be signing one thing */
 		jcat_item = jcat_file_get_item_default(jcat_file, error);
@@ -4905,23 +5200,9 @@ fu_engine_update_metadata_bytes(FuEngine *self,
 		jcat_result = fu_engine_get_newest_signature_jcat_result(results, error);
 		if (jcat_result == NULL)
 			return FALSE;
-
-		/* verify the metadata was signed later than the existing
-		 * metadata for this remote to mitigate a rollback attack */
-		jcat_result_old = fu_engine_get_system_jcat_result(self, remote, &error_local);
-		if (jcat_result_old == NULL) {
-			if (g_error_matches(error_local, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
-				g_info("no existing valid keyrings: %s", error_local->message);
-			} else {
-				g_warning("could not get existing keyring result: %s",
-					  error_local->message);
-			}
-		} else {
-			if (!fu_engine_validate_result_timestamp(jcat_result,
-								 jcat_result_old,
-								 error))
-				return FALSE;
-		}
+		jcat_timestamp = jcat_result_get_timestamp(jcat_result);
+		if (!fu_engine_validate_result_timestamp(self, remote, jcat_result, error))
+			return FALSE;
 	}
 
 	/* save XML and signature to remotes.d */
@@ -4933,6 +5214,16 @@ fu_engine_update_metadata_bytes(FuEngine *self,
 					   error))
 			return FALSE;
 	}
+
+	/* remember the signing timestamp so the next refresh does not have to verify it again */
+	if (keyring_kind == FWUPD_KEYRING_KIND_JCAT) {
+		g_autoptr(GError) error_local = NULL;
+		if (!fu_engine_save_system_jcat_timestamp(remote,
+							  bytes_sig,
+							  jcat_timestamp,
+							  &error_local))
+			g_warning("failed to save verified timestamp: %s", error_local->message);
+	}
 	if (!fu_engine_load_metadata_store(self, FU_ENGINE_LOAD_FLAG_NONE, error))
 		return FALSE;
 
@@ -5005,6 +5296,102 @@ fu_engine_update_metadata(FuEngine *self,
 #endif
 }
 
+static gboolean
+fu_engine_touch_filename(const gchar *filename, guint64 mtime, GError **error)
+{
+	g_autoptr(GFile) file = g_file_new_for_path(filename);
+	return g_file_set_attribute_uint64(file,
+					   G_FILE_ATTRIBUTE_TIME_MODIFIED,
+					   mtime,
+					   G_FILE_QUERY_INFO_NONE,
+					   NULL,
+					   error);
+}
+
+/**
+ * fu_engine_touch_metadata:
+ * @self: a #FuEngine
+ * @remote_id: a remote ID, e.g. `lvfs`
+ * @checksum: SHA256 of the metadata signature the client has checked is still current
+ * @error: (nullable): optional return location for an error
+ *
+ * Marks the existing metadata of a remote as refreshed, for when the server reports that
+ * nothing has changed since it was last downloaded.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_engine_touch_metadata(FuEngine *self,
+			 const gchar *remote_id,
+			 const gchar *checksum,
+			 GError **error)
+{
+	FwupdRemote *remote;
+	guint64 mtime = (guint64)g_get_real_time() / G_USEC_PER_SEC;
+	g_autofree gchar *checksum_actual = NULL;
+	g_autoptr(GBytes) bytes_sig = NULL;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
+	g_return_val_if_fail(remote_id != NULL, FALSE);
+	g_return_val_if_fail(checksum != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* check remote is valid */
+	remote = fu_remote_list_get_by_id(self->remote_list, remote_id);
+	if (remote == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_FOUND,
+			    "remote %s not found",
+			    remote_id);
+		return FALSE;
+	}
+	if (!fwupd_remote_get_enabled(remote)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "remote %s not enabled",
+			    remote_id);
+		return FALSE;
+	}
+	if (fwupd_remote_get_kind(remote) != FWUPD_REMOTE_KIND_DOWNLOAD ||
+	    fwupd_remote_get_keyring_kind(remote) == FWUPD_KEYRING_KIND_NONE) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "remote %s has no signed metadata",
+			    remote_id);
+		return FALSE;
+	}
+
+	/* the metadata may have been replaced since the client checked */
+	bytes_sig = fu_bytes_get_contents(fwupd_remote_get_filename_cache_sig(remote), error);
+	if (bytes_sig == NULL)
+		return FALSE;
+	checksum_actual = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, bytes_sig);
+	if (g_strcmp0(checksum, checksum_actual) != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "metadata signature of %s is %s, not %s",
+			    remote_id,
+			    checksum_actual,
+			    checksum);
+		return FALSE;
+	}
+
+	/* the age of the metadata is the mtime of the cache file */
+	if (!fu_engine_touch_filename(fwupd_remote_get_filename_cache(remote), mtime, error))
+		return FALSE;
+	if (!fu_engine_touch_filename(fwupd_remote_get_filename_cache_sig(remote), mtime, error))
+		return FALSE;
+	fwupd_remote_set_mtime(remote, mtime);
+
+	/* make the UI update */
+	fu_engine_emit_changed(self);
+	return TRUE;
+}
+
 /**
  * fu_engine_get_silo_from_blob:
  * @self: a #FuEngine
@@ -5207,7 +5594,7 @@ fu_engine_get_details_for_bytes(FuEngine *self,
 
 	/* calculate the checksums of the blob */
 	for (guint i = 0; checksum_types[i] != 0; i++)
-		g_ptr_array_add(checksums, g_compute_checksum_for_bytes(checksum_types[i], blob));
+		g_ptr_array_add(checksums, fu_bytes_get_checksum(blob, checksum_types[i]));
 
 	/* does this exist in any enabled remote */
 	for (guint i = 0; i < checksums->len; i++) {
@@ -5293,16 +5680,18 @@ GPtrArray *
 fu_engine_get_details(FuEngine *self, FuEngineRequest *request, gint fd, GError **error)
 {
 	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob_cab = NULL;
 
 	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
 	g_return_val_if_fail(fd > 0, NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
-	/* get all components */
+	/* get all components, hashing the archive only once */
 	blob = fu_bytes_get_contents_fd(fd, fu_config_get_archive_size_max(self->config), error);
 	if (blob == NULL)
 		return NULL;
-	return fu_engine_get_details_for_bytes(self, request, blob, error);
+	blob_cab = fu_bytes_new_with_checksums(blob);
+	return fu_engine_get_details_for_bytes(self, request, blob_cab, error);
 }
 
 static gint
@@ -5807,7 +6196,7 @@ fu_engine_get_releases_for_device(FuEngine *self,
 	g_autoptr(GPtrArray) releases = NULL;
 
 	/* no components in silo */
-	if (self->query_component_by_guid == NULL) {
+	if (self->components_by_guid == NULL) {
 		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no components in silo");
 		return NULL;
 	}
@@ -5835,29 +6224,11 @@ fu_engine_get_releases_for_device(FuEngine *self,
 	releases = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	for (guint j = 0; j < device_guids->len; j++) {
 		const gchar *guid = g_ptr_array_index(device_guids, j);
-		g_autoptr(GError) error_local = NULL;
-		g_autoptr(GPtrArray) components = NULL;
-#if LIBXMLB_CHECK_VERSION(0, 3, 0)
-		g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
-
-		xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-		components = xb_silo_query_with_context(self->silo,
-							self->query_component_by_guid,
-							&context,
-							&error_local);
-#else
-		if (!xb_query_bind_str(self->query_component_by_guid, 0, guid, &error_local)) {
-			g_warning("failed to bind 0: %s", error_local->message);
-			return NULL;
-		}
-		components =
-		    xb_silo_query_full(self->silo, self->query_component_by_guid, &error_local);
-#endif
+		GPtrArray *components = g_hash_table_lookup(self->components_by_guid, guid);
 
 		/* nothing found */
 		if (components == NULL) {
-			g_debug("%s was not found: %s", guid, error_local->message);
+			g_debug("%s was not found", guid);
 			continue;
 		}
 
@@ -6120,14 +6491,20 @@ fu_engine_set_blocked_firmware(FuEngine *self, GPtrArray *checksums, GError **er
 	}
 
 	/* save database */
-	if (!fu_history_clear_blocked_firmware(self->history, error))
+	if (!fu_history_transaction_begin(self->history, error))
 		return FALSE;
+	if (!fu_history_clear_blocked_firmware(self->history, error)) {
+		fu_history_transaction_rollback(self->history);
+		return FALSE;
+	}
 	for (guint i = 0; i < checksums->len; i++) {
 		const gchar *csum = g_ptr_array_index(checksums, i);
-		if (!fu_history_add_blocked_firmware(self->history, csum, error))
+		if (!fu_history_add_blocked_firmware(self->history, csum, error)) {
+			fu_history_transaction_rollback(self->history);
 			return FALSE;
+		}
 	}
-	return TRUE;
+	return fu_history_transaction_commit(self->history, error);
 }
 
 gchar *
@@ -6446,10 +6823,43 @@ fu_engine_plugin_device_register(FuEngine *self, FuDevice *device)
 	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_REGISTERED);
 }
 
+/* the plugin signal was emitted from a coldplug worker thread, so replay it when done */
+static gboolean
+fu_engine_coldplug_defer_event(FuEngineColdplugEventKind kind, FuPlugin *plugin, FuDevice *device)
+{
+	FuEngineColdplugItem *item = g_private_get(&fu_engine_coldplug_item);
+	FuEngineColdplugEvent *event;
+
+	if (item == NULL)
+		return FALSE;
+	event = g_new0(FuEngineColdplugEvent, 1);
+	event->kind = kind;
+	event->plugin = g_object_ref(plugin);
+	if (device != NULL)
+		event->device = g_object_ref(device);
+	g_ptr_array_add(item->events, event);
+	return TRUE;
+}
+
+/* blocks the coldplug worker thread until the main thread has run the request */
+static void
+fu_engine_coldplug_request_run(FuEngineColdplugHelper *helper, FuEngineColdplugRequest *req)
+{
+	g_async_queue_push(helper->requests, req);
+	g_mutex_lock(&helper->mutex);
+	while (!req->done)
+		g_cond_wait(&helper->cond, &helper->mutex);
+	g_mutex_unlock(&helper->mutex);
+}
+
 static void
 fu_engine_plugin_device_register_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data)
 {
 	FuEngine *self = FU_ENGINE(user_data);
+	if (fu_engine_coldplug_defer_event(FU_ENGINE_COLDPLUG_EVENT_KIND_DEVICE_REGISTER,
+					   plugin,
+					   device))
+		return;
 	fu_engine_plugin_device_register(self, device);
 }
 
@@ -6458,6 +6868,12 @@ fu_engine_plugin_device_added_cb(FuPlugin *plugin, FuDevice *device, gpointer us
 {
 	FuEngine *self = FU_ENGINE(user_data);
 
+	/* added from a coldplug worker thread, so add in a deterministic order when done */
+	if (fu_engine_coldplug_defer_event(FU_ENGINE_COLDPLUG_EVENT_KIND_DEVICE_ADDED,
+					   plugin,
+					   device))
+		return;
+
 	/* plugin has prio and device not already set from quirk */
 	if (fu_plugin_get_priority(plugin) > 0 && fu_device_get_priority(device) == 0) {
 		g_info("auto-setting %s priority to %u",
@@ -6777,7 +7193,13 @@ static void
 fu_engine_plugin_rules_changed_cb(FuPlugin *plugin, gpointer user_data)
 {
 	FuEngine *self = FU_ENGINE(user_data);
-	GPtrArray *rules = fu_plugin_get_rules(plugin, FU_PLUGIN_RULE_INHIBITS_IDLE);
+	GPtrArray *rules;
+
+	if (fu_engine_coldplug_defer_event(FU_ENGINE_COLDPLUG_EVENT_KIND_RULES_CHANGED,
+					   plugin,
+					   NULL))
+		return;
+	rules = fu_plugin_get_rules(plugin, FU_PLUGIN_RULE_INHIBITS_IDLE);
 	if (rules == NULL)
 		return;
 	for (guint j = 0; j < rules->len; j++) {
@@ -6790,6 +7212,10 @@ static void
 fu_engine_plugin_config_changed_cb(FuPlugin *plugin, gpointer user_data)
 {
 	FuEngine *self = FU_ENGINE(user_data);
+	if (fu_engine_coldplug_defer_event(FU_ENGINE_COLDPLUG_EVENT_KIND_CONFIG_CHANGED,
+					   plugin,
+					   NULL))
+		return;
 	g_info("config file for %s changed, sending SHUTDOWN", fu_plugin_get_name(plugin));
 	fu_engine_set_status(self, FWUPD_STATUS_SHUTDOWN);
 }
@@ -6814,6 +7240,12 @@ fu_engine_plugin_device_removed_cb(FuPlugin *plugin, FuDevice *device, gpointer
 	g_autoptr(FuDevice) device_tmp = NULL;
 	g_autoptr(GError) error = NULL;
 
+	/* removed from a coldplug worker thread, so remove after any earlier add */
+	if (fu_engine_coldplug_defer_event(FU_ENGINE_COLDPLUG_EVENT_KIND_DEVICE_REMOVED,
+					   plugin,
+					   device))
+		return;
+
 	device_tmp = fu_device_list_get_by_id(self->device_list, fu_device_get_id(device), &error);
 	if (device_tmp == NULL) {
 		g_info("failed to find device %s: %s", fu_device_get_id(device), error->message);
@@ -6904,9 +7336,21 @@ fu_engine_add_plugin_filter(FuEngine *self, const gchar *plugin_glob)
 static gboolean
 fu_engine_plugin_check_supported_cb(FuPlugin *plugin, const gchar *guid, FuEngine *self)
 {
+	FuEngineColdplugItem *item = g_private_get(&fu_engine_coldplug_item);
 	g_autoptr(XbNode) n = NULL;
 	g_autofree gchar *xpath = NULL;
 
+	/* called from a coldplug worker thread, so query the silo in the main thread */
+	if (item != NULL) {
+		FuEngineColdplugRequest req = {
+		    .kind = FU_ENGINE_COLDPLUG_REQUEST_KIND_CHECK_SUPPORTED,
+		    .plugin = plugin,
+		    .guid = guid,
+		};
+		fu_engine_coldplug_request_run(item->helper, &req);
+		return req.result;
+	}
+
 	if (fu_config_get_enumerate_all_devices(self->config))
 		return TRUE;
 
@@ -7040,14 +7484,6 @@ fu_engine_record_security_attrs(FuEngine *self, GError **error)
 {
 #if JSON_CHECK_VERSION(1, 6, 0)
 	g_autoptr(GPtrArray) attrs_array = NULL;
-	g_autofree gchar *json = NULL;
-
-	/* convert attrs to json string */
-	json = fu_security_attrs_to_json_string(self->host_security_attrs, error);
-	if (json == NULL) {
-		g_prefix_error(error, "cannot convert current attrs to string: ");
-		return FALSE;
-	}
 
 	/* check that we did not store this already last boot */
 	attrs_array = fu_history_get_security_attrs(self->history, 1, error);
@@ -7065,7 +7501,7 @@ fu_engine_record_security_attrs(FuEngine *self, GError **error)
 
 	/* write new values */
 	if (!fu_history_add_security_attribute(self->history,
-					       json,
+					       self->host_security_attrs,
 					       self->host_security_id,
 					       error)) {
 		g_prefix_error(error, "failed to write to DB: ");
@@ -7653,7 +8089,10 @@ fu_engine_backend_device_added_run_plugin(FuEngine *self,
 }
 
 static void
-fu_engine_backend_device_added_run_plugins(FuEngine *self, FuDevice *device, FuProgress *progress)
+fu_engine_backend_device_added_run_plugins(FuEngine *self,
+					   FuDevice *device,
+					   GHashTable *plugin_locks,
+					   FuProgress *progress)
 {
 	g_autoptr(GPtrArray) possible_plugins = fu_device_get_possible_plugins(device);
 
@@ -7662,12 +8101,23 @@ fu_engine_backend_device_added_run_plugins(FuEngine *self, FuDevice *device, FuP
 	fu_progress_set_steps(progress, possible_plugins->len);
 	for (guint i = 0; i < possible_plugins->len; i++) {
 		const gchar *plugin_name = g_ptr_array_index(possible_plugins, i);
+		gboolean ret;
+		GMutex *plugin_lock = NULL;
 		g_autoptr(GError) error_local = NULL;
-		if (!fu_engine_backend_device_added_run_plugin(self,
-							       device,
-							       plugin_name,
-							       fu_progress_get_child(progress),
-							       &error_local)) {
+
+		/* plugins are not thread safe, so only run one device at a time */
+		if (plugin_locks != NULL)
+			plugin_lock = g_hash_table_lookup(plugin_locks, plugin_name);
+		if (plugin_lock != NULL)
+			g_mutex_lock(plugin_lock);
+		ret = fu_engine_backend_device_added_run_plugin(self,
+								device,
+								plugin_name,
+								fu_progress_get_child(progress),
+								&error_local);
+		if (plugin_lock != NULL)
+			g_mutex_unlock(plugin_lock);
+		if (!ret) {
 			if (g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
 				g_debug("%s ignoring: %s", plugin_name, error_local->message);
 			} else {
@@ -7683,12 +8133,31 @@ fu_engine_backend_device_added_run_plugins(FuEngine *self, FuDevice *device, FuP
 	}
 }
 
+static gboolean
+fu_engine_backend_device_probe(FuEngine *self, FuDevice *device)
+{
+	g_autoptr(GError) error_local = NULL;
+
+	if (!fu_device_probe(device, &error_local)) {
+		if (!g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+			g_warning("failed to probe device %s: %s",
+				  fu_device_get_backend_id(device),
+				  error_local->message);
+		} else {
+			g_debug("failed to probe device %s : %s",
+				fu_device_get_backend_id(device),
+				error_local->message);
+		}
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static void
 fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *progress)
 {
 	g_autofree gchar *str1 = NULL;
 	g_autofree gchar *str2 = NULL;
-	g_autoptr(GError) error_local = NULL;
 
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
@@ -7703,16 +8172,7 @@ fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *pro
 
 	/* add any extra quirks */
 	fu_device_set_context(device, self->ctx);
-	if (!fu_device_probe(device, &error_local)) {
-		if (!g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
-			g_warning("failed to probe device %s: %s",
-				  fu_device_get_backend_id(device),
-				  error_local->message);
-		} else {
-			g_debug("failed to probe device %s : %s",
-				fu_device_get_backend_id(device),
-				error_local->message);
-		}
+	if (!fu_engine_backend_device_probe(self, device)) {
 		fu_progress_finished(progress);
 		return;
 	}
@@ -7729,7 +8189,10 @@ fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *pro
 	fu_engine_check_firmware_attributes(self, device, TRUE);
 
 	/* can be specified using a quirk */
-	fu_engine_backend_device_added_run_plugins(self, device, fu_progress_get_child(progress));
+	fu_engine_backend_device_added_run_plugins(self,
+						   device,
+						   NULL,
+						   fu_progress_get_child(progress));
 	fu_progress_step_done(progress);
 }
 
@@ -7831,8 +8294,12 @@ fu_engine_load_quirks_for_hwid(FuEngine *self, const gchar *hwid)
 	}
 }
 
+/* sets @needs_write if @dev_history has to be saved, even when returning %FALSE */
 static gboolean
-fu_engine_update_history_device(FuEngine *self, FuDevice *dev_history, GError **error)
+fu_engine_update_history_device(FuEngine *self,
+				FuDevice *dev_history,
+				gboolean *needs_write,
+				GError **error)
 {
 	FuPlugin *plugin;
 	FwupdRelease *rel_history;
@@ -7874,13 +8341,7 @@ fu_engine_update_history_device(FuEngine *self, FuDevice *dev_history, GError **
 	metadata_device = fu_device_report_metadata_post(dev);
 	if (metadata_device != NULL && g_hash_table_size(metadata_device) > 0) {
 		fwupd_release_add_metadata(rel_history, metadata_device);
-		if (!fu_history_modify_device_release(self->history,
-						      dev_history,
-						      rel_history,
-						      error)) {
-			g_prefix_error(error, "failed to set metadata: ");
-			return FALSE;
-		}
+		*needs_write = TRUE;
 	}
 
 	/* measure the "new" system state */
@@ -7909,10 +8370,8 @@ fu_engine_update_history_device(FuEngine *self, FuDevice *dev_history, GError **
 		fu_device_set_version(dev_history, fu_device_get_version(dev));
 		fu_device_remove_flag(dev_history, FWUPD_DEVICE_FLAG_NEEDS_ACTIVATION);
 		fu_device_set_update_state(dev_history, FWUPD_UPDATE_STATE_SUCCESS);
-		return fu_history_modify_device_release(self->history,
-							dev_history,
-							rel_history,
-							error);
+		*needs_write = TRUE;
+		return TRUE;
 	}
 
 	/* does the plugin know the update failure */
@@ -7931,13 +8390,15 @@ fu_engine_update_history_device(FuEngine *self, FuDevice *dev_history, GError **
 	}
 
 	/* update the state in the database */
-	return fu_history_modify_device_release(self->history, dev_history, rel_history, error);
+	*needs_write = TRUE;
+	return TRUE;
 }
 
 static gboolean
 fu_engine_update_history_database(FuEngine *self, GError **error)
 {
 	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) devices_changed = g_ptr_array_new();
 
 	/* get any devices */
 	devices = fu_history_get_devices(self->history, error);
@@ -7945,6 +8406,7 @@ fu_engine_update_history_database(FuEngine *self, GError **error)
 		return FALSE;
 	for (guint i = 0; i < devices->len; i++) {
 		FuDevice *dev = g_ptr_array_index(devices, i);
+		gboolean needs_write = FALSE;
 		g_autoptr(GError) error_local = NULL;
 
 		/* not in the required state */
@@ -7952,12 +8414,26 @@ fu_engine_update_history_database(FuEngine *self, GError **error)
 		    fu_device_get_update_state(dev) != FWUPD_UPDATE_STATE_PENDING)
 			continue;
 
-		/* try to save the new update-state, but ignoring any error */
-		if (!fu_engine_update_history_device(self, dev, &error_local)) {
+		/* try to get the new update-state, but ignoring any error */
+		if (!fu_engine_update_history_device(self, dev, &needs_write, &error_local))
 			g_warning("failed to update history database: %s", error_local->message);
-		}
+		if (needs_write)
+			g_ptr_array_add(devices_changed, dev);
 	}
-	return TRUE;
+	if (devices_changed->len == 0)
+		return TRUE;
+
+	/* write all the changes at once, without calling into the plugins with the lock held */
+	if (!fu_history_transaction_begin(self->history, error))
+		return FALSE;
+	for (guint i = 0; i < devices_changed->len; i++) {
+		FuDevice *dev = g_ptr_array_index(devices_changed, i);
+		FwupdRelease *rel = fu_device_get_release_default(dev);
+		g_autoptr(GError) error_local = NULL;
+		if (!fu_history_modify_device_release(self->history, dev, rel, &error_local))
+			g_warning("failed to update history database: %s", error_local->message);
+	}
+	return fu_history_transaction_commit(self->history, error);
 }
 
 static void
@@ -8094,6 +8570,270 @@ fu_common_win32_registry_get_string(HKEY hkey,
 }
 #endif
 
+static void
+fu_engine_coldplug_event_free(FuEngineColdplugEvent *event)
+{
+	g_object_unref(event->plugin);
+	if (event->device != NULL)
+		g_object_unref(event->device);
+	g_free(event);
+}
+
+static void
+fu_engine_coldplug_item_free(FuEngineColdplugItem *item)
+{
+	g_object_unref(item->device);
+	g_object_unref(item->progress);
+	g_ptr_array_unref(item->events);
+	g_free(item);
+}
+
+static void
+fu_engine_coldplug_plugin_lock_free(GMutex *mutex)
+{
+	g_mutex_clear(mutex);
+	g_free(mutex);
+}
+
+/* devices are probed in the same worker as the topmost device they are below, e.g. both
+ * usb:01:00 and usb:01:00:03 use usb:01:00, and the same for sysfs paths */
+static gchar *
+fu_engine_backend_device_get_root_key(FuDevice *device, GHashTable *backend_ids)
+{
+	const gchar *backend_id = fu_device_get_backend_id(device);
+	const gchar *sep;
+	g_autofree gchar *key = NULL;
+	g_autofree gchar *tmp = NULL;
+
+	if (backend_id == NULL)
+		return g_strdup("");
+
+	/* sysfs path or USB platform ID */
+	sep = g_str_has_prefix(backend_id, "/") ? "/" : ":";
+	key = g_strdup(backend_id);
+	tmp = g_strdup(backend_id);
+	while (TRUE) {
+		gchar *tok = g_strrstr(tmp, sep);
+		if (tok == NULL || tok == tmp)
+			break;
+		*tok = '\0';
+		if (g_hash_table_contains(backend_ids, tmp)) {
+			g_free(key);
+			key = g_strdup(tmp);
+		}
+	}
+	return g_steal_pointer(&key);
+}
+
+static void
+fu_engine_backends_coldplug_worker_cb(gpointer data, gpointer user_data)
+{
+	GPtrArray *items = (GPtrArray *)data;
+	FuEngineColdplugHelper *helper = (FuEngineColdplugHelper *)user_data;
+	FuEngineColdplugRequest *req_done = g_new0(FuEngineColdplugRequest, 1);
+
+	for (guint i = 0; i < items->len; i++) {
+		FuEngineColdplugItem *item = g_ptr_array_index(items, i);
+		FuEngineColdplugRequest req = {
+		    .kind = FU_ENGINE_COLDPLUG_REQUEST_KIND_DEVICE_PROBED,
+		    .device = item->device,
+		};
+		g_autofree gchar *str = NULL;
+
+		if (!fu_engine_backend_device_probe(helper->self, item->device))
+			continue;
+
+		/* these modify engine state */
+		fu_engine_coldplug_request_run(helper, &req);
+
+		/* super useful for plugin development */
+		str = fu_device_to_string(item->device);
+		g_debug("%s added %s", fu_device_get_backend_id(item->device), str);
+
+		/* any plugin signals are replayed when all the workers are done */
+		g_private_set(&fu_engine_coldplug_item, item);
+		fu_engine_backend_device_added_run_plugins(helper->self,
+							   item->device,
+							   helper->plugin_locks,
+							   item->progress);
+		g_private_set(&fu_engine_coldplug_item, NULL);
+	}
+
+	/* the main thread waits for every group */
+	req_done->kind = FU_ENGINE_COLDPLUG_REQUEST_KIND_GROUP_DONE;
+	g_async_queue_push(helper->requests, req_done);
+}
+
+/* run in the main thread */
+static void
+fu_engine_coldplug_request_handle(FuEngine *self, FuEngineColdplugRequest *req)
+{
+	if (req->kind == FU_ENGINE_COLDPLUG_REQUEST_KIND_DEVICE_PROBED) {
+		/* same order as fu_engine_backend_device_added() */
+		fu_engine_ensure_device_emulation_tag(self, req->device);
+		fu_engine_check_firmware_attributes(self, req->device, TRUE);
+		return;
+	}
+	if (req->kind == FU_ENGINE_COLDPLUG_REQUEST_KIND_CHECK_SUPPORTED) {
+		req->result = fu_engine_plugin_check_supported_cb(req->plugin, req->guid, self);
+		return;
+	}
+}
+
+/* run in the main thread */
+static void
+fu_engine_coldplug_event_replay(FuEngine *self, FuEngineColdplugEvent *event)
+{
+	if (event->kind == FU_ENGINE_COLDPLUG_EVENT_KIND_DEVICE_ADDED) {
+		fu_engine_plugin_device_added_cb(event->plugin, event->device, self);
+		return;
+	}
+	if (event->kind == FU_ENGINE_COLDPLUG_EVENT_KIND_DEVICE_REMOVED) {
+		fu_engine_plugin_device_removed_cb(event->plugin, event->device, self);
+		return;
+	}
+	if (event->kind == FU_ENGINE_COLDPLUG_EVENT_KIND_DEVICE_REGISTER) {
+		fu_engine_plugin_device_register_cb(event->plugin, event->device, self);
+		return;
+	}
+	if (event->kind == FU_ENGINE_COLDPLUG_EVENT_KIND_RULES_CHANGED) {
+		fu_engine_plugin_rules_changed_cb(event->plugin, self);
+		return;
+	}
+	if (event->kind == FU_ENGINE_COLDPLUG_EVENT_KIND_CONFIG_CHANGED) {
+		fu_engine_plugin_config_changed_cb(event->plugin, self);
+		return;
+	}
+}
+
+static gboolean
+fu_engine_backends_coldplug_backend_add_devices_parallel(FuEngine *self,
+							 FuBackend *backend,
+							 GPtrArray *devices,
+							 FuProgress *progress,
+							 GError **error)
+{
+	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
+	GThreadPool *pool;
+	FuEngineColdplugHelper helper = {.self = self};
+	guint groups_pending = 0;
+	g_autoptr(GError) error_push = NULL;
+	g_autoptr(GHashTable) backend_ids = g_hash_table_new(g_str_hash, g_str_equal);
+	g_autoptr(GHashTable) groups = NULL;
+	g_autoptr(GHashTable) plugin_locks = NULL;
+	g_autoptr(GPtrArray) group_keys = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(GPtrArray) items = NULL;
+
+	/* one lock per plugin, created up-front so the table is read-only in the workers */
+	plugin_locks = g_hash_table_new_full(g_str_hash,
+					     g_str_equal,
+					     NULL,
+					     (GDestroyNotify)fu_engine_coldplug_plugin_lock_free);
+	for (guint i = 0; i < plugins->len; i++) {
+		FuPlugin *plugin = g_ptr_array_index(plugins, i);
+		GMutex *mutex = g_new0(GMutex, 1);
+		g_mutex_init(mutex);
+		g_hash_table_insert(plugin_locks, (gpointer)fu_plugin_get_name(plugin), mutex);
+	}
+	helper.plugin_locks = plugin_locks;
+
+	/* group the devices by the topmost parent, preserving the backend order */
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		const gchar *backend_id = fu_device_get_backend_id(device);
+		if (backend_id != NULL)
+			g_hash_table_add(backend_ids, (gpointer)backend_id);
+	}
+	items = g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_coldplug_item_free);
+	groups = g_hash_table_new_full(g_str_hash,
+				       g_str_equal,
+				       NULL,
+				       (GDestroyNotify)g_ptr_array_unref);
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		FuEngineColdplugItem *item = g_new0(FuEngineColdplugItem, 1);
+		GPtrArray *group;
+		g_autofree gchar *key = fu_engine_backend_device_get_root_key(device, backend_ids);
+
+		item->device = g_object_ref(device);
+		item->progress = fu_progress_new(G_STRLOC);
+		item->events =
+		    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_coldplug_event_free);
+		item->helper = &helper;
+		g_ptr_array_add(items, item);
+
+		/* add any extra quirks */
+		fu_device_set_context(device, self->ctx);
+
+		group = g_hash_table_lookup(groups, key);
+		if (group == NULL) {
+			group = g_ptr_array_new();
+			g_hash_table_insert(groups, key, group);
+			g_ptr_array_add(group_keys, g_steal_pointer(&key));
+		}
+		g_ptr_array_add(group, item);
+	}
+
+	/* probe each group of devices in a worker thread */
+	pool = g_thread_pool_new(fu_engine_backends_coldplug_worker_cb,
+				 &helper,
+				 (gint)self->coldplug_threads,
+				 FALSE,
+				 error);
+	if (pool == NULL)
+		return FALSE;
+	helper.requests = g_async_queue_new();
+	g_mutex_init(&helper.mutex);
+	g_cond_init(&helper.cond);
+	g_info("coldplugging %u %s devices in %u groups using %u threads",
+	       devices->len,
+	       fu_backend_get_name(backend),
+	       group_keys->len,
+	       self->coldplug_threads);
+	for (guint i = 0; i < group_keys->len; i++) {
+		const gchar *key = g_ptr_array_index(group_keys, i);
+		if (!g_thread_pool_push(pool, g_hash_table_lookup(groups, key), &error_push))
+			break;
+		groups_pending++;
+	}
+
+	/* do anything the workers cannot until every group pushed is done */
+	while (groups_pending > 0) {
+		FuEngineColdplugRequest *req = g_async_queue_pop(helper.requests);
+		if (req->kind == FU_ENGINE_COLDPLUG_REQUEST_KIND_GROUP_DONE) {
+			g_free(req);
+			groups_pending--;
+			continue;
+		}
+		fu_engine_coldplug_request_handle(self, req);
+		g_mutex_lock(&helper.mutex);
+		req->done = TRUE;
+		g_cond_broadcast(&helper.cond);
+		g_mutex_unlock(&helper.mutex);
+	}
+	g_thread_pool_free(pool, FALSE, TRUE);
+	g_async_queue_unref(helper.requests);
+	g_mutex_clear(&helper.mutex);
+	g_cond_clear(&helper.cond);
+	if (error_push != NULL) {
+		g_propagate_error(error, g_steal_pointer(&error_push));
+		return FALSE;
+	}
+
+	/* add the devices in the same order as the backend enumerated them */
+	for (guint i = 0; i < items->len; i++) {
+		FuEngineColdplugItem *item = g_ptr_array_index(items, i);
+		for (guint j = 0; j < item->events->len; j++) {
+			FuEngineColdplugEvent *event = g_ptr_array_index(item->events, j);
+			fu_engine_coldplug_event_replay(self, event);
+		}
+		fu_progress_step_done(progress);
+	}
+
+	/* success */
+	return TRUE;
+}
+
 static gboolean
 fu_engine_backends_coldplug_backend_add_devices(FuEngine *self,
 						FuBackend *backend,
@@ -8102,6 +8842,17 @@ fu_engine_backends_coldplug_backend_add_devices(FuEngine *self,
 {
 	g_autoptr(GPtrArray) devices = fu_backend_get_devices(backend);
 
+	/* probe in parallel if enabled */
+	if (self->coldplug_threads > 1 && devices->len > 1) {
+		fu_progress_set_id(progress, G_STRLOC);
+		fu_progress_set_steps(progress, devices->len);
+		return fu_engine_backends_coldplug_backend_add_devices_parallel(self,
+										backend,
+										devices,
+										progress,
+										error);
+	}
+
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, devices->len);
@@ -8115,12 +8866,42 @@ fu_engine_backends_coldplug_backend_add_devices(FuEngine *self,
 	return TRUE;
 }
 
-static gboolean
-fu_engine_backends_coldplug_backend(FuEngine *self,
-				    FuBackend *backend,
-				    FuProgress *progress,
-				    GError **error)
+/**
+ * fu_engine_set_coldplug_threads:
+ * @self: a #FuEngine
+ * @coldplug_threads: number of threads, or 0 to use the config value
+ *
+ * Sets the number of worker threads used to probe backend devices at coldplug.
+ **/
+void
+fu_engine_set_coldplug_threads(FuEngine *self, guint coldplug_threads)
 {
+	g_return_if_fail(FU_IS_ENGINE(self));
+	self->coldplug_threads = coldplug_threads;
+}
+
+/**
+ * fu_engine_coldplug_backend:
+ * @self: a #FuEngine
+ * @backend: a #FuBackend
+ * @progress: a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Coldplugs the backend and adds any devices found, watching for hotplug events.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_engine_coldplug_backend(FuEngine *self,
+			   FuBackend *backend,
+			   FuProgress *progress,
+			   GError **error)
+{
+	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
+	g_return_val_if_fail(FU_IS_BACKEND(backend), FALSE);
+	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_NO_PROFILE);
@@ -8159,6 +8940,12 @@ fu_engine_backends_coldplug_backend(FuEngine *self,
 static void
 fu_engine_backends_coldplug(FuEngine *self, FuProgress *progress)
 {
+	FuQuirks *quirks = fu_context_get_quirks(self->ctx);
+	guint quirk_hits = fu_quirks_get_cache_hits(quirks);
+	guint quirk_misses = fu_quirks_get_cache_misses(quirks);
+	guint guid_hits = fu_common_guid_get_cache_hits();
+	guint guid_misses = fu_common_guid_get_cache_misses();
+
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, self->backends->len);
 	for (guint i = 0; i < self->backends->len; i++) {
@@ -8169,10 +8956,10 @@ fu_engine_backends_coldplug(FuEngine *self, FuProgress *progress)
 			fu_progress_step_done(progress);
 			continue;
 		}
-		if (!fu_engine_backends_coldplug_backend(self,
-							 backend,
-							 fu_progress_get_child(progress),
-							 &error_backend)) {
+		if (!fu_engine_coldplug_backend(self,
+						backend,
+						fu_progress_get_child(progress),
+						&error_backend)) {
 			if (g_error_matches(error_backend,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_NOT_SUPPORTED)) {
@@ -8188,6 +8975,26 @@ fu_engine_backends_coldplug(FuEngine *self, FuProgress *progress)
 		}
 		fu_progress_step_done(progress);
 	}
+
+	/* how effective was the quirk cache */
+	quirk_hits = fu_quirks_get_cache_hits(quirks) - quirk_hits;
+	quirk_misses = fu_quirks_get_cache_misses(quirks) - quirk_misses;
+	if (quirk_hits + quirk_misses > 0) {
+		g_info("coldplug did %u quirk lookups, %u queried the silo, hit rate %.1f%%",
+		       quirk_hits + quirk_misses,
+		       quirk_misses,
+		       100.f * quirk_hits / (quirk_hits + quirk_misses));
+	}
+
+	/* how many instance IDs did not need hashing */
+	guid_hits = fu_common_guid_get_cache_hits() - guid_hits;
+	guid_misses = fu_common_guid_get_cache_misses() - guid_misses;
+	if (guid_hits + guid_misses > 0) {
+		g_info("coldplug converted %u instance IDs, %u were hashed, hit rate %.1f%%",
+		       guid_hits + guid_misses,
+		       guid_misses,
+		       100.f * guid_hits / (guid_hits + guid_misses));
+	}
 }
 
 /**
@@ -8283,6 +9090,8 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 		g_prefix_error(error, "Failed to load config: ");
 		return FALSE;
 	}
+	if (self->coldplug_threads == 0)
+		self->coldplug_threads = fu_config_get_coldplug_threads(self->config);
 	fu_progress_step_done(progress);
 
 	/* set the hardcoded ESP */
@@ -8859,8 +9668,8 @@ fu_engine_finalize(GObject *obj)
 
 	if (self->silo != NULL)
 		g_object_unref(self->silo);
-	if (self->query_component_by_guid != NULL)
-		g_object_unref(self->query_component_by_guid);
+	if (self->components_by_guid != NULL)
+		g_hash_table_unref(self->components_by_guid);
 	if (self->query_container_checksum1 != NULL)
 		g_object_unref(self->query_container_checksum1);
 	if (self->query_container_checksum2 != NULL)
@@ -53,6 +53,13 @@ void
 fu_engine_idle_reset(FuEngine *self);
 gboolean
 fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GError **error);
+void
+fu_engine_set_coldplug_threads(FuEngine *self, guint coldplug_threads);
+gboolean
+fu_engine_coldplug_backend(FuEngine *self,
+			   FuBackend *backend,
+			   FuProgress *progress,
+			   GError **error);
 const gchar *
 fu_engine_get_host_vendor(FuEngine *self);
 const gchar *
@@ -123,6 +130,11 @@ fu_engine_update_metadata_bytes(FuEngine *self,
 				GBytes *bytes_sig,
 				GError **error);
 gboolean
+fu_engine_touch_metadata(FuEngine *self,
+			 const gchar *remote_id,
+			 const gchar *checksum,
+			 GError **error);
+gboolean
 fu_engine_unlock(FuEngine *self, const gchar *device_id, GError **error);
 gboolean
 fu_engine_verify(FuEngine *self, const gchar *device_id, FuProgress *progress, GError **error);
@@ -225,6 +237,16 @@ fu_engine_get_details_for_bytes(FuEngine *self,
 gboolean
 fu_engine_check_trust(FuEngine *self, FuRelease *release, GError **error);
 gboolean
+fu_engine_get_system_jcat_timestamp(FuEngine *self,
+				    FwupdRemote *remote,
+				    gint64 *timestamp,
+				    GError **error);
+gboolean
+fu_engine_validate_result_timestamp(FuEngine *self,
+				    FwupdRemote *remote,
+				    JcatResult *jcat_result,
+				    GError **error);
+gboolean
 fu_engine_check_requirements(FuEngine *self,
 			     FuRelease *release,
 			     FwupdInstallFlags flags,
@@ -22,7 +22,7 @@
 #include "fu-mutex.h"
 #include "fu-security-attr-common.h"
 
-#define FU_HISTORY_CURRENT_SCHEMA_VERSION 8
+#define FU_HISTORY_CURRENT_SCHEMA_VERSION 10
 
 static void
 fu_history_finalize(GObject *object);
@@ -31,7 +31,7 @@ struct _FuHistory {
 	GObject parent_instance;
 #ifdef HAVE_SQLITE
 	sqlite3 *db;
-	GRWLock db_mutex;
+	GRecMutex db_mutex;
 #endif
 };
 
@@ -197,7 +197,18 @@ fu_history_create_database(FuHistory *self, GError **error)
 			  "CREATE TABLE IF NOT EXISTS hsi_history ("
 			  "timestamp TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
 			  "hsi_details TEXT DEFAULT NULL,"
-			  "hsi_score TEXT DEFAULT NULL);"
+			  "hsi_score TEXT DEFAULT NULL,"
+			  "hsi_attrs TEXT DEFAULT NULL);"
+			  "CREATE TABLE IF NOT EXISTS hsi_attrs ("
+			  "checksum TEXT PRIMARY KEY,"
+			  "json TEXT);"
+			  "CREATE INDEX IF NOT EXISTS history_device_id ON history(device_id);"
+			  "CREATE INDEX IF NOT EXISTS history_checksum ON history(checksum);"
+			  "CREATE INDEX IF NOT EXISTS approved_firmware_checksum "
+			  "ON approved_firmware(checksum);"
+			  "CREATE INDEX IF NOT EXISTS blocked_firmware_checksum "
+			  "ON blocked_firmware(checksum);"
+			  "CREATE INDEX IF NOT EXISTS hsi_history_timestamp ON hsi_history(timestamp);"
 			  "COMMIT;",
 			  NULL,
 			  NULL,
@@ -359,6 +370,55 @@ fu_history_migrate_database_v7(FuHistory *self, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_history_migrate_database_v8(FuHistory *self, GError **error)
+{
+	gint rc;
+	rc = sqlite3_exec(self->db,
+			  "CREATE INDEX IF NOT EXISTS history_device_id ON history(device_id);"
+			  "CREATE INDEX IF NOT EXISTS history_checksum ON history(checksum);"
+			  "CREATE INDEX IF NOT EXISTS approved_firmware_checksum "
+			  "ON approved_firmware(checksum);"
+			  "CREATE INDEX IF NOT EXISTS blocked_firmware_checksum "
+			  "ON blocked_firmware(checksum);"
+			  "CREATE INDEX IF NOT EXISTS hsi_history_timestamp ON hsi_history(timestamp);",
+			  NULL,
+			  NULL,
+			  NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to create index: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_history_migrate_database_v9(FuHistory *self, GError **error)
+{
+	gint rc;
+	rc = sqlite3_exec(self->db,
+			  "CREATE TABLE IF NOT EXISTS hsi_attrs ("
+			  "checksum TEXT PRIMARY KEY,"
+			  "json TEXT);"
+			  "ALTER TABLE hsi_history ADD COLUMN hsi_attrs TEXT DEFAULT NULL;",
+			  NULL,
+			  NULL,
+			  NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to alter database: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 /* returns 0 if database is not initialized */
 static guint
 fu_history_get_schema_version(FuHistory *self)
@@ -423,6 +483,14 @@ fu_history_create_or_migrate(FuHistory *self, guint schema_ver, GError **error)
 	case 7:
 		if (!fu_history_migrate_database_v7(self, error))
 			return FALSE;
+	/* fall through */
+	case 8:
+		if (!fu_history_migrate_database_v8(self, error))
+			return FALSE;
+	/* fall through */
+	case 9:
+		if (!fu_history_migrate_database_v9(self, error))
+			return FALSE;
 		break;
 	default:
 		/* this is probably okay, but return an error if we ever delete
@@ -445,6 +513,33 @@ fu_history_create_or_migrate(FuHistory *self, guint schema_ver, GError **error)
 	return fu_history_stmt_exec(self, stmt, NULL, error);
 }
 
+static gboolean
+fu_history_can_write_path(const gchar *path)
+{
+	g_autoptr(GFile) file = g_file_new_for_path(path);
+	g_autoptr(GFileInfo) info = NULL;
+
+	info = g_file_query_info(file,
+				 G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE,
+				 G_FILE_QUERY_INFO_NONE,
+				 NULL,
+				 NULL);
+	if (info == NULL)
+		return FALSE;
+	return g_file_info_get_attribute_boolean(info, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE);
+}
+
+static gboolean
+fu_history_can_write(const gchar *filename)
+{
+	g_autofree gchar *dirname = g_path_get_dirname(filename);
+	if (!fu_history_can_write_path(dirname))
+		return FALSE;
+	if (!g_file_test(filename, G_FILE_TEST_EXISTS))
+		return TRUE;
+	return fu_history_can_write_path(filename);
+}
+
 static gboolean
 fu_history_open(FuHistory *self, const gchar *filename, GError **error)
 {
@@ -463,6 +558,15 @@ fu_history_open(FuHistory *self, const gchar *filename, GError **error)
 
 	/* turn off the lookaside cache */
 	sqlite3_db_config(self->db, SQLITE_DBCONFIG_LOOKASIDE, NULL, 0, 0);
+
+	/* each commit is a single append, but the WAL and shared-memory files have to be created
+	 * next to the database -- and the mode is persistent, so never switch a database that
+	 * is only being read */
+	if (fu_history_can_write(filename)) {
+		rc = sqlite3_exec(self->db, "PRAGMA journal_mode=WAL;", NULL, NULL, NULL);
+		if (rc != SQLITE_OK)
+			g_debug("ignoring WAL failure: %s", sqlite3_errmsg(self->db));
+	}
 	return TRUE;
 }
 
@@ -474,7 +578,7 @@ fu_history_load(FuHistory *self, GError **error)
 	g_autofree gchar *dirname = NULL;
 	g_autofree gchar *filename = NULL;
 	g_autoptr(GFile) file = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	g_autoptr(GRecMutexLocker) locker = g_rec_mutex_locker_new(&self->db_mutex);
 
 	/* already done */
 	if (self->db != NULL)
@@ -565,6 +669,120 @@ fu_history_get_device_flags_filtered(FuDevice *device)
 }
 #endif
 
+#ifdef HAVE_SQLITE
+static gboolean
+fu_history_exec(FuHistory *self, const gchar *sql, GError **error)
+{
+	gint rc;
+	g_autoptr(GRecMutexLocker) locker = g_rec_mutex_locker_new(&self->db_mutex);
+
+	g_return_val_if_fail(locker != NULL, FALSE);
+	rc = sqlite3_exec(self->db, sql, NULL, NULL, NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "failed to execute %s: %s",
+			    sql,
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	return TRUE;
+}
+#endif
+
+/**
+ * fu_history_transaction_begin:
+ * @self: a #FuHistory
+ * @error: (nullable): optional return location for an error
+ *
+ * Starts a transaction so that multiple modifications are written to the database together.
+ * Transactions can be nested, and each must be ended with fu_history_transaction_commit() or
+ * fu_history_transaction_rollback().
+ *
+ * The database is locked until the transaction is ended, so other threads cannot read or
+ * write partial changes, and the caller should not do anything slow in the meantime.
+ *
+ * Returns: @TRUE if successful, @FALSE for failure
+ *
+ * Since: 1.8.14
+ **/
+gboolean
+fu_history_transaction_begin(FuHistory *self, GError **error)
+{
+#ifdef HAVE_SQLITE
+	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+
+	/* lazy load */
+	if (!fu_history_load(self, error))
+		return FALSE;
+
+	/* unlocked when the transaction is ended */
+	g_rec_mutex_lock(&self->db_mutex);
+	if (!fu_history_exec(self, "SAVEPOINT fwupd;", error)) {
+		g_rec_mutex_unlock(&self->db_mutex);
+		return FALSE;
+	}
+	return TRUE;
+#else
+	return TRUE;
+#endif
+}
+
+/**
+ * fu_history_transaction_rollback:
+ * @self: a #FuHistory
+ *
+ * Discards all the modifications since fu_history_transaction_begin().
+ *
+ * Since: 1.8.14
+ **/
+void
+fu_history_transaction_rollback(FuHistory *self)
+{
+#ifdef HAVE_SQLITE
+	g_autoptr(GError) error_local = NULL;
+
+	g_return_if_fail(FU_IS_HISTORY(self));
+	g_return_if_fail(self->db != NULL);
+	if (!fu_history_exec(self, "ROLLBACK TO fwupd; RELEASE fwupd;", &error_local))
+		g_warning("failed to rollback: %s", error_local->message);
+	g_rec_mutex_unlock(&self->db_mutex);
+#endif
+}
+
+/**
+ * fu_history_transaction_commit:
+ * @self: a #FuHistory
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes all the modifications since fu_history_transaction_begin() to the database.
+ * If this fails then the modifications are discarded.
+ *
+ * Returns: @TRUE if successful, @FALSE for failure
+ *
+ * Since: 1.8.14
+ **/
+gboolean
+fu_history_transaction_commit(FuHistory *self, GError **error)
+{
+#ifdef HAVE_SQLITE
+	gboolean ret;
+
+	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+	g_return_val_if_fail(self->db != NULL, FALSE);
+
+	ret = fu_history_exec(self, "RELEASE fwupd;", error);
+	if (!ret)
+		fu_history_transaction_rollback(self);
+	else
+		g_rec_mutex_unlock(&self->db_mutex);
+	return ret;
+#else
+	return TRUE;
+#endif
+}
+
 /**
  * fu_history_modify_device:
  * @self: a #FuHistory
@@ -583,7 +801,7 @@ fu_history_modify_device(FuHistory *self, FuDevice *device, GError **error)
 #ifdef HAVE_SQLITE
 	gint rc;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
@@ -593,7 +811,7 @@ fu_history_modify_device(FuHistory *self, FuDevice *device, GError **error)
 		return FALSE;
 
 	/* overwrite entry if it exists */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	g_debug("modifying device %s [%s]", fu_device_get_name(device), fu_device_get_id(device));
 	rc = sqlite3_prepare_v2(self->db,
@@ -666,7 +884,7 @@ fu_history_modify_device_release(FuHistory *self,
 	gint rc;
 	g_autofree gchar *metadata = NULL;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
@@ -679,7 +897,7 @@ fu_history_modify_device_release(FuHistory *self,
 	metadata = _convert_hash_to_string(fwupd_release_get_metadata(release));
 
 	/* overwrite entry if it exists */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	g_debug("modifying device %s [%s]", fu_device_get_name(device), fu_device_get_id(device));
 	rc = sqlite3_prepare_v2(self->db,
@@ -745,7 +963,6 @@ fu_history_add_device(FuHistory *self, FuDevice *device, FwupdRelease *release,
 	gint rc;
 	g_autofree gchar *metadata = NULL;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
@@ -756,8 +973,12 @@ fu_history_add_device(FuHistory *self, FuDevice *device, FwupdRelease *release,
 		return FALSE;
 
 	/* ensure all old device(s) with this ID are removed */
-	if (!fu_history_remove_device(self, device, error))
+	if (!fu_history_transaction_begin(self, error))
 		return FALSE;
+	if (!fu_history_remove_device(self, device, error)) {
+		fu_history_transaction_rollback(self);
+		return FALSE;
+	}
 	g_debug("add device %s [%s]", fu_device_get_name(device), fu_device_get_id(device));
 	if (release != NULL) {
 		GPtrArray *checksums = fwupd_release_get_checksums(release);
@@ -770,8 +991,6 @@ fu_history_add_device(FuHistory *self, FuDevice *device, FwupdRelease *release,
 	metadata = _convert_hash_to_string(fwupd_release_get_metadata(release));
 
 	/* add */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
-	g_return_val_if_fail(locker != NULL, FALSE);
 	rc = sqlite3_prepare_v2(self->db,
 				"INSERT INTO history (device_id,"
 				"update_state,"
@@ -800,6 +1019,7 @@ fu_history_add_device(FuHistory *self, FuDevice *device, FwupdRelease *release,
 			    FWUPD_ERROR_INTERNAL,
 			    "Failed to prepare SQL to insert history: %s",
 			    sqlite3_errmsg(self->db));
+		fu_history_transaction_rollback(self);
 		return FALSE;
 	}
 	sqlite3_bind_text(stmt, 1, fu_device_get_id(device), -1, SQLITE_STATIC);
@@ -818,7 +1038,11 @@ fu_history_add_device(FuHistory *self, FuDevice *device, FwupdRelease *release,
 	sqlite3_bind_text(stmt, 14, fwupd_release_get_version(release), -1, SQLITE_STATIC);
 	sqlite3_bind_text(stmt, 15, checksum_device, -1, SQLITE_STATIC);
 	sqlite3_bind_text(stmt, 16, fwupd_release_get_protocol(release), -1, SQLITE_STATIC);
-	return fu_history_stmt_exec(self, stmt, NULL, error);
+	if (!fu_history_stmt_exec(self, stmt, NULL, error)) {
+		fu_history_transaction_rollback(self);
+		return FALSE;
+	}
+	return fu_history_transaction_commit(self, error);
 #else
 	return TRUE;
 #endif
@@ -841,7 +1065,7 @@ fu_history_remove_all(FuHistory *self, GError **error)
 #ifdef HAVE_SQLITE
 	gint rc;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 
@@ -850,7 +1074,7 @@ fu_history_remove_all(FuHistory *self, GError **error)
 		return FALSE;
 
 	/* remove entries */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	g_debug("removing all devices");
 	rc = sqlite3_prepare_v2(self->db, "DELETE FROM history;", -1, &stmt, NULL);
@@ -887,7 +1111,7 @@ fu_history_remove_device(FuHistory *self, FuDevice *device, GError **error)
 #ifdef HAVE_SQLITE
 	gint rc;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
@@ -896,7 +1120,7 @@ fu_history_remove_device(FuHistory *self, FuDevice *device, GError **error)
 	if (!fu_history_load(self, error))
 		return FALSE;
 
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	g_debug("remove device %s [%s]", fu_device_get_name(device), fu_device_get_id(device));
 	rc = sqlite3_prepare_v2(self->db,
@@ -938,7 +1162,7 @@ fu_history_get_device_by_id(FuHistory *self, const gchar *device_id, GError **er
 	gint rc;
 	g_autoptr(GPtrArray) array_tmp = NULL;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockReaderLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
 	g_return_val_if_fail(device_id != NULL, NULL);
@@ -948,7 +1172,7 @@ fu_history_get_device_by_id(FuHistory *self, const gchar *device_id, GError **er
 		return NULL;
 
 	/* get all the devices */
-	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
 	rc = sqlite3_prepare_v2(self->db,
 				"SELECT device_id, "
@@ -1013,7 +1237,7 @@ fu_history_get_devices(FuHistory *self, GError **error)
 #ifdef HAVE_SQLITE
 	g_autoptr(sqlite3_stmt) stmt = NULL;
 	gint rc;
-	g_autoptr(GRWLockReaderLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
 
@@ -1024,7 +1248,7 @@ fu_history_get_devices(FuHistory *self, GError **error)
 	}
 
 	/* get all the devices */
-	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
 	rc = sqlite3_prepare_v2(self->db,
 				"SELECT device_id, "
@@ -1079,7 +1303,7 @@ fu_history_get_approved_firmware(FuHistory *self, GError **error)
 	g_autoptr(GPtrArray) array = g_ptr_array_new_with_free_func(g_free);
 #ifdef HAVE_SQLITE
 	gint rc;
-	g_autoptr(GRWLockReaderLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
@@ -1091,7 +1315,7 @@ fu_history_get_approved_firmware(FuHistory *self, GError **error)
 	}
 
 	/* get all the approved firmware */
-	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
 	rc = sqlite3_prepare_v2(self->db,
 				"SELECT checksum FROM approved_firmware;",
@@ -1139,7 +1363,7 @@ fu_history_clear_approved_firmware(FuHistory *self, GError **error)
 #ifdef HAVE_SQLITE
 	gint rc;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 
@@ -1148,7 +1372,7 @@ fu_history_clear_approved_firmware(FuHistory *self, GError **error)
 		return FALSE;
 
 	/* remove entries */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	rc = sqlite3_prepare_v2(self->db, "DELETE FROM approved_firmware;", -1, &stmt, NULL);
 	if (rc != SQLITE_OK) {
@@ -1184,7 +1408,7 @@ fu_history_add_approved_firmware(FuHistory *self, const gchar *checksum, GError
 #ifdef HAVE_SQLITE
 	gint rc;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(checksum != NULL, FALSE);
@@ -1194,7 +1418,7 @@ fu_history_add_approved_firmware(FuHistory *self, const gchar *checksum, GError
 		return FALSE;
 
 	/* add */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	rc = sqlite3_prepare_v2(self->db,
 				"INSERT INTO approved_firmware (checksum) "
@@ -1235,7 +1459,7 @@ fu_history_get_blocked_firmware(FuHistory *self, GError **error)
 	g_autoptr(GPtrArray) array = g_ptr_array_new_with_free_func(g_free);
 #ifdef HAVE_SQLITE
 	gint rc;
-	g_autoptr(GRWLockReaderLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
@@ -1247,7 +1471,7 @@ fu_history_get_blocked_firmware(FuHistory *self, GError **error)
 	}
 
 	/* get all the blocked firmware */
-	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
 	rc =
 	    sqlite3_prepare_v2(self->db, "SELECT checksum FROM blocked_firmware;", -1, &stmt, NULL);
@@ -1292,7 +1516,7 @@ fu_history_clear_blocked_firmware(FuHistory *self, GError **error)
 #ifdef HAVE_SQLITE
 	gint rc;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 
@@ -1301,7 +1525,7 @@ fu_history_clear_blocked_firmware(FuHistory *self, GError **error)
 		return FALSE;
 
 	/* remove entries */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	rc = sqlite3_prepare_v2(self->db, "DELETE FROM blocked_firmware;", -1, &stmt, NULL);
 	if (rc != SQLITE_OK) {
@@ -1337,7 +1561,7 @@ fu_history_add_blocked_firmware(FuHistory *self, const gchar *checksum, GError *
 #ifdef HAVE_SQLITE
 	gint rc;
 	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(checksum != NULL, FALSE);
@@ -1347,7 +1571,7 @@ fu_history_add_blocked_firmware(FuHistory *self, const gchar *checksum, GError *
 		return FALSE;
 
 	/* add */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	rc = sqlite3_prepare_v2(self->db,
 				"INSERT INTO blocked_firmware (checksum) "
@@ -1371,26 +1595,83 @@ fu_history_add_blocked_firmware(FuHistory *self, const gchar *checksum, GError *
 #endif
 }
 
-gboolean
-fu_history_add_security_attribute(FuHistory *self,
-				  const gchar *security_attr_json,
-				  const gchar *hsi_score,
-				  GError **error)
-{
 #ifdef HAVE_SQLITE
+static gchar *
+fu_history_security_attr_to_json_string(FwupdSecurityAttr *attr)
+{
+	g_autoptr(FwupdSecurityAttr) attr_tmp = fwupd_security_attr_copy(attr);
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	g_autoptr(JsonGenerator) json_generator = json_generator_new();
+	g_autoptr(JsonNode) json_root = NULL;
+
+	/* the timestamp belongs to the snapshot, not the attribute */
+	json_builder_begin_object(builder);
+	fwupd_security_attr_set_created(attr_tmp, 0);
+	fwupd_security_attr_to_json(attr_tmp, builder);
+	json_builder_end_object(builder);
+	json_root = json_builder_get_root(builder);
+	json_generator_set_root(json_generator, json_root);
+	return json_generator_to_data(json_generator, NULL);
+}
+
+static gboolean
+fu_history_add_security_attribute_internal(FuHistory *self,
+					   FuSecurityAttrs *attrs,
+					   const gchar *hsi_score,
+					   GError **error)
+{
 	gint rc;
+	g_autofree gchar *hsi_attrs = NULL;
+	g_autoptr(GPtrArray) items = fu_security_attrs_get_all(attrs);
+	g_autoptr(GPtrArray) checksums = g_ptr_array_new_with_free_func(g_free);
 	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
-	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+	g_autoptr(sqlite3_stmt) stmt_attr = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
-	/* lazy load */
-	if (!fu_history_load(self, error))
-		return FALSE;
-	/* remove entries */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
+
+	/* each unique attribute is only stored once */
+	rc = sqlite3_prepare_v2(self->db,
+				"INSERT OR IGNORE INTO hsi_attrs (checksum, json) VALUES (?1, ?2);",
+				-1,
+				&stmt_attr,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to write security attribute: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	for (guint i = 0; i < items->len; i++) {
+		FwupdSecurityAttr *attr = g_ptr_array_index(items, i);
+		g_autofree gchar *json = fu_history_security_attr_to_json_string(attr);
+		g_autofree gchar *checksum = NULL;
+
+		if (json == NULL) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "failed to convert %s to JSON",
+				    fwupd_security_attr_get_appstream_id(attr));
+			return FALSE;
+		}
+		checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA1, json, -1);
+		sqlite3_reset(stmt_attr);
+		sqlite3_bind_text(stmt_attr, 1, checksum, -1, SQLITE_STATIC);
+		sqlite3_bind_text(stmt_attr, 2, json, -1, SQLITE_STATIC);
+		if (!fu_history_stmt_exec(self, stmt_attr, NULL, error))
+			return FALSE;
+		g_ptr_array_add(checksums, g_steal_pointer(&checksum));
+	}
+
+	/* the snapshot only refers to the attributes */
+	g_ptr_array_add(checksums, NULL);
+	hsi_attrs = g_strjoinv(",", (gchar **)checksums->pdata);
 	rc = sqlite3_prepare_v2(self->db,
-				"INSERT INTO hsi_history (hsi_details, hsi_score)"
+				"INSERT INTO hsi_history (hsi_attrs, hsi_score)"
 				"VALUES (?1, ?2)",
 				-1,
 				&stmt,
@@ -1403,15 +1684,103 @@ fu_history_add_security_attribute(FuHistory *self,
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
-	sqlite3_bind_text(stmt, 1, security_attr_json, -1, SQLITE_STATIC);
+	sqlite3_bind_text(stmt, 1, hsi_attrs, -1, SQLITE_STATIC);
 	sqlite3_bind_text(stmt, 2, hsi_score, -1, SQLITE_STATIC);
 	return fu_history_stmt_exec(self, stmt, NULL, error);
+}
+#endif
+
+/**
+ * fu_history_add_security_attribute:
+ * @self: a #FuHistory
+ * @attrs: a #FuSecurityAttrs
+ * @hsi_score: the HSI score, e.g. `HSI:1`
+ * @error: (nullable): optional return location for an error
+ *
+ * Adds a snapshot of the security attributes to the history database.
+ * Each unique attribute is only stored once and the snapshot refers to it by checksum.
+ *
+ * Returns: @TRUE if successful, @FALSE for failure
+ *
+ * Since: 1.7.1
+ **/
+gboolean
+fu_history_add_security_attribute(FuHistory *self,
+				  FuSecurityAttrs *attrs,
+				  const gchar *hsi_score,
+				  GError **error)
+{
+#ifdef HAVE_SQLITE
+	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+	g_return_val_if_fail(FU_IS_SECURITY_ATTRS(attrs), FALSE);
+
+	/* lazy load */
+	if (!fu_history_load(self, error))
+		return FALSE;
+
+	/* write the attributes and the snapshot together */
+	if (!fu_history_transaction_begin(self, error))
+		return FALSE;
+	if (!fu_history_add_security_attribute_internal(self, attrs, hsi_score, error)) {
+		fu_history_transaction_rollback(self);
+		return FALSE;
+	}
+	return fu_history_transaction_commit(self, error);
 #else
 	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no sqlite support");
 	return FALSE;
 #endif
 }
 
+#ifdef HAVE_SQLITE
+static FwupdSecurityAttr *
+fu_history_get_security_attr_by_checksum(FuHistory *self,
+					 sqlite3_stmt *stmt,
+					 GHashTable *cache,
+					 const gchar *checksum,
+					 GError **error)
+{
+	FwupdSecurityAttr *attr_tmp;
+	const gchar *json;
+	gint rc;
+	g_autoptr(FwupdSecurityAttr) attr = NULL;
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	/* already parsed for an older snapshot */
+	attr_tmp = g_hash_table_lookup(cache, checksum);
+	if (attr_tmp != NULL)
+		return fwupd_security_attr_copy(attr_tmp);
+
+	sqlite3_reset(stmt);
+	sqlite3_bind_text(stmt, 1, checksum, -1, SQLITE_STATIC);
+	rc = sqlite3_step(stmt);
+	if (rc != SQLITE_ROW) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_FOUND,
+			    "no security attribute with checksum %s",
+			    checksum);
+		return NULL;
+	}
+	json = (const gchar *)sqlite3_column_text(stmt, 0);
+	if (json == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "no JSON for security attribute %s",
+			    checksum);
+		return NULL;
+	}
+	if (!json_parser_load_from_data(parser, json, -1, error))
+		return NULL;
+	attr = fwupd_security_attr_new(NULL);
+	if (!fwupd_security_attr_from_json(attr, json_parser_get_root(parser), error))
+		return NULL;
+	g_hash_table_insert(cache, g_strdup(checksum), g_object_ref(attr));
+	return fwupd_security_attr_copy(attr);
+}
+#endif
+
 /**
  * fu_history_get_security_attrs:
  * @self: a #FuHistory
@@ -1419,7 +1788,7 @@ fu_history_add_security_attribute(FuHistory *self,
  * @error: (nullable): optional return location for an error
  *
  * Gets the security attributes in the history database.
- * Attributes with the same stores JSON data will be deduplicated as required.
+ * Snapshots with the same stored attributes will be deduplicated as required.
  *
  * Returns: (element-type #FuSecurityAttrs) (transfer container): attrs
  *
@@ -1431,9 +1800,11 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 	g_autoptr(GPtrArray) array = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 #ifdef HAVE_SQLITE
 	g_autoptr(sqlite3_stmt) stmt = NULL;
+	g_autoptr(sqlite3_stmt) stmt_attr = NULL;
 	gint rc;
 	guint old_hash = 0;
-	g_autoptr(GRWLockReaderLocker) locker = NULL;
+	g_autoptr(GHashTable) cache = NULL;
+	g_autoptr(GRecMutexLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
 
@@ -1444,11 +1815,11 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 	}
 
 	/* get all the devices */
-	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	locker = g_rec_mutex_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
 	rc = sqlite3_prepare_v2(self->db,
-				"SELECT timestamp, hsi_details FROM hsi_history "
-				"ORDER BY timestamp DESC;",
+				"SELECT timestamp, hsi_details, hsi_attrs FROM hsi_history "
+				"ORDER BY timestamp DESC, rowid DESC;",
 				-1,
 				&stmt,
 				NULL);
@@ -1460,12 +1831,28 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 			    sqlite3_errmsg(self->db));
 		return NULL;
 	}
+	rc = sqlite3_prepare_v2(self->db,
+				"SELECT json FROM hsi_attrs WHERE checksum = ?1;",
+				-1,
+				&stmt_attr,
+				NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL to get security attr: %s",
+			    sqlite3_errmsg(self->db));
+		return NULL;
+	}
+
+	/* checksum -> FwupdSecurityAttr, so each attribute is only parsed once */
+	cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
 	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
 		const gchar *json;
+		const gchar *hsi_attrs;
 		guint hash;
 		const gchar *timestamp;
 		g_autoptr(FuSecurityAttrs) attrs = fu_security_attrs_new();
-		g_autoptr(JsonParser) parser = NULL;
 		g_autoptr(GDateTime) created_dt = NULL;
 		g_autoptr(GTimeZone) tz_utc = g_time_zone_new_utc();
 
@@ -1474,26 +1861,45 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 		if (timestamp == NULL)
 			continue;
 
-		/* device_id */
+		/* either the full JSON, or references to the attributes */
 		json = (const gchar *)sqlite3_column_text(stmt, 1);
-		if (json == NULL)
+		hsi_attrs = (const gchar *)sqlite3_column_text(stmt, 2);
+		if (json == NULL && hsi_attrs == NULL)
 			continue;
 
 		/* do not create dups */
-		hash = g_str_hash(json);
+		hash = g_str_hash(hsi_attrs != NULL ? hsi_attrs : json);
 		if (hash == old_hash) {
 			g_debug("skipping %s as unchanged", timestamp);
 			continue;
 		}
 		old_hash = hash;
 
-		/* parse JSON */
-		parser = json_parser_new();
 		g_debug("parsing %s", timestamp);
-		if (!json_parser_load_from_data(parser, json, -1, error))
-			return NULL;
-		if (!fu_security_attrs_from_json(attrs, json_parser_get_root(parser), error))
-			return NULL;
+		if (hsi_attrs != NULL) {
+			g_auto(GStrv) checksums = g_strsplit(hsi_attrs, ",", -1);
+			for (guint i = 0; checksums[i] != NULL; i++) {
+				g_autoptr(FwupdSecurityAttr) attr = NULL;
+				if (checksums[i][0] == '\0')
+					continue;
+				attr = fu_history_get_security_attr_by_checksum(self,
+										stmt_attr,
+										cache,
+										checksums[i],
+										error);
+				if (attr == NULL)
+					return NULL;
+				fu_security_attrs_append_internal(attrs, attr);
+			}
+		} else {
+			g_autoptr(JsonParser) parser = json_parser_new();
+			if (!json_parser_load_from_data(parser, json, -1, error))
+				return NULL;
+			if (!fu_security_attrs_from_json(attrs,
+							 json_parser_get_root(parser),
+							 error))
+				return NULL;
+		}
 
 		/* parse timestamp */
 		created_dt = g_date_time_new_from_iso8601(timestamp, tz_utc);
@@ -1536,7 +1942,7 @@ static void
 fu_history_init(FuHistory *self)
 {
 #ifdef HAVE_SQLITE
-	g_rw_lock_init(&self->db_mutex);
+	g_rec_mutex_init(&self->db_mutex);
 #endif
 }
 
@@ -1546,7 +1952,7 @@ fu_history_finalize(GObject *object)
 #ifdef HAVE_SQLITE
 	FuHistory *self = FU_HISTORY(object);
 
-	g_rw_lock_clear(&self->db_mutex);
+	g_rec_mutex_clear(&self->db_mutex);
 
 	if (self->db != NULL)
 		sqlite3_close(self->db);
@@ -14,6 +14,13 @@ G_DECLARE_FINAL_TYPE(FuHistory, fu_history, FU, HISTORY, GObject)
 FuHistory *
 fu_history_new(void);
 
+gboolean
+fu_history_transaction_begin(FuHistory *self, GError **error);
+gboolean
+fu_history_transaction_commit(FuHistory *self, GError **error);
+void
+fu_history_transaction_rollback(FuHistory *self);
+
 gboolean
 fu_history_add_device(FuHistory *self, FuDevice *device, FwupdRelease *release, GError **error);
 gboolean
@@ -46,7 +53,7 @@ GPtrArray *
 fu_history_get_blocked_firmware(FuHistory *self, GError **error);
 gboolean
 fu_history_add_security_attribute(FuHistory *self,
-				  const gchar *security_attr_json,
+				  FuSecurityAttrs *attrs,
 				  const gchar *hsi_score,
 				  GError **error);
 GPtrArray *
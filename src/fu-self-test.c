@@ -10,6 +10,9 @@
 
 #include <glib/gstdio.h>
 #include <libgcab.h>
+#ifdef HAVE_SQLITE
+#include <sqlite3.h>
+#endif
 #include <stdlib.h>
 #include <string.h>
 
@@ -24,6 +27,7 @@
 #include "fu-config.h"
 #include "fu-console.h"
 #include "fu-context-private.h"
+#include "fu-device-changed-queue.h"
 #include "fu-device-list.h"
 #include "fu-device-private.h"
 #include "fu-engine.h"
@@ -168,6 +172,230 @@ fu_engine_generate_md_func(gconstpointer user_data)
 	g_assert_cmpstr(tmp, ==, NULL);
 }
 
+static gdouble
+fu_engine_metadata_cache_load(FuTest *self, FuEngineLoadFlags flags)
+{
+	gboolean ret;
+	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+	g_autoptr(XbNode) component = NULL;
+
+	/* use the persistent per-remote silos */
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_REMOTES | flags, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_device_add_guid(device, "12345678-1234-1234-1234-123456789012");
+	fu_device_set_version_format(device, FWUPD_VERSION_FORMAT_TRIPLET);
+	fu_device_set_version(device, "1.2.3");
+	component = fu_engine_get_component_by_guids(engine, device);
+	g_assert_nonnull(component);
+	g_assert_cmpstr(xb_node_query_text(component,
+					   "../custom/value[@key='fwupd::RemoteId']",
+					   NULL),
+			==,
+			"directory");
+	return g_timer_elapsed(timer, NULL) * 1000.f;
+}
+
+static guint64
+fu_engine_metadata_cache_get_mtime(const gchar *filename)
+{
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) file = g_file_new_for_path(filename);
+	g_autoptr(GFileInfo) info = NULL;
+
+	info = g_file_query_info(file,
+				 G_FILE_ATTRIBUTE_TIME_MODIFIED,
+				 G_FILE_QUERY_INFO_NONE,
+				 NULL,
+				 &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(info);
+	return g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+}
+
+/* a rewritten file cannot have this mtime */
+static void
+fu_engine_metadata_cache_reset_mtime(const gchar *filename)
+{
+	gboolean ret;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) file = g_file_new_for_path(filename);
+
+	ret = g_file_set_attribute_uint64(file,
+					  G_FILE_ATTRIBUTE_TIME_MODIFIED,
+					  1,
+					  G_FILE_QUERY_INFO_NONE,
+					  NULL,
+					  &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
+static void
+fu_engine_metadata_cache_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	const gchar *xmlb_directory = "/tmp/fwupd-self-test/var/cache/fwupd/metadata/directory.xmlb";
+	const gchar *xmlb_stable = "/tmp/fwupd-self-test/var/cache/fwupd/metadata/stable.xmlb";
+	const gchar *xmlb_combined = "/tmp/fwupd-self-test/var/cache/fwupd/metadata.xmlb";
+	g_autofree gchar *filename = NULL;
+	g_autoptr(GBytes) data = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* start with no cached silos */
+	if (g_file_test("/tmp/fwupd-self-test/var/cache/fwupd/metadata", G_FILE_TEST_EXISTS)) {
+		ret = fu_path_rmtree("/tmp/fwupd-self-test/var/cache/fwupd/metadata", &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+	filename =
+	    g_test_build_filename(G_TEST_DIST, "tests", "colorhug", "colorhug-als-3.0.2.cab", NULL);
+	data = fu_bytes_get_contents(filename, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(data);
+	ret = fu_bytes_set_contents("/tmp/fwupd-self-test/var/cache/fwupd/foo.cab", data, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* a second remote which does not change */
+	ret = g_file_set_contents(
+	    "/tmp/fwupd-self-test/stable.xml",
+	    "<components>"
+	    "  <component type=\"firmware\">"
+	    "    <id>test</id>"
+	    "    <provides>"
+	    "      <firmware type=\"flashed\">aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee</firmware>"
+	    "    </provides>"
+	    "    <releases>"
+	    "      <release version=\"1.2.3\"/>"
+	    "    </releases>"
+	    "  </component>"
+	    "</components>",
+	    -1,
+	    &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* compile everything, then just load the existing silos */
+	g_print("cold=%.3fms ", fu_engine_metadata_cache_load(self, FU_ENGINE_LOAD_FLAG_NONE));
+	g_print("warm=%.3fms ", fu_engine_metadata_cache_load(self, FU_ENGINE_LOAD_FLAG_NONE));
+	g_assert_true(g_file_test(xmlb_stable, G_FILE_TEST_EXISTS));
+	g_assert_true(g_file_test(xmlb_directory, G_FILE_TEST_EXISTS));
+	fu_engine_metadata_cache_reset_mtime(xmlb_stable);
+	fu_engine_metadata_cache_reset_mtime(xmlb_directory);
+	fu_engine_metadata_cache_reset_mtime(xmlb_combined);
+
+	/* nothing is written when read-only, even though the remote has changed */
+	ret = fu_bytes_set_contents("/tmp/fwupd-self-test/var/cache/fwupd/bar.cab", data, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_print("readonly=%.3fms ",
+		fu_engine_metadata_cache_load(self, FU_ENGINE_LOAD_FLAG_READONLY));
+	g_assert_cmpint(fu_engine_metadata_cache_get_mtime(xmlb_stable), ==, 1);
+	g_assert_cmpint(fu_engine_metadata_cache_get_mtime(xmlb_directory), ==, 1);
+	g_assert_cmpint(fu_engine_metadata_cache_get_mtime(xmlb_combined), ==, 1);
+
+	/* only the changed remote is recompiled */
+	g_print("refresh=%.3fms ", fu_engine_metadata_cache_load(self, FU_ENGINE_LOAD_FLAG_NONE));
+	g_assert_cmpint(fu_engine_metadata_cache_get_mtime(xmlb_stable), ==, 1);
+	g_assert_cmpint(fu_engine_metadata_cache_get_mtime(xmlb_directory), !=, 1);
+	g_assert_cmpint(fu_engine_metadata_cache_get_mtime(xmlb_combined), !=, 1);
+
+	/* the per-remote silos are not exported as XML */
+	g_assert_false(g_file_test("/tmp/fwupd-self-test/var/cache/fwupd/metadata/directory",
+				   G_FILE_TEST_EXISTS));
+
+	/* restore the previous state */
+	g_assert_cmpint(g_unlink("/tmp/fwupd-self-test/var/cache/fwupd/bar.cab"), ==, 0);
+}
+
+static JcatResult *
+fu_engine_metadata_timestamp_result_new(gint64 timestamp)
+{
+	return g_object_new(JCAT_TYPE_RESULT, "timestamp", timestamp, NULL);
+}
+
+static void
+fu_engine_metadata_timestamp_func(gconstpointer user_data)
+{
+	gboolean ret;
+	gint64 timestamp = 0;
+	const gchar *fn = "/tmp/fwupd-self-test/jcat-timestamp/metadata.xml";
+	const gchar *fn_sig = "/tmp/fwupd-self-test/jcat-timestamp/metadata.xml.jcat";
+	const gchar *fn_verified = "/tmp/fwupd-self-test/jcat-timestamp/metadata.xml.jcat.verified";
+	g_autofree gchar *checksum = NULL;
+	g_autofree gchar *verified = NULL;
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FwupdRemote) remote = fwupd_remote_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(JcatResult) result_new = fu_engine_metadata_timestamp_result_new(3000);
+	g_autoptr(JcatResult) result_old = fu_engine_metadata_timestamp_result_new(1000);
+
+	/* the signature is not valid, so is only accepted when already verified */
+	fwupd_remote_set_keyring_kind(remote, FWUPD_KEYRING_KIND_JCAT);
+	fwupd_remote_set_filename_cache(remote, fn);
+	g_assert_cmpstr(fwupd_remote_get_filename_cache_sig(remote), ==, fn_sig);
+	ret = fu_path_mkdir_parent(fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(fn, "<components/>", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(fn_sig, "not a jcat file", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	(void)g_unlink(fn_verified);
+
+	/* no sidecar, so the old metadata is verified again */
+	ret = fu_engine_get_system_jcat_timestamp(engine, remote, &timestamp, &error);
+	g_assert_nonnull(error);
+	g_assert_false(g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT));
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	/* the sidecar is used if it matches the signature */
+	checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA256, "not a jcat file", -1);
+	verified = g_strdup_printf("[fwupd Signature]\nChecksum=%s\nTimestamp=2000\n", checksum);
+	ret = g_file_set_contents(fn_verified, verified, -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_engine_get_system_jcat_timestamp(engine, remote, &timestamp, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(timestamp, ==, 2000);
+
+	/* metadata signed before the existing metadata is still a rollback */
+	ret = fu_engine_validate_result_timestamp(engine, remote, result_old, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
+	g_assert_false(ret);
+	g_clear_error(&error);
+	ret = fu_engine_validate_result_timestamp(engine, remote, result_new, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the sidecar is stale when the signature changes */
+	ret = g_file_set_contents(fn_sig, "still not a jcat file", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_engine_get_system_jcat_timestamp(engine, remote, &timestamp, &error);
+	g_assert_nonnull(error);
+	g_assert_false(g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT));
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	/* the sidecar is deleted with the cached metadata */
+	g_assert_cmpint(g_unlink(fn), ==, 0);
+	ret = fu_engine_get_system_jcat_timestamp(engine, remote, &timestamp, &error);
+	g_assert_error(error, G_FILE_ERROR, G_FILE_ERROR_NOENT);
+	g_assert_false(ret);
+	g_assert_false(g_file_test(fn_verified, G_FILE_TEST_EXISTS));
+}
+
 static void
 fu_engine_requirements_missing_func(gconstpointer user_data)
 {
@@ -1823,6 +2051,111 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	g_assert_cmpstr(fwupd_release_get_version(rel), ==, "1.2.2");
 }
 
+static void
+fu_engine_get_upgrades_performance_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	const guint n_components = 3000;
+	const guint n_devices = 100;
+	gboolean ret;
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FuEngineRequest) request = fu_engine_request_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) devices = g_ptr_array_new_with_free_func(g_object_unref);
+	g_autoptr(GString) xml = g_string_new("<components>");
+	g_autoptr(GTimer) timer = NULL;
+	g_autoptr(XbSilo) silo_empty = xb_silo_new();
+
+	/* ensure empty tree */
+	fu_self_test_mkroot();
+	fu_engine_set_silo(engine, silo_empty);
+
+	/* a metadata set with roughly as many components as the LVFS */
+	for (guint i = 0; i < n_components; i++) {
+		g_string_append_printf(
+		    xml,
+		    "<component type=\"firmware\">"
+		    "<id>com.acme.Device%04u.firmware</id>"
+		    "<name>Device %04u</name>"
+		    "<provides>"
+		    "<firmware type=\"flashed\">%08x-bbbb-cccc-dddd-eeeeeeeeeeee</firmware>"
+		    "<firmware type=\"flashed\">%08x-bbbb-cccc-dddd-ffffffffffff</firmware>"
+		    "</provides>"
+		    "<releases>",
+		    i,
+		    i,
+		    i,
+		    i);
+		for (guint j = 0; j < 3; j++) {
+			g_string_append_printf(
+			    xml,
+			    "<release version=\"1.2.%u\" date=\"2017-09-%02u\">"
+			    "<size type=\"installed\">123</size>"
+			    "<size type=\"download\">456</size>"
+			    "<location>https://test.org/foo.cab</location>"
+			    "<checksum filename=\"foo.cab\" target=\"container\" "
+			    "type=\"md5\">deadbeefdeadbeefdeadbeefdeadbeef</checksum>"
+			    "</release>",
+			    6 - j,
+			    15 - j);
+		}
+		g_string_append(xml, "</releases></component>");
+	}
+	g_string_append(xml, "</components>");
+	ret = g_file_set_contents("/tmp/fwupd-self-test/stable.xml", xml->str, -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	timer = g_timer_new();
+	ret = fu_engine_load(engine,
+			     FU_ENGINE_LOAD_FLAG_REMOTES | FU_ENGINE_LOAD_FLAG_NO_CACHE,
+			     progress,
+			     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_print("load=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	fu_engine_add_approved_firmware(engine, "deadbeefdeadbeefdeadbeefdeadbeef");
+
+	/* devices have lots of instance IDs, but only one GUID is in the metadata */
+	for (guint i = 0; i < n_devices; i++) {
+		g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+		g_autofree gchar *id = g_strdup_printf("device%04u", i);
+		g_autofree gchar *guid =
+		    g_strdup_printf("%08x-bbbb-cccc-dddd-eeeeeeeeeeee", i * (n_components / n_devices));
+		fu_device_set_version_format(device, FWUPD_VERSION_FORMAT_TRIPLET);
+		fu_device_set_version(device, "1.2.3");
+		fu_device_set_id(device, id);
+		fu_device_add_vendor_id(device, "USB:FFFF");
+		fu_device_add_protocol(device, "com.acme");
+		fu_device_set_name(device, "Test Device");
+		for (guint j = 0; j < 30; j++) {
+			g_autofree gchar *instance_id =
+			    g_strdup_printf("USB\\VID_FFFF&PID_%04X&REV_%04X", i, j);
+			fu_device_add_instance_id(device, instance_id);
+		}
+		fu_device_convert_instance_ids(device);
+		fu_device_add_guid(device, guid);
+		fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE);
+		fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UNSIGNED_PAYLOAD);
+		fu_engine_add_device(engine, device);
+		g_ptr_array_add(devices, g_steal_pointer(&device));
+	}
+
+	/* get the upgrades for every device */
+	g_timer_reset(timer);
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		g_autoptr(GPtrArray) releases_up = NULL;
+		releases_up =
+		    fu_engine_get_upgrades(engine, request, fu_device_get_id(device), &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(releases_up);
+		g_assert_cmpint(releases_up->len, ==, 3);
+	}
+	g_print("upgrades=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+}
+
 static void
 fu_engine_md_verfmt_func(gconstpointer user_data)
 {
@@ -2700,6 +3033,59 @@ fu_device_list_no_auto_remove_children_func(gconstpointer user_data)
 	g_assert_cmpint(active3->len, ==, 0);
 }
 
+static void
+_device_changed_queue_count_cb(FuDeviceChangedQueue *queue, FuDevice *device, gpointer user_data)
+{
+	guint *cnt = (guint *)user_data;
+	(*cnt)++;
+}
+
+static void
+fu_device_changed_queue_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	guint changed_cnt = 0;
+	g_autoptr(FuDevice) device1 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device2 = fu_device_new(self->ctx);
+	g_autoptr(FuDeviceChangedQueue) queue = fu_device_changed_queue_new(10);
+
+	g_signal_connect(FU_DEVICE_CHANGED_QUEUE(queue),
+			 "device-changed",
+			 G_CALLBACK(_device_changed_queue_count_cb),
+			 &changed_cnt);
+	fu_device_set_id(device1, "device1");
+	fu_device_set_id(device2, "device2");
+
+	/* repeated changes are merged, and emitted when the main loop runs */
+	fu_device_changed_queue_add(queue, device1);
+	fu_device_changed_queue_add(queue, device1);
+	fu_device_changed_queue_add(queue, device2);
+	fu_device_changed_queue_add(queue, device1);
+	g_assert_cmpint(changed_cnt, ==, 0);
+	fu_test_loop_run_with_timeout(100);
+	fu_test_loop_quit();
+	g_assert_cmpint(changed_cnt, ==, 2);
+	g_assert_cmpint(fu_device_changed_queue_get_emitted(queue), ==, 2);
+	g_assert_cmpint(fu_device_changed_queue_get_suppressed(queue), ==, 2);
+
+	/* flushed before a method returns */
+	fu_device_changed_queue_add(queue, device1);
+	fu_device_changed_queue_flush(queue);
+	g_assert_cmpint(changed_cnt, ==, 3);
+
+	/* during an update the main loop is blocked, so pending changes and every new change
+	 * have to be emitted straight away */
+	fu_device_changed_queue_add(queue, device2);
+	fu_device_changed_queue_set_immediate(queue, TRUE);
+	g_assert_cmpint(changed_cnt, ==, 4);
+	fu_device_changed_queue_add(queue, device1);
+	fu_device_changed_queue_add(queue, device1);
+	g_assert_cmpint(changed_cnt, ==, 6);
+	fu_device_changed_queue_set_immediate(queue, FALSE);
+	g_assert_cmpint(fu_device_changed_queue_get_emitted(queue), ==, 6);
+	g_assert_cmpint(fu_device_changed_queue_get_suppressed(queue), ==, 2);
+}
+
 static void
 fu_device_list_delay_func(gconstpointer user_data)
 {
@@ -3054,6 +3440,117 @@ fu_device_list_remove_chain_func(gconstpointer user_data)
 	g_assert_cmpint(changed_cnt, ==, 0);
 }
 
+static void
+fu_device_list_performance_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	const guint n_devices = 2000;
+	g_autoptr(FuDeviceList) device_list = fu_device_list_new();
+	g_autoptr(GPtrArray) devices = g_ptr_array_new_with_free_func(g_object_unref);
+	g_autoptr(GTimer) timer = g_timer_new();
+	g_autoptr(GPtrArray) active = NULL;
+	g_autoptr(FuDevice) device_found = NULL;
+	g_autoptr(FuDevice) device_unlisted = fu_device_new(self->ctx);
+	g_autoptr(GError) error_found = NULL;
+	FuDevice *device_renamed;
+	guint rescan_cnt;
+	g_autofree gchar *id_old = NULL;
+
+	/* add lots of devices */
+	for (guint i = 0; i < n_devices; i++) {
+		g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+		g_autofree gchar *id = g_strdup_printf("device%04u", i);
+		g_autofree gchar *instance_id = g_strdup_printf("USB\\VID_273F&PID_%04X", i);
+		g_autofree gchar *physical_id = g_strdup_printf("usb:01:%02x:%02x", i / 256, i % 256);
+		fu_device_set_id(device, id);
+		fu_device_set_physical_id(device, physical_id);
+		fu_device_add_instance_id(device, instance_id);
+		fu_device_convert_instance_ids(device);
+		fu_device_list_add(device_list, device);
+		g_ptr_array_add(devices, g_steal_pointer(&device));
+	}
+	g_print("add=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* adding a device must not rescan every existing device */
+	g_assert_cmpint(fu_device_list_get_index_rescan_cnt(device_list), ==, 0);
+
+	/* lookup by ID */
+	g_timer_reset(timer);
+	for (guint i = 0; i < n_devices; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		g_autoptr(FuDevice) device_tmp = NULL;
+		g_autoptr(GError) error = NULL;
+		device_tmp = fu_device_list_get_by_id(device_list, fu_device_get_id(device), &error);
+		g_assert_no_error(error);
+		g_assert_true(device_tmp == device);
+	}
+	g_print("id=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* lookup by GUID */
+	g_timer_reset(timer);
+	for (guint i = 0; i < n_devices; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		g_autoptr(FuDevice) device_tmp = NULL;
+		g_autoptr(GError) error = NULL;
+		device_tmp =
+		    fu_device_list_get_by_guid(device_list, fu_device_get_guid_default(device), &error);
+		g_assert_no_error(error);
+		g_assert_true(device_tmp == device);
+	}
+	g_print("guid=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* changing a device that is not in the list does not invalidate the indexes */
+	fu_device_set_id(device_unlisted, "unlisted");
+	fu_device_set_physical_id(device_unlisted, "usb:ff:ff:ff");
+	fu_device_add_instance_id(device_unlisted, "USB\\VID_273F&PID_FFFE");
+	fu_device_convert_instance_ids(device_unlisted);
+	device_found =
+	    fu_device_list_get_by_id(device_list, fu_device_get_id(device_unlisted), &error_found);
+	g_assert_error(error_found, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(device_found);
+	g_clear_error(&error_found);
+	g_assert_cmpint(fu_device_list_get_index_rescan_cnt(device_list), ==, 0);
+
+	/* add a device with the same connection */
+	g_timer_reset(timer);
+	for (guint i = 0; i < n_devices; i += 10) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		g_autoptr(FuDevice) device_new = fu_device_new(self->ctx);
+		fu_device_set_id(device_new, fu_device_get_id(device));
+		fu_device_set_physical_id(device_new, fu_device_get_physical_id(device));
+		fu_device_add_instance_id(device_new, "USB\\VID_273F&PID_FFFF");
+		fu_device_convert_instance_ids(device_new);
+		fu_device_list_add(device_list, device_new);
+		g_ptr_array_index(devices, i) = g_steal_pointer(&device_new);
+		g_object_unref(device);
+	}
+	g_print("replace=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	active = fu_device_list_get_active(device_list);
+	g_assert_cmpint(active->len, ==, n_devices);
+
+	/* at most one rescan for each replaced device */
+	rescan_cnt = fu_device_list_get_index_rescan_cnt(device_list);
+	g_assert_cmpint(rescan_cnt, >, 0);
+	g_assert_cmpint(rescan_cnt, <=, n_devices / 10);
+
+	/* the index is updated when the device ID changes */
+	device_renamed = g_ptr_array_index(devices, 1);
+	id_old = g_strdup(fu_device_get_id(device_renamed));
+	fu_device_set_id(device_renamed, "renamed");
+	device_found =
+	    fu_device_list_get_by_id(device_list, fu_device_get_id(device_renamed), &error_found);
+	g_assert_no_error(error_found);
+	g_assert_true(device_found == device_renamed);
+	g_clear_object(&device_found);
+	rescan_cnt = fu_device_list_get_index_rescan_cnt(device_list);
+
+	/* the old ID is no longer found, and nothing else has changed */
+	device_found = fu_device_list_get_by_id(device_list, id_old, &error_found);
+	g_assert_error(error_found, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(device_found);
+	g_assert_cmpint(fu_device_list_get_index_rescan_cnt(device_list), ==, rescan_cnt);
+}
+
 static void
 fu_device_list_func(gconstpointer user_data)
 {
@@ -3415,6 +3912,159 @@ fu_backend_usb_func(gconstpointer user_data)
 #endif
 }
 
+#ifdef HAVE_GUSB
+static gchar *
+fu_engine_coldplug_parallel_run(FuTest *self, JsonObject *json_obj, guint coldplug_threads)
+{
+	gboolean ret;
+	guint guid_hits;
+	guint guid_misses;
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FuBackend) backend = fu_usb_backend_new(self->ctx);
+	g_autoptr(FuPlugin) plugin = fu_plugin_new_from_gtype(fu_test_plugin_get_type(), self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) devices_added = NULL;
+	g_autoptr(GString) str = g_string_new(NULL);
+	g_autoptr(GTimer) timer = NULL;
+	g_autoptr(XbSilo) silo_empty = xb_silo_new();
+
+	/* no metadata in daemon */
+	fu_engine_set_silo(engine, silo_empty);
+	fu_engine_set_coldplug_threads(engine, coldplug_threads);
+	fu_engine_add_plugin(engine, plugin);
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_NO_CACHE, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_progress_reset(progress);
+	ret = fu_backend_setup(backend, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_backend_load(backend, json_obj, NULL, FU_BACKEND_LOAD_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the test plugin adds, registers and removes devices from the worker threads */
+	devices = fu_backend_get_devices(backend);
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		fu_device_add_possible_plugin(device, "test");
+	}
+
+	/* probe all the devices */
+	guid_hits = fu_common_guid_get_cache_hits();
+	guid_misses = fu_common_guid_get_cache_misses();
+	timer = g_timer_new();
+	ret = fu_engine_coldplug_backend(engine, backend, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_print("threads=%u:%.3fms ", coldplug_threads, g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* the emulated devices share instance IDs, so most should not need hashing */
+	g_print("guid-cache=%u/%u ",
+		fu_common_guid_get_cache_hits() - guid_hits,
+		(fu_common_guid_get_cache_hits() - guid_hits) +
+		    (fu_common_guid_get_cache_misses() - guid_misses));
+
+	/* the probed devices have to be identical regardless of the thread count */
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		GPtrArray *instance_ids = fu_device_get_instance_ids(device);
+		g_string_append_printf(str,
+				       "%s:%s",
+				       fu_device_get_backend_id(device),
+				       fu_device_get_name(device));
+		for (guint j = 0; j < instance_ids->len; j++)
+			g_string_append_printf(str, ",%s", (gchar *)g_ptr_array_index(instance_ids, j));
+		g_string_append(str, "\n");
+	}
+
+	/* ...as do the devices added by the plugin, in the same order */
+	devices_added = fu_engine_get_devices(engine, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices_added);
+	for (guint i = 0; i < devices_added->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices_added, i);
+		g_assert_true(fu_device_has_flag(device, FWUPD_DEVICE_FLAG_REGISTERED));
+		g_assert_cmpstr(fu_device_get_metadata(device, "BestDevice"), ==, "/dev/urandom");
+		g_assert_false(g_str_has_suffix(fu_device_get_backend_id(device), ":04"));
+		g_string_append_printf(str,
+				       "%s:%s\n",
+				       fu_device_get_id(device),
+				       fu_device_get_backend_id(device));
+	}
+	return g_string_free(g_steal_pointer(&str), FALSE);
+}
+#endif
+
+static void
+fu_engine_coldplug_parallel_func(gconstpointer user_data)
+{
+#ifdef HAVE_GUSB
+	FuTest *self = (FuTest *)user_data;
+	JsonArray *json_devices;
+	JsonObject *json_device;
+	gboolean ret;
+	g_autofree gchar *fn = NULL;
+	g_autofree gchar *str_serial = NULL;
+	g_autofree gchar *str_parallel = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+#if !G_USB_CHECK_VERSION(0, 4, 5)
+	g_test_skip("GUsb version too old");
+	return;
+#endif
+
+	/* clone the emulated device onto lots of hubs, and the ports of each hub */
+	fn = g_test_build_filename(G_TEST_DIST, "tests", "usb-devices.json", NULL);
+	ret = json_parser_load_from_file(parser, fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	json_devices =
+	    json_object_get_array_member(json_node_get_object(json_parser_get_root(parser)),
+					 "UsbDevices");
+	json_device = json_array_get_object_element(json_devices, 0);
+	for (guint i = 0; i < 16; i++) {
+		for (guint j = 0; j <= 4; j++) {
+			g_autofree gchar *platform_id =
+			    j == 0 ? g_strdup_printf("usb:%02x:00", i)
+				   : g_strdup_printf("usb:%02x:00:%02x", i, j);
+			JsonNode *json_node = json_node_new(JSON_NODE_OBJECT);
+			JsonObject *json_obj = json_object_new();
+			GList *members = json_object_get_members(json_device);
+			for (GList *l = members; l != NULL; l = l->next) {
+				const gchar *member = l->data;
+				if (g_strcmp0(member, "PlatformId") == 0)
+					continue;
+				json_object_set_member(
+				    json_obj,
+				    member,
+				    json_node_copy(json_object_get_member(json_device, member)));
+			}
+			g_list_free(members);
+			json_object_set_string_member(json_obj, "PlatformId", platform_id);
+			json_node_take_object(json_node, json_obj);
+			json_array_add_element(json_devices, json_node);
+		}
+	}
+	json_array_remove_element(json_devices, 0);
+
+	/* compare serial and parallel coldplug */
+	str_serial = fu_engine_coldplug_parallel_run(self,
+						     json_node_get_object(json_parser_get_root(parser)),
+						     1);
+	str_parallel =
+	    fu_engine_coldplug_parallel_run(self,
+					    json_node_get_object(json_parser_get_root(parser)),
+					    4);
+	g_assert_cmpstr(str_serial, ==, str_parallel);
+#else
+	g_test_skip("No GUsb support");
+#endif
+}
+
 static void
 fu_backend_usb_invalid_func(gconstpointer user_data)
 {
@@ -3767,6 +4417,236 @@ fu_history_func(gconstpointer user_data)
 	g_assert_cmpstr(g_ptr_array_index(approved_firmware, 1), ==, "bar");
 }
 
+static void
+fu_history_performance_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	g_autofree gchar *dirname = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+	g_autoptr(FuHistory) history = fu_history_new();
+	g_autoptr(FwupdRelease) release = fwupd_release_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+#ifndef HAVE_SQLITE
+	g_test_skip("no sqlite support");
+	return;
+#endif
+
+	/* delete the database */
+	dirname = fu_path_from_kind(FU_PATH_KIND_LOCALSTATEDIR_PKG);
+	if (!g_file_test(dirname, G_FILE_TEST_IS_DIR))
+		return;
+	filename = g_build_filename(dirname, "pending.db", NULL);
+	(void)g_unlink(filename);
+
+	/* add lots of synthetic history in one transaction */
+	fu_device_set_name(device, "ColorHug");
+	fu_device_set_version_format(device, FWUPD_VERSION_FORMAT_TRIPLET);
+	fu_device_set_version(device, "3.0.1");
+	fu_device_set_update_state(device, FWUPD_UPDATE_STATE_SUCCESS);
+	fwupd_release_add_checksum(release, "abcdef");
+	fwupd_release_set_version(release, "3.0.2");
+	ret = fu_history_transaction_begin(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	for (guint i = 0; i < 100000; i++) {
+		g_autofree gchar *id = g_strdup_printf("%08x", i);
+		fu_device_set_id(device, id);
+		ret = fu_history_add_device(history, device, release, &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+	ret = fu_history_transaction_commit(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_print("add=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* get devices by ID, which should use the index */
+	g_timer_reset(timer);
+	for (guint i = 0; i < 1000; i++) {
+		g_autofree gchar *id = g_strdup_printf("%08x", i * 100);
+		g_autofree gchar *device_id = g_compute_checksum_for_string(G_CHECKSUM_SHA1, id, -1);
+		g_autoptr(FuDevice) device_tmp = NULL;
+		device_tmp = fu_history_get_device_by_id(history, device_id, &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(device_tmp);
+	}
+	g_print("get-device-by-id=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* modify a device, which should use the index */
+	g_timer_reset(timer);
+	fu_device_set_update_state(device, FWUPD_UPDATE_STATE_FAILED);
+	ret = fu_history_modify_device(history, device, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_print("modify=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* do not leave a huge database for the other tests */
+	ret = fu_history_remove_all(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
+static void
+fu_history_security_attrs_func(gconstpointer user_data)
+{
+	FuSecurityAttrs *attrs_tmp;
+	FwupdSecurityAttr *attr_tmp;
+	gboolean ret;
+	g_autofree gchar *dirname = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(FuHistory) history = fu_history_new();
+	g_autoptr(FuSecurityAttrs) attrs = fu_security_attrs_new();
+	g_autoptr(FwupdSecurityAttr) attr1 = fwupd_security_attr_new("org.fwupd.hsi.foo");
+	g_autoptr(FwupdSecurityAttr) attr2 = fwupd_security_attr_new("org.fwupd.hsi.bar");
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) attrs_array = NULL;
+
+#ifndef HAVE_SQLITE
+	g_test_skip("no sqlite support");
+	return;
+#endif
+
+	/* delete the database */
+	dirname = fu_path_from_kind(FU_PATH_KIND_LOCALSTATEDIR_PKG);
+	if (!g_file_test(dirname, G_FILE_TEST_IS_DIR))
+		return;
+	filename = g_build_filename(dirname, "pending.db", NULL);
+	(void)g_unlink(filename);
+
+	/* add the same snapshot twice */
+	fwupd_security_attr_set_plugin(attr1, "test");
+	fwupd_security_attr_set_result(attr1, FWUPD_SECURITY_ATTR_RESULT_ENABLED);
+	fwupd_security_attr_set_created(attr1, 12345);
+	fu_security_attrs_append(attrs, attr1);
+	fwupd_security_attr_set_plugin(attr2, "test");
+	fwupd_security_attr_set_result(attr2, FWUPD_SECURITY_ATTR_RESULT_NOT_ENABLED);
+	fu_security_attrs_append(attrs, attr2);
+	ret = fu_history_add_security_attribute(history, attrs, "HSI:1", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_history_add_security_attribute(history, attrs, "HSI:1", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the attribute being saved is not modified */
+	g_assert_cmpint(fwupd_security_attr_get_created(attr1), ==, 12345);
+
+	/* only one attribute changes */
+	fwupd_security_attr_set_result(attr2, FWUPD_SECURITY_ATTR_RESULT_ENABLED);
+	ret = fu_history_add_security_attribute(history, attrs, "HSI:2", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* unchanged snapshots are deduplicated, newest first */
+	attrs_array = fu_history_get_security_attrs(history, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_array);
+	g_assert_cmpint(attrs_array->len, ==, 2);
+	attrs_tmp = g_ptr_array_index(attrs_array, 0);
+	attr_tmp = fu_security_attrs_get_by_appstream_id(attrs_tmp, "org.fwupd.hsi.bar");
+	g_assert_nonnull(attr_tmp);
+	g_assert_cmpint(fwupd_security_attr_get_result(attr_tmp),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_ENABLED);
+	attrs_tmp = g_ptr_array_index(attrs_array, 1);
+	attr_tmp = fu_security_attrs_get_by_appstream_id(attrs_tmp, "org.fwupd.hsi.bar");
+	g_assert_nonnull(attr_tmp);
+	g_assert_cmpint(fwupd_security_attr_get_result(attr_tmp),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_NOT_ENABLED);
+	attr_tmp = fu_security_attrs_get_by_appstream_id(attrs_tmp, "org.fwupd.hsi.foo");
+	g_assert_nonnull(attr_tmp);
+	g_assert_cmpstr(fwupd_security_attr_get_plugin(attr_tmp), ==, "test");
+}
+
+static void
+fu_history_security_attrs_legacy_func(gconstpointer user_data)
+{
+#ifdef HAVE_SQLITE
+	FuSecurityAttrs *attrs_tmp;
+	FwupdSecurityAttr *attr_tmp;
+	gboolean ret;
+	gint rc;
+	sqlite3 *db = NULL;
+	sqlite3_stmt *stmt = NULL;
+	g_autofree gchar *dirname = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autofree gchar *json = NULL;
+	g_autoptr(FuHistory) history = fu_history_new();
+	g_autoptr(FuSecurityAttrs) attrs = fu_security_attrs_new();
+	g_autoptr(FwupdSecurityAttr) attr = fwupd_security_attr_new("org.fwupd.hsi.foo");
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) attrs_array = NULL;
+
+	/* delete the database */
+	dirname = fu_path_from_kind(FU_PATH_KIND_LOCALSTATEDIR_PKG);
+	if (!g_file_test(dirname, G_FILE_TEST_IS_DIR))
+		return;
+	filename = g_build_filename(dirname, "pending.db", NULL);
+	(void)g_unlink(filename);
+
+	/* create an empty database with the current schema */
+	attrs_array = fu_history_get_security_attrs(history, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_array);
+	g_assert_cmpint(attrs_array->len, ==, 0);
+	g_clear_pointer(&attrs_array, g_ptr_array_unref);
+
+	/* add a snapshot with the inline JSON written by older versions */
+	fwupd_security_attr_set_plugin(attr, "test");
+	fwupd_security_attr_set_result(attr, FWUPD_SECURITY_ATTR_RESULT_ENABLED);
+	fu_security_attrs_append(attrs, attr);
+	json = fu_security_attrs_to_json_string(attrs, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(json);
+	rc = sqlite3_open(filename, &db);
+	g_assert_cmpint(rc, ==, SQLITE_OK);
+	rc = sqlite3_prepare_v2(db,
+				"INSERT INTO hsi_history (timestamp, hsi_details, hsi_score) "
+				"VALUES ('2022-01-01 12:00:00', ?1, 'HSI:1');",
+				-1,
+				&stmt,
+				NULL);
+	g_assert_cmpint(rc, ==, SQLITE_OK);
+	sqlite3_bind_text(stmt, 1, json, -1, SQLITE_STATIC);
+	g_assert_cmpint(sqlite3_step(stmt), ==, SQLITE_DONE);
+	sqlite3_finalize(stmt);
+	sqlite3_close(db);
+
+	/* add a newer snapshot in the current format */
+	fwupd_security_attr_set_result(attr, FWUPD_SECURITY_ATTR_RESULT_NOT_ENABLED);
+	ret = fu_history_add_security_attribute(history, attrs, "HSI:0", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* both formats are read, newest first */
+	attrs_array = fu_history_get_security_attrs(history, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_array);
+	g_assert_cmpint(attrs_array->len, ==, 2);
+	attrs_tmp = g_ptr_array_index(attrs_array, 0);
+	attr_tmp = fu_security_attrs_get_by_appstream_id(attrs_tmp, "org.fwupd.hsi.foo");
+	g_assert_nonnull(attr_tmp);
+	g_assert_cmpint(fwupd_security_attr_get_result(attr_tmp),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_NOT_ENABLED);
+	attrs_tmp = g_ptr_array_index(attrs_array, 1);
+	attr_tmp = fu_security_attrs_get_by_appstream_id(attrs_tmp, "org.fwupd.hsi.foo");
+	g_assert_nonnull(attr_tmp);
+	g_assert_cmpint(fwupd_security_attr_get_result(attr_tmp),
+			==,
+			FWUPD_SECURITY_ATTR_RESULT_ENABLED);
+	g_assert_cmpstr(fwupd_security_attr_get_plugin(attr_tmp), ==, "test");
+	g_assert_cmpint(fwupd_security_attr_get_created(attr_tmp), ==, 1641038400);
+#else
+	g_test_skip("no sqlite support");
+#endif
+}
+
 static GBytes *
 _build_cab(GCabCompression compression, ...)
 {
@@ -4991,18 +5871,27 @@ main(int argc, char **argv)
 	}
 	g_test_add_data_func("/fwupd/backend{usb}", self, fu_backend_usb_func);
 	g_test_add_data_func("/fwupd/backend{usb-invalid}", self, fu_backend_usb_invalid_func);
+	g_test_add_data_func("/fwupd/engine{coldplug-parallel}",
+			     self,
+			     fu_engine_coldplug_parallel_func);
 	g_test_add_data_func("/fwupd/plugin{module}", self, fu_plugin_module_func);
 	g_test_add_data_func("/fwupd/memcpy", self, fu_memcpy_func);
 	g_test_add_data_func("/fwupd/security-attr", self, fu_security_attr_func);
 	g_test_add_data_func("/fwupd/security-attrs", self, fu_security_attrs_func);
 	g_test_add_data_func("/fwupd/device-list", self, fu_device_list_func);
 	g_test_add_data_func("/fwupd/device-list{delay}", self, fu_device_list_delay_func);
+	g_test_add_data_func("/fwupd/device-changed-queue", self, fu_device_changed_queue_func);
 	g_test_add_data_func("/fwupd/device-list{no-auto-remove-children}",
 			     self,
 			     fu_device_list_no_auto_remove_children_func);
 	g_test_add_data_func("/fwupd/device-list{compatible}",
 			     self,
 			     fu_device_list_compatible_func);
+	if (g_test_slow()) {
+		g_test_add_data_func("/fwupd/device-list{performance}",
+				     self,
+				     fu_device_list_performance_func);
+	}
 	g_test_add_data_func("/fwupd/device-list{remove-chain}",
 			     self,
 			     fu_device_list_remove_chain_func);
@@ -5098,6 +5987,15 @@ main(int argc, char **argv)
 			     self,
 			     fu_engine_install_duration_func);
 	g_test_add_data_func("/fwupd/engine{generate-md}", self, fu_engine_generate_md_func);
+	g_test_add_data_func("/fwupd/engine{metadata-cache}", self, fu_engine_metadata_cache_func);
+	g_test_add_data_func("/fwupd/engine{metadata-timestamp}",
+			     self,
+			     fu_engine_metadata_timestamp_func);
+	if (g_test_slow()) {
+		g_test_add_data_func("/fwupd/engine{get-upgrades-performance}",
+				     self,
+				     fu_engine_get_upgrades_performance_func);
+	}
 	g_test_add_data_func("/fwupd/engine{requirements-other-device}",
 			     self,
 			     fu_engine_requirements_other_device_func);
@@ -5107,6 +6005,15 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/plugin{composite}", self, fu_plugin_composite_func);
 	g_test_add_data_func("/fwupd/history", self, fu_history_func);
 	g_test_add_data_func("/fwupd/history{migrate}", self, fu_history_migrate_func);
+	if (g_test_slow()) {
+		g_test_add_data_func("/fwupd/history{performance}",
+				     self,
+				     fu_history_performance_func);
+	}
+	g_test_add_data_func("/fwupd/history{security-attrs}", self, fu_history_security_attrs_func);
+	g_test_add_data_func("/fwupd/history{security-attrs-legacy}",
+			     self,
+			     fu_history_security_attrs_legacy_func);
 	g_test_add_data_func("/fwupd/plugin-list", self, fu_plugin_list_func);
 	g_test_add_data_func("/fwupd/plugin-list{depsolve}", self, fu_plugin_list_depsolve_func);
 	g_test_add_func("/fwupd/spawn", fu_spawn_func);
@@ -333,6 +333,7 @@ fu_util_private_free(FuUtilPrivate *priv)
 	if (priv->lock_fd != 0)
 		g_close(priv->lock_fd, NULL);
 	g_ptr_array_unref(priv->post_requests);
+	fu_common_guid_clear_cache();
 	g_free(priv);
 }
 
@@ -705,6 +706,7 @@ fu_util_get_details(FuUtilPrivate *priv, gchar **values, GError **error)
 	g_autoptr(GPtrArray) array = NULL;
 	g_autoptr(GNode) root = g_node_new(NULL);
 	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob_cab = NULL;
 
 	/* load engine */
 	if (!fu_util_start_engine(priv,
@@ -732,7 +734,8 @@ fu_util_get_details(FuUtilPrivate *priv, gchar **values, GError **error)
 		fu_util_maybe_prefix_sandbox_error(values[0], error);
 		return FALSE;
 	}
-	array = fu_engine_get_details_for_bytes(priv->engine, priv->request, blob, error);
+	blob_cab = fu_bytes_new_with_checksums(blob);
+	array = fu_engine_get_details_for_bytes(priv->engine, priv->request, blob_cab, error);
 	if (array == NULL)
 		return FALSE;
 	for (guint i = 0; i < array->len; i++) {
@@ -1228,6 +1231,7 @@ fu_util_install(FuUtilPrivate *priv, gchar **values, GError **error)
 {
 	g_autofree gchar *filename = NULL;
 	g_autoptr(GBytes) blob_cab = NULL;
+	g_autoptr(GBytes) blob_raw = NULL;
 	g_autoptr(GPtrArray) components = NULL;
 	g_autoptr(GPtrArray) devices_possible = NULL;
 	g_autoptr(GPtrArray) errors = NULL;
@@ -1284,11 +1288,12 @@ fu_util_install(FuUtilPrivate *priv, gchar **values, GError **error)
 		return FALSE;
 
 	/* parse silo */
-	blob_cab = fu_bytes_get_contents(filename, error);
-	if (blob_cab == NULL) {
+	blob_raw = fu_bytes_get_contents(filename, error);
+	if (blob_raw == NULL) {
 		fu_util_maybe_prefix_sandbox_error(filename, error);
 		return FALSE;
 	}
+	blob_cab = fu_bytes_new_with_checksums(blob_raw);
 	silo = fu_engine_get_silo_from_blob(priv->engine, blob_cab, error);
 	if (silo == NULL)
 		return FALSE;
@@ -4044,7 +4049,9 @@ main(int argc, char *argv[])
 				 error->message);
 		return EXIT_FAILURE;
 	}
-	fu_progress_set_profile(priv->progress, g_getenv("FWUPD_VERBOSE") != NULL);
+	fu_progress_set_profile(priv->progress,
+				g_getenv("FWUPD_VERBOSE") != NULL ||
+				    g_getenv("FWUPD_PROFILE_TRACE") != NULL);
 
 	/* allow disabling SSL strict mode for broken corporate proxies */
 	if (priv->disable_ssl_strict) {
@@ -4154,9 +4161,26 @@ main(int argc, char *argv[])
 
 	/* a good place to do the traceback */
 	if (fu_progress_get_profile(priv->progress)) {
+		const gchar *trace_fn = g_getenv("FWUPD_PROFILE_TRACE");
+		guint guid_hits = fu_common_guid_get_cache_hits();
+		guint guid_misses = fu_common_guid_get_cache_misses();
 		g_autofree gchar *str = fu_progress_traceback(priv->progress);
 		if (str != NULL)
 			fu_console_print_literal(priv->console, str);
+		if (guid_hits + guid_misses > 0) {
+			fu_console_print(priv->console,
+					 "GUID cache: %u hits, %u misses, hit rate %.1f%%",
+					 guid_hits,
+					 guid_misses,
+					 100.f * guid_hits / (guid_hits + guid_misses));
+		}
+		if (trace_fn != NULL) {
+			g_autofree gchar *trace = fu_progress_to_trace(priv->progress);
+			if (!g_file_set_contents(trace_fn, trace, -1, &error)) {
+				fu_util_print_error(priv, error);
+				return EXIT_FAILURE;
+			}
+		}
 	}
 
 	/* success */